@@ -9,14 +9,22 @@
 #include <stddef.h>  // For size_t
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "dictionary.h"
+#include "utils.h"  // For MAX_ARRAY_SIZE
 
-// Maximum number of items in a transaction
-#define MAX_ITEMS_PER_TRANSACTION 20
+// Initial item capacity of a transaction; it grows as items are added
+#define INITIAL_TRANSACTION_ITEMS 4
 
-// Item structure for billing
+// Maximum number of monthly transaction partitions (at most one per transaction)
+#define MAX_TRANSACTION_PARTITIONS MAX_ARRAY_SIZE
+
+// Suffix under which a partition file that could not be fully read is kept when it is rewritten
+#define DAMAGED_PARTITION_SUFFIX ".bad"
+
+// Item structure for billing (the product name is looked up by ID)
 typedef struct {
     int productId;       // ID of the product
-    char name[50];       // Name of the product
     double price;        // Price of the product
     int quantity;        // Quantity purchased
     double subtotal;     // Subtotal for this item (price * quantity)
@@ -27,21 +35,45 @@ typedef struct {
     char transactionId[20];   // Unique transaction ID
     char date[20];            // Date and time of the transaction
     char customerId[20];      // Customer ID (if applicable)
-    BillingItem items[MAX_ITEMS_PER_TRANSACTION];  // Items in the transaction
+    BillingItem *items;       // Items in the transaction (heap-allocated, owned by the transaction)
     int itemCount;            // Number of items in the transaction
+    int itemCapacity;         // Number of items allocated
     double total;             // Total amount
-    char paymentMethod[20];   // Payment method
-    char status[20];          // Transaction status (completed, pending, etc.)
+    uint32_t paymentMethodId; // Payment method (dictionary ID)
+    uint32_t statusId;        // Transaction status (dictionary ID, e.g. Completed)
 } Transaction;
 
-/**
- * Run the billing system module
- */
-void runBillingSystem();
+// Manifest entry describing one monthly transaction partition file
+typedef struct {
+    char month[8];            // Partition month (YYYY-MM), or 0000-00 for unparseable dates
+    char minDate[20];         // Earliest transaction date in the partition
+    char maxDate[20];         // Latest transaction date in the partition
+    int32_t count;            // Number of transactions
+    int32_t completedCount;   // Number of completed transactions
+    double completedTotal;    // Total of the completed transactions
+} TransactionPartitionInfo;
+
+// Completed sales of one payment method in a sales report
+typedef struct {
+    uint32_t paymentMethodId; // Payment method (dictionary ID)
+    int transactionCount;     // Number of completed transactions
+    double total;             // Total of those transactions
+    double percentage;        // Share of the total sales
+} PaymentMethodTotal;
+
+// Result of the sales report; the transactions themselves are read from the
+// store while the report is written rather than copied here
+typedef struct {
+    double totalSales;        // Total of the completed transactions
+    int transactionCount;     // Number of completed transactions
+    double averageSale;       // Average completed transaction total
+    int paymentMethodCount;
+    PaymentMethodTotal paymentMethods[MAX_DICTIONARY_SIZE];  // In order of first use
+} SalesReport;
 
 /**
  * Create a new transaction
- * @return true if successful, false otherwise
+ * @return true if successful, false if a transaction is already active
  */
 bool createTransaction();
 
@@ -53,6 +85,13 @@ bool createTransaction();
  */
 bool addItemToTransaction(int productId, int quantity);
 
+/**
+ * Get the name of the product a billing item refers to
+ * @param item The billing item
+ * @return The product name, or "Unknown Product" if it no longer exists
+ */
+const char *getBillingItemName(const BillingItem *item);
+
 /**
  * Remove an item from the current transaction
  * @param index The index of the item to remove
@@ -68,43 +107,53 @@ double calculateTransactionTotal();
 
 /**
  * Complete the current transaction
- * @param customerId The customer ID (optional)
+ * The transaction and the stock its items took are both saved before this returns.
+ * If the transaction cannot be saved it stays open; once it is recorded it is
+ * closed, even if its stock changes could not be saved
+ * @param customerId The customer ID, or a phone number that belongs to exactly one customer (optional)
  * @param paymentMethod The payment method
- * @return true if successful, false otherwise
+ * @return true if the transaction and its stock changes were saved, false otherwise
  */
 bool completeTransaction(const char *customerId, const char *paymentMethod);
 
 /**
- * Generate a receipt for a transaction
- * @param transaction The transaction to generate a receipt for
- * @param receipt Buffer to store the receipt
- * @param bufferSize Size of the receipt buffer
+ * Add a batch of finished transactions and save them once
+ * If the save fails, the store is reloaded from disk, so only the transactions
+ * that reached the files are kept
+ * @param newTransactions The transactions to add; the store takes ownership of their item arrays
+ * @param count Number of transactions
+ * @return true if successful, false if the transactions do not fit or could not be saved
  */
-void generateReceipt(const Transaction *transaction, char *receipt, size_t bufferSize);
+bool appendTransactions(Transaction *newTransactions, int count);
 
 /**
- * Display transaction history
- * @param startDate Start date for filtering (optional)
- * @param endDate End date for filtering (optional)
- * @param paymentMethod Payment method for filtering (optional)
+ * Get the buffer size that holds a transaction's whole receipt
+ * @param transaction The transaction
+ * @return Size in bytes, including the terminator
  */
-void displayTransactionHistory(const char *startDate, const char *endDate, const char *paymentMethod);
+size_t getReceiptSize(const Transaction *transaction);
 
 /**
- * Display transaction details
- * @param transactionId The ID of the transaction to display
- * @return true if found, false otherwise
+ * Generate a receipt for a transaction
+ * If the buffer is too small, the item list ends with a "... N more item(s)
+ * not shown" line so the total and footer are still printed.
+ * @param transaction The transaction to generate a receipt for
+ * @param receipt Buffer to store the receipt
+ * @param bufferSize Size of the receipt buffer (see getReceiptSize)
+ * @return true if the whole receipt fit, false if it was shortened
  */
-bool displayTransactionDetails(const char *transactionId);
+bool generateReceipt(const Transaction *transaction, char *receipt, size_t bufferSize);
 
 /**
- * Save transaction data to file
+ * Save transaction data to the monthly partition files and their manifest
+ * Only partitions changed since the last save are rewritten
  * @return true if successful, false otherwise
  */
 bool saveTransactionData();
 
 /**
- * Load transaction data from file
+ * Load transaction data from the partitions listed in the manifest
+ * A single-file store from an older version is imported into partitions
  * @return true if successful, false otherwise
  */
 bool loadTransactionData();
@@ -116,6 +165,27 @@ bool loadTransactionData();
  */
 int findTransactionById(const char *transactionId);
 
+/**
+ * Find the transactions dated within a range of days, using the date lookup
+ * Callers still apply their own exact date comparison to the results
+ * @param startDate First day (YYYY-MM-DD), or NULL/empty for no lower bound
+ * @param endDate Last day (YYYY-MM-DD), or NULL/empty for no upper bound
+ * @param slots Array to receive transaction indexes in date order
+ * @param maxSlots Maximum number of indexes to store
+ * @return Number of indexes stored
+ */
+int findTransactionsByDate(const char *startDate, const char *endDate, int *slots, int maxSlots);
+
+/**
+ * Find the transactions of a period in storage (partition) order
+ * @param startDate Start date for the period, or NULL/empty for no lower bound
+ * @param endDate End date for the period, or NULL/empty for no upper bound
+ * @param paymentMethod Only include transactions paid this way, or NULL/empty for all
+ * @param slots Array of at least transactionCount entries to receive transaction indexes
+ * @return Number of indexes stored
+ */
+int findTransactionHistory(const char *startDate, const char *endDate, const char *paymentMethod, int *slots);
+
 /**
  * Calculate total sales for a given period
  * @param startDate Start date for the period
@@ -125,10 +195,42 @@ int findTransactionById(const char *transactionId);
 double calculateTotalSales(const char *startDate, const char *endDate);
 
 /**
- * Generate a sales report for a given period
+ * Compute the sales report for a given period
+ * @param startDate Start date for the period
+ * @param endDate End date for the period
+ * @param report Receives the result
+ */
+void buildSalesReport(const char *startDate, const char *endDate, SalesReport *report);
+
+/**
+ * Export a sales report to a CSV file, followed by the completed transactions of the period
+ * @param filename The file to create, or "-" for standard output
+ * @param startDate Start date for the period
+ * @param endDate End date for the period
+ * @param report The result to export
+ * @return true if successful, false otherwise
+ */
+bool exportSalesReportCsv(const char *filename, const char *startDate, const char *endDate,
+                          const SalesReport *report);
+
+/**
+ * Write the sales report for a given period as JSON or NDJSON,
+ * streaming every completed transaction of the period after the totals
+ * @param path The file to create, or NULL or "-" for standard output
  * @param startDate Start date for the period
  * @param endDate End date for the period
+ * @param lineDelimited true for NDJSON, false for one JSON document
+ * @return true if successful, false otherwise
+ */
+bool writeSalesReportJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited);
+
+/**
+ * Export every transaction and every transaction item as two columnar files
+ * (see columnar.h), in store order; items carry their transaction ID
+ * @param transactionsPath File for the transactions table
+ * @param itemsPath File for the transaction items table
+ * @return true if successful, false otherwise
  */
-void generateSalesReport(const char *startDate, const char *endDate);
+bool exportTransactionsColumnar(const char *transactionsPath, const char *itemsPath);
 
 #endif /* BILLING_H */
\ No newline at end of file
@@ -0,0 +1,20 @@
+/**
+ * Command Line Header File
+ * Contains the non-interactive commands used by scripts and scheduled jobs,
+ * such as "bams report income --from 2024-01-01 --format csv"
+ */
+
+#ifndef CLI_H
+#define CLI_H
+
+/**
+ * Run the command named by the first argument without the welcome screen,
+ * the menus or any prompt, loading only the stores the command needs
+ * Each command may also be given with a leading "--" (as in --import).
+ * @param argc Number of arguments, including the program name
+ * @param argv The arguments; argv[1] is the command
+ * @return Exit status for the process: 0 on success, 1 on failure or bad usage
+ */
+int runCommandLine(int argc, char *argv[]);
+
+#endif /* CLI_H */
\ No newline at end of file
@@ -0,0 +1,169 @@
+/**
+ * Columnar Export Header File
+ * Contains the writer and reader for the typed, column-oriented binary files
+ * used to hand whole tables to analytics tools without any text parsing
+ *
+ * File layout (little-endian):
+ *   ColumnarFileHeader (24 bytes), then columnCount ColumnarColumn entries
+ *   (72 bytes each), then the column values, each starting on an 8-byte
+ *   boundary. Fixed-width columns are rowCount packed values. String columns
+ *   are rowCount + 1 int32 offsets into a block of UTF-8 bytes, as in Apache
+ *   Arrow: row i is bytes offsets[i] up to offsets[i + 1] of the block, with
+ *   offsets[0] == 0 and offsets[rowCount] == dataLength. Strings are not
+ *   terminated. A reader can map any single column (numpy.memmap, Arrow
+ *   buffers) and skip the rest; openColumnarFile checks all of the above.
+ *
+ * A file is written under a temporary name and renamed into place when it is
+ * complete, so a reader never sees a partly written file.
+ */
+
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "storage.h"
+
+// Magic bytes at the start of every columnar file
+#define COLUMNAR_MAGIC "BAMSCOL1"
+
+// Version of the columnar file layout
+#define COLUMNAR_VERSION 1
+
+// Maximum number of columns in one file
+#define COLUMNAR_MAX_COLUMNS 16
+
+// Longest column name, including the terminator
+#define COLUMNAR_NAME_LENGTH 32
+
+// Type of the values in a column
+typedef enum {
+    COLUMN_INT32 = 1,     // int32_t per row
+    COLUMN_FLOAT64 = 2,   // double per row
+    COLUMN_STRING = 3     // int32_t offsets followed by UTF-8 bytes
+} ColumnType;
+
+// Header at the start of a columnar file
+typedef struct {
+    char magic[8];            // COLUMNAR_MAGIC, without a terminator
+    uint32_t version;         // COLUMNAR_VERSION
+    uint32_t columnCount;     // Number of column entries that follow
+    uint64_t rowCount;        // Number of rows in every column
+} ColumnarFileHeader;
+
+// Directory entry describing where one column's values are
+typedef struct {
+    char name[COLUMNAR_NAME_LENGTH];   // Column name
+    uint32_t type;                     // ColumnType
+    uint32_t reserved;                 // Keeps the offsets 8-byte aligned
+    uint64_t offset;                   // Offset of the values (or string offsets) from the start of the file
+    uint64_t length;                   // Number of bytes of values (or string offsets)
+    uint64_t dataOffset;               // String columns: offset of the UTF-8 bytes, otherwise 0
+    uint64_t dataLength;               // String columns: number of UTF-8 bytes, otherwise 0
+} ColumnarColumn;
+
+// Columnar file being written, one column at a time
+typedef struct {
+    FILE *file;                                    // The output file, under its temporary name
+    char path[260];                                // Where the file goes once it is complete
+    char temporaryPath[280];                       // Where it is written until then
+    ColumnarFileHeader header;                     // Header, written when the file is closed
+    ColumnarColumn columns[COLUMNAR_MAX_COLUMNS];  // Directory, written when the file is closed
+    int expectedColumns;                           // Number of columns promised when the file was opened
+    uint64_t position;                             // Bytes written so far
+    bool failed;                                   // Whether any write has failed
+} ColumnarWriter;
+
+// Columnar file mapped read-only by openColumnarFile
+typedef struct {
+    const ColumnarFileHeader *header;   // Header at the start of the mapping
+    const ColumnarColumn *columns;      // Directory of header->columnCount entries
+    MappedDataFile mapping;             // The whole file
+} ColumnarFile;
+
+/**
+ * Create a columnar file, leaving room for its header and directory
+ * @param writer The writer to initialize
+ * @param path The file to create (replaced when the writer is closed, if it exists)
+ * @param columnCount Number of columns that will be written
+ * @param rowCount Number of rows in every column
+ * @return true if the file was created, false otherwise
+ */
+bool openColumnarWriter(ColumnarWriter *writer, const char *path, int columnCount, uint64_t rowCount);
+
+/**
+ * Write the header and directory, close the file and move it into place
+ * @param writer The writer to close
+ * @return true if every column was written, false otherwise (the file is then discarded)
+ */
+bool closeColumnarWriter(ColumnarWriter *writer);
+
+/**
+ * Write the next column as 32-bit integers
+ * @param writer The writer
+ * @param name The column name
+ * @param values One value per row
+ */
+void writeColumnInt32(ColumnarWriter *writer, const char *name, const int32_t *values);
+
+/**
+ * Write the next column as 64-bit floating point numbers
+ * @param writer The writer
+ * @param name The column name
+ * @param values One value per row
+ */
+void writeColumnFloat64(ColumnarWriter *writer, const char *name, const double *values);
+
+/**
+ * Write the next column as strings
+ * @param writer The writer
+ * @param name The column name
+ * @param values One string per row
+ */
+void writeColumnStrings(ColumnarWriter *writer, const char *name, const char *const *values);
+
+/**
+ * Map a columnar file read-only and check its header, directory and string offsets
+ * @param path The file to read
+ * @param file Receives the mapping; release it with closeColumnarFile
+ * @return true if the file is a complete columnar file, false otherwise
+ */
+bool openColumnarFile(const char *path, ColumnarFile *file);
+
+/**
+ * Release a file mapped by openColumnarFile
+ * @param file The file to release
+ */
+void closeColumnarFile(ColumnarFile *file);
+
+/**
+ * Find a column by name and type
+ * @param file The file
+ * @param name The column name
+ * @param type The type the caller expects
+ * @return The column's directory entry, or NULL if there is no such column
+ */
+const ColumnarColumn *findColumnarColumn(const ColumnarFile *file, const char *name, ColumnType type);
+
+/**
+ * Get the values of a fixed-width column (int32_t or double per row)
+ * @param file The file
+ * @param column A column of the file
+ * @return The first value, valid until the file is closed
+ */
+const void *getColumnarValues(const ColumnarFile *file, const ColumnarColumn *column);
+
+/**
+ * Get one row of a string column
+ * @param file The file
+ * @param column A string column of the file
+ * @param row The row, below header->rowCount
+ * @param length Receives the number of bytes (the string is not terminated)
+ * @return The first byte, valid until the file is closed
+ */
+const char *getColumnarString(const ColumnarFile *file, const ColumnarColumn *column,
+                              uint64_t row, size_t *length);
+
+#endif /* COLUMNAR_H */
\ No newline at end of file
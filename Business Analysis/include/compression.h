@@ -0,0 +1,43 @@
+/**
+ * Compression Header File
+ * Contains a small LZ77 block codec in the style of LZ4, used for data files
+ * that are written once and read many times (sealed transaction partitions
+ * and the financial file)
+ */
+
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Get the largest size compressBlock can produce for an input
+ * @param sourceSize Number of input bytes
+ * @return Worst-case compressed size
+ */
+size_t getCompressBound(size_t sourceSize);
+
+/**
+ * Compress a block of bytes
+ * @param source The bytes to compress
+ * @param sourceSize Number of bytes to compress
+ * @param destination Buffer to receive the compressed bytes
+ * @param capacity Size of the destination buffer
+ * @return Number of compressed bytes, or 0 if they do not fit in the destination
+ */
+size_t compressBlock(const unsigned char *source, size_t sourceSize,
+                     unsigned char *destination, size_t capacity);
+
+/**
+ * Decompress a block produced by compressBlock
+ * @param source The compressed bytes
+ * @param sourceSize Number of compressed bytes
+ * @param destination Buffer to receive the original bytes
+ * @param destinationSize Exact size of the original bytes
+ * @return true if the block decoded to exactly destinationSize bytes, false if it is corrupt
+ */
+bool decompressBlock(const unsigned char *source, size_t sourceSize,
+                     unsigned char *destination, size_t destinationSize);
+
+#endif /* COMPRESSION_H */
\ No newline at end of file
@@ -0,0 +1,128 @@
+/**
+ * CSV Writer Header File
+ * Contains the buffered writer used by every CSV export, with correct field
+ * quoting and a fixed-point number formatter that does not go through printf
+ */
+
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size of the output buffer; rows are gathered here and written in large blocks
+#define CSV_WRITER_BUFFER_SIZE (256 * 1024)
+
+// Longest text produced by formatFixed, including the terminator
+#define FIXED_NUMBER_LENGTH 32
+
+// Buffered CSV output file
+typedef struct {
+    FILE *file;          // The output file, or stdout
+    bool ownsFile;       // Whether the file is closed with the writer
+    char *buffer;        // Bytes not yet written to the file
+    size_t length;       // Number of bytes in the buffer
+    bool rowStarted;     // Whether the current row already has a field
+    bool failed;         // Whether any write has failed
+} CsvWriter;
+
+/**
+ * Format a number with a fixed number of decimals, like printf("%.*f")
+ * @param value The number to format
+ * @param decimals Number of digits after the decimal point (0-9)
+ * @param buffer Receives the text; must hold FIXED_NUMBER_LENGTH bytes
+ * @return Length of the text
+ */
+size_t formatFixed(double value, int decimals, char *buffer);
+
+/**
+ * Create a CSV file and its output buffer
+ * @param writer The writer to initialize
+ * @param path The file to create (overwritten if it exists), or "-" for standard output
+ * @return true if the file was created, false otherwise
+ */
+bool openCsvWriter(CsvWriter *writer, const char *path);
+
+/**
+ * Open a CSV file for adding rows to its end, creating it if needed
+ * @param writer The writer to initialize
+ * @param path The file to append to
+ * @param isNew Receives true if the file was empty, so it still needs a header line
+ * @return true if the file was opened, false otherwise
+ */
+bool openCsvWriterForAppend(CsvWriter *writer, const char *path, bool *isNew);
+
+/**
+ * Write out the buffer and close the file
+ * @param writer The writer to close
+ * @return true if everything was written, false if any write failed
+ */
+bool closeCsvWriter(CsvWriter *writer);
+
+/**
+ * Write text exactly as given, such as a header line or a section title
+ * @param writer The writer
+ * @param text The text, including any line breaks
+ */
+void writeCsvRaw(CsvWriter *writer, const char *text);
+
+/**
+ * Write a text field, quoting it if it contains a comma, quote or line break
+ * @param writer The writer
+ * @param text The field value
+ */
+void writeCsvText(CsvWriter *writer, const char *text);
+
+/**
+ * Write a whole number field
+ * @param writer The writer
+ * @param value The field value
+ */
+void writeCsvInt(CsvWriter *writer, long long value);
+
+/**
+ * Write a number field with a fixed number of decimals
+ * @param writer The writer
+ * @param value The field value
+ * @param decimals Number of digits after the decimal point (0-9)
+ */
+void writeCsvDecimal(CsvWriter *writer, double value, int decimals);
+
+/**
+ * Write a money field as a bare number with two decimals, such as 1234.56
+ * @param writer The writer
+ * @param amount The amount
+ */
+void writeCsvMoney(CsvWriter *writer, double amount);
+
+/**
+ * Write a percentage field as a bare number of percent with two decimals, such as 12.34
+ * @param writer The writer
+ * @param percentage The percentage
+ */
+void writeCsvPercent(CsvWriter *writer, double percentage);
+
+/**
+ * End the current row
+ * @param writer The writer
+ */
+void endCsvRow(CsvWriter *writer);
+
+/**
+ * Write a two-field summary row of a label and a money amount
+ * @param writer The writer
+ * @param label The label
+ * @param amount The amount
+ */
+void writeCsvMoneyRow(CsvWriter *writer, const char *label, double amount);
+
+/**
+ * Write a two-field summary row of a label and a percentage
+ * @param writer The writer
+ * @param label The label
+ * @param percentage The percentage
+ */
+void writeCsvPercentRow(CsvWriter *writer, const char *label, double percentage);
+
+#endif /* CSV_WRITER_H */
\ No newline at end of file
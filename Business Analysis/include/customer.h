@@ -19,59 +19,42 @@ typedef struct {
 } Customer;
 
 /**
- * Run the customer management module
- */
-void runCustomerManagement();
-
-/**
- * Add a new customer
+ * Add a batch of new customers and save them once
+ * @param newCustomers The customers to add; their IDs must not already exist
+ * @param count Number of customers
  * @return true if successful, false otherwise
  */
-bool addCustomer();
-
-/**
- * Search for customers
- * Provides multiple search options (by ID, by name, etc.)
- */
-void searchCustomers();
-
-/**
- * Search for a customer by ID
- * @param id The ID to search for
- * @return true if found, false otherwise
- */
-bool searchCustomerById(int id);
-
-/**
- * Search for customers by name
- * @param name The name (or part of name) to search for
- */
-void searchCustomersByName(const char *name);
+bool appendCustomers(const Customer *newCustomers, int count);
 
 /**
- * Display all customers
+ * Insert a new customer in ID order and save
+ * @param customer The customer to add; its ID must not be taken
+ * @return true if successful, false otherwise
  */
-void displayAllCustomers();
+bool insertCustomer(const Customer *customer);
 
 /**
- * Display details for a specific customer
- * @param customer Pointer to the customer to display
+ * Replace a customer's details and save
+ * @param id The ID of the customer to update
+ * @param customer The new details (the ID is not changed)
+ * @return true if successful, false if the customer is missing or the save failed
  */
-void displayCustomerDetails(const Customer *customer);
+bool updateCustomer(int id, const Customer *customer);
 
 /**
- * Edit a customer's information
- * @param id The ID of the customer to edit
+ * Remove a customer and save
+ * @param id The ID of the customer to remove
  * @return true if successful, false otherwise
  */
-bool editCustomer(int id);
+bool removeCustomer(int id);
 
 /**
- * Delete a customer
- * @param id The ID of the customer to delete
- * @return true if successful, false otherwise
+ * Find the customers whose name or email contains a search term (case-insensitive)
+ * @param query The term to search for
+ * @param matches Array of customerCount flags, set for every matching customer
+ * @return Number of matching customers
  */
-bool deleteCustomer(int id);
+int searchCustomers(const char *query, bool *matches);
 
 /**
  * Save customer data to file
@@ -102,4 +85,32 @@ void sortCustomersByName();
  */
 int findCustomerById(int id);
 
+/**
+ * Find the customers with a phone number
+ * Punctuation and spaces are ignored, so "(555) 123-4567" matches "555-123-4567"
+ * Several customers (such as a household) may share one phone number.
+ * @param phone The phone number to search for
+ * @param slots Array to store the indexes of the customers (in ID order)
+ * @param maxSlots Maximum number of indexes to store
+ * @return Number of customers with the phone number (may exceed maxSlots)
+ */
+int findCustomersByPhone(const char *phone, int *slots, int maxSlots);
+
+/**
+ * Find the customers with an email address (case-insensitive)
+ * @param email The email address to search for
+ * @param slots Array to store the indexes of the customers (in ID order)
+ * @param maxSlots Maximum number of indexes to store
+ * @return Number of customers with the email address (may exceed maxSlots)
+ */
+int findCustomersByEmail(const char *email, int *slots, int maxSlots);
+
+/**
+ * Parse a transaction's customer ID field into a numeric customer ID
+ * @param text The customer ID text (e.g. "42" or "Anonymous")
+ * @param id Pointer to store the parsed ID
+ * @return true if the text is a numeric customer ID, false otherwise
+ */
+bool parseCustomerId(const char *text, int *id);
+
 #endif /* CUSTOMER_H */
\ No newline at end of file
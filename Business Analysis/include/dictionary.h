@@ -0,0 +1,69 @@
+/**
+ * String Dictionary Header File
+ * Contains function declarations for the interned string dictionary
+ * Repeated strings (categories, record types, payment methods and statuses)
+ * are stored once and referred to by a dense numeric ID
+ */
+
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Maximum number of distinct strings in the dictionary
+#define MAX_DICTIONARY_SIZE 256
+
+// Maximum length of a dictionary string (including terminator)
+#define DICTIONARY_STRING_LENGTH 30
+
+// ID returned when a string is not in the dictionary
+#define INVALID_STRING_ID UINT32_MAX
+
+// Well-known strings, always interned first so their IDs are fixed
+#define STRING_ID_INCOME 0
+#define STRING_ID_EXPENSE 1
+#define STRING_ID_COMPLETED 2
+#define STRING_ID_CASH 3
+
+/**
+ * Get the ID of a string, adding it to the dictionary if needed
+ * New strings are saved to the dictionary file immediately
+ * @param value The string to intern
+ * @return The ID of the string, or INVALID_STRING_ID if the dictionary is full
+ */
+uint32_t internString(const char *value);
+
+/**
+ * Get the ID of a string without adding it
+ * @param value The string to search for
+ * @return The ID of the string, or INVALID_STRING_ID if not found
+ */
+uint32_t findStringId(const char *value);
+
+/**
+ * Get the string for an ID
+ * @param id The ID to look up
+ * @return The string, or an empty string if the ID is invalid
+ */
+const char *lookupString(uint32_t id);
+
+/**
+ * Get the number of strings in the dictionary
+ * @return The number of strings (IDs are 0 to size - 1)
+ */
+int getDictionarySize();
+
+/**
+ * Save the dictionary to file
+ * @return true if successful, false otherwise
+ */
+bool saveDictionary();
+
+/**
+ * Load the dictionary from file (or start a new one with the well-known strings)
+ * @return true if loaded from file, false if a new dictionary was started
+ */
+bool loadDictionary();
+
+#endif /* DICTIONARY_H */
\ No newline at end of file
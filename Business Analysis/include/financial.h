@@ -7,20 +7,102 @@
 #define FINANCIAL_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "dictionary.h"
+#include "utils.h"  // For MAX_ARRAY_SIZE
+
+// Number of financial records stored per block in the financial file
+#define FINANCIAL_BLOCK_RECORDS 16
 
 // Financial record structure
 typedef struct {
     char date[20];            // Date of the record
-    char category[30];        // Category (e.g., Sales, Expense, Profit)
+    uint32_t categoryId;      // Category (dictionary ID, e.g. Sales, Rent)
     double amount;            // Amount
-    char type[10];            // Type (Income or Expense)
+    uint32_t typeId;          // Type (STRING_ID_INCOME or STRING_ID_EXPENSE)
     char description[200];    // Description
 } FinancialRecord;
 
-/**
- * Run the financial analysis module
- */
-void runFinancialAnalysis();
+// Zone map at the start of each block, summarising the block's records
+typedef struct {
+    char minDate[20];         // Earliest record date in the block
+    char maxDate[20];         // Latest record date in the block
+    int32_t recordCount;      // Number of records used in the block
+    int32_t incomeCount;      // Number of income records
+    int32_t expenseCount;     // Number of expense records
+    int32_t reserved;         // Keeps the totals 8-byte aligned
+    double incomeTotal;       // Sum of the income amounts
+    double expenseTotal;      // Sum of the expense amounts
+    uint64_t categoryBitmap[MAX_DICTIONARY_SIZE / 64];  // Bit set for each category ID present
+} FinancialBlockHeader;
+
+// One fixed-size block of the financial file
+typedef struct {
+    FinancialBlockHeader header;
+    FinancialRecord records[FINANCIAL_BLOCK_RECORDS];
+} FinancialBlock;
+
+// Longest consumer name accepted for incremental export
+#define MAX_EXPORT_CONSUMER_LENGTH 40
+
+// How far one consumer has got with incremental export of the financial records
+// Records are only ever appended, so a record's position is its sequence number;
+// the last exported record is kept to notice a store whose history was replaced
+typedef struct {
+    uint32_t sequence;        // Number of records already exported
+    uint32_t categoryId;      // Category of the last exported record
+    uint32_t typeId;          // Type of the last exported record
+    uint32_t reserved;        // Keeps the amount 8-byte aligned
+    double amount;            // Amount of the last exported record
+    char date[24];            // Date of the last exported record
+} ExportWatermark;
+
+// Total of one category in a report
+typedef struct {
+    uint32_t categoryId;      // Category (dictionary ID)
+    double amount;            // Total amount in the period
+    double percentage;        // Share of the total of its type
+} CategoryTotal;
+
+// Totals of one month in a report
+typedef struct {
+    char month[8];            // Month (YYYY-MM)
+    double income;            // Income in the month
+    double expenses;          // Expenses in the month
+    double profit;            // Income less expenses
+} MonthlyTotal;
+
+// Income, expenses and profit of a period
+typedef struct {
+    double totalIncome;       // Total income
+    double totalExpenses;     // Total expenses
+    double profit;            // Net profit/loss
+    double profitMargin;      // Profit as a percentage of income
+} FinancialSummary;
+
+// Result of the income statement: the summary and both category breakdowns
+typedef struct {
+    FinancialSummary summary;
+    int incomeCategoryCount;
+    CategoryTotal incomeCategories[MAX_ARRAY_SIZE];   // In first-seen order
+    int expenseCategoryCount;
+    CategoryTotal expenseCategories[MAX_ARRAY_SIZE];  // In first-seen order
+} IncomeStatement;
+
+// Result of the expense report; the expense records themselves are read from
+// the store while the report is written rather than copied here
+typedef struct {
+    double totalExpenses;
+    int categoryCount;
+    CategoryTotal categories[MAX_ARRAY_SIZE];         // In first-seen order
+} ExpenseReport;
+
+// Result of the profit and loss report: the summary and a row per month
+typedef struct {
+    FinancialSummary summary;
+    int monthCount;
+    MonthlyTotal months[MAX_ARRAY_SIZE];              // In month order
+} ProfitLossReport;
 
 /**
  * Add a new financial record
@@ -33,6 +115,14 @@ void runFinancialAnalysis();
  */
 bool addFinancialRecord(const char *date, const char *category, double amount, const char *type, const char *description);
 
+/**
+ * Add a batch of financial records and save them once
+ * @param records The records to add
+ * @param count Number of records
+ * @return true if successful, false if the records do not fit or could not be saved
+ */
+bool appendFinancialRecords(const FinancialRecord *records, int count);
+
 /**
  * Calculate income for a given period
  * @param startDate Start date of the period
@@ -66,35 +156,118 @@ double calculateProfit(const char *startDate, const char *endDate);
 double calculateProfitMargin(const char *startDate, const char *endDate);
 
 /**
- * Generate income statement for a given period
+ * Compute the income statement for a given period
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param statement Receives the result
+ */
+void buildIncomeStatement(const char *startDate, const char *endDate, IncomeStatement *statement);
+
+/**
+ * Compute the expense report for a given period
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param report Receives the result
+ */
+void buildExpenseReport(const char *startDate, const char *endDate, ExpenseReport *report);
+
+/**
+ * Compute the profit and loss report for a given period
  * @param startDate Start date of the period
  * @param endDate End date of the period
+ * @param report Receives the result
  */
-void generateIncomeStatement(const char *startDate, const char *endDate);
+void buildProfitLossReport(const char *startDate, const char *endDate, ProfitLossReport *report);
 
 /**
- * Generate expense report for a given period
+ * Export an income statement to a CSV file
+ * @param filename The file to create, or "-" for standard output
  * @param startDate Start date of the period
  * @param endDate End date of the period
+ * @param statement The result to export
+ * @return true if successful, false otherwise
+ */
+bool exportIncomeStatementCsv(const char *filename, const char *startDate, const char *endDate,
+                              const IncomeStatement *statement);
+
+/**
+ * Export an expense report to a CSV file, followed by the expense records of the period
+ * @param filename The file to create, or "-" for standard output
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param report The result to export
+ * @return true if successful, false otherwise
+ */
+bool exportExpenseReportCsv(const char *filename, const char *startDate, const char *endDate,
+                            const ExpenseReport *report);
+
+/**
+ * Export a profit and loss report to a CSV file
+ * @param filename The file to create, or "-" for standard output
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param report The result to export
+ * @return true if successful, false otherwise
+ */
+bool exportProfitLossReportCsv(const char *filename, const char *startDate, const char *endDate,
+                               const ProfitLossReport *report);
+
+/**
+ * Write the income statement for a given period as JSON or NDJSON
+ * @param path The file to create, or NULL or "-" for standard output
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param lineDelimited true for NDJSON, false for one JSON document
+ * @return true if successful, false otherwise
  */
-void generateExpenseReport(const char *startDate, const char *endDate);
+bool writeIncomeStatementJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited);
 
 /**
- * Generate profit and loss report for a given period
+ * Write the expense report for a given period as JSON or NDJSON,
+ * streaming every expense record of the period after the category totals
+ * @param path The file to create, or NULL or "-" for standard output
  * @param startDate Start date of the period
  * @param endDate End date of the period
+ * @param lineDelimited true for NDJSON, false for one JSON document
+ * @return true if successful, false otherwise
  */
-void generateProfitLossReport(const char *startDate, const char *endDate);
+bool writeExpenseReportJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited);
 
 /**
- * Display financial records for a given period
+ * Write the profit and loss report for a given period as JSON or NDJSON
+ * @param path The file to create, or NULL or "-" for standard output
  * @param startDate Start date of the period
  * @param endDate End date of the period
+ * @param lineDelimited true for NDJSON, false for one JSON document
+ * @return true if successful, false otherwise
  */
-void displayFinancialRecords(const char *startDate, const char *endDate);
+bool writeProfitLossReportJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited);
 
 /**
- * Save financial data to file
+ * Find the financial records of a period
+ * @param startDate Start date of the period, or NULL/empty for no lower bound
+ * @param endDate End date of the period, or NULL/empty for no upper bound
+ * @param slots Array of at least MAX_ARRAY_SIZE entries to receive record indexes in file order
+ * @return Number of indexes stored
+ */
+int findFinancialRecordsInPeriod(const char *startDate, const char *endDate, int *slots);
+
+/**
+ * Find the financial records that may fall in a period, skipping whole blocks
+ * whose zone maps rule them out
+ * Callers still apply their own exact date comparison to the results
+ * @param startDate Start date of the period, or NULL/empty for no lower bound
+ * @param endDate End date of the period, or NULL/empty for no upper bound
+ * @param categoryId Category the records must have, or INVALID_STRING_ID for any
+ * @param slots Array to receive record indexes in file order
+ * @param maxSlots Maximum number of indexes to store
+ * @return Number of indexes stored
+ */
+int findFinancialRecordCandidates(const char *startDate, const char *endDate, uint32_t categoryId,
+                                  int *slots, int maxSlots);
+
+/**
+ * Save financial data to file, grouped into blocks with zone maps
  * @return true if successful, false otherwise
  */
 bool saveFinancialData();
@@ -114,4 +287,23 @@ bool loadFinancialData();
  */
 bool exportFinancialData(const char *filename, const char *startDate, const char *endDate);
 
+/**
+ * Append the financial records added since a consumer's last run to a CSV file
+ * Each consumer keeps its own watermark in the data folder, advanced only after
+ * the rows are written; every row carries its sequence number, so rows repeated
+ * after a failed run can be recognised. A new file starts with a header line.
+ * @param consumer Name of the consumer (letters, digits, - and _)
+ * @param filename CSV file to append to
+ * @return Number of records exported, or -1 on failure
+ */
+int exportFinancialDataSince(const char *consumer, const char *filename);
+
+/**
+ * Export every financial record as a columnar file (see columnar.h), with the
+ * record's sequence number as used by incremental export
+ * @param path The file to create
+ * @return true if successful, false otherwise
+ */
+bool exportFinancialColumnar(const char *path);
+
 #endif /* FINANCIAL_H */
\ No newline at end of file
@@ -2,14 +2,19 @@
 #define GLOBALS_H
 
 #include "product.h"
+#include "customer.h"
 #include "billing.h"
 #include "financial.h"
+#include "dictionary.h"
 #include "utils.h"  // This is where MAX_ARRAY_SIZE is defined
 
 // Now these declarations will know about MAX_ARRAY_SIZE
 extern Product products[MAX_ARRAY_SIZE];
 extern int productCount;
 
+extern Customer customers[MAX_ARRAY_SIZE];
+extern int customerCount;
+
 extern Transaction transactions[MAX_ARRAY_SIZE];
 extern int transactionCount;
 
@@ -0,0 +1,48 @@
+/**
+ * Bulk Import Header File
+ * Contains the CSV importer used to migrate products, customers, transactions
+ * and financial records from another system in one step
+ */
+
+#ifndef IMPORT_H
+#define IMPORT_H
+
+#include <stdbool.h>
+
+// Smallest slice of a CSV file handed to one parser task
+#define IMPORT_MIN_CHUNK_SIZE (64 * 1024)
+
+// Maximum number of slices a CSV file is split into
+#define IMPORT_MAX_CHUNKS 64
+
+// Store a CSV file is imported into, with the columns each line must have
+typedef enum {
+    IMPORT_PRODUCTS,       // id,name,price,quantity,category,description
+    IMPORT_CUSTOMERS,      // id,name,phone,email,address,notes
+    IMPORT_TRANSACTIONS,   // transaction_id,date,customer_id,payment_method,status,product_id,quantity,price
+    IMPORT_FINANCIAL       // date,type,category,amount,description
+} ImportKind;
+
+/**
+ * Look up an import kind by its command-line name
+ * @param name products, customers, transactions or financial
+ * @param kind Receives the kind
+ * @return true if the name is known, false otherwise
+ */
+bool parseImportKind(const char *name, ImportKind *kind);
+
+/**
+ * Import every line of a CSV file into a store and save the store once
+ * The file is mapped and parsed in parallel slices split between records.
+ * An optional header line is skipped, fields may be quoted (and quoted fields
+ * may contain line breaks), and transactions take one line per item, with
+ * consecutive lines of the same transaction ID forming one transaction.
+ * Nothing is imported if any line is invalid, an ID is already taken, or a
+ * transaction item names a product that is not in the product store.
+ * @param kind The store to import into
+ * @param path The CSV file
+ * @return true if every line was imported, false otherwise
+ */
+bool importCsvFile(ImportKind kind, const char *path);
+
+#endif /* IMPORT_H */
\ No newline at end of file
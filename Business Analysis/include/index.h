@@ -0,0 +1,186 @@
+/**
+ * Index Header File
+ * Contains structures and function declarations for the secondary lookup indexes
+ */
+
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <stdbool.h>
+
+// Number of buckets in the customer-to-transactions index (must be a power of two)
+#define CUSTOMER_INDEX_BUCKETS 256
+
+// Number of buckets in the product-to-transactions index (must be a power of two)
+#define PRODUCT_INDEX_BUCKETS 256
+
+// Number of buckets in an exact-match string index (must be a power of two)
+#define STRING_INDEX_BUCKETS 256
+
+// Maximum key length (including terminator) in an exact-match string index
+#define STRING_INDEX_KEY_LENGTH 50
+
+// Bucket of an exact-match string index
+typedef struct {
+    char key[STRING_INDEX_KEY_LENGTH];  // Normalized key
+    int value;                          // Value stored for the key
+    char state;                         // 0 = empty, 1 = used, 2 = deleted
+} StringIndexEntry;
+
+// Exact-match hash index from a normalized string to integers (open addressing)
+// A key may be stored with several values, one bucket per key and value pair
+typedef struct {
+    StringIndexEntry entries[STRING_INDEX_BUCKETS];
+} StringHashIndex;
+
+// Number of buckets in a trigram index (must be a power of two)
+#define TRIGRAM_BUCKETS 4096
+
+// Function that returns the text of a record for the trigram index
+typedef const char *(*TrigramTextGetter)(int slot);
+
+// Case-folded trigram index over one text field of a record array
+// Postings for each bucket are stored contiguously, in increasing slot order
+typedef struct {
+    int bucketStart[TRIGRAM_BUCKETS + 1];  // Start of each bucket's postings
+    int *postings;                         // Record slots for all buckets
+    int recordCount;                       // Number of records indexed
+    bool valid;                            // Whether the index matches the records
+} TrigramIndex;
+
+// Cursor over a product's postings in the product-to-transactions index
+typedef struct {
+    const unsigned char *position;  // Next encoded posting
+    const unsigned char *end;       // End of the encoded postings
+    int slot;                       // Transaction slot of the last decoded posting
+} ProductPostingCursor;
+
+/**
+ * Rebuild all transaction indexes from the transactions array
+ */
+void rebuildTransactionIndexes();
+
+/**
+ * Add a transaction to all transaction indexes
+ * Transactions must be added in the order they appear in the transactions array
+ * @param slot Index of the transaction in the transactions array
+ */
+void indexTransaction(int slot);
+
+/**
+ * Rebuild the customer-to-transactions index from the transactions array
+ */
+void rebuildCustomerTransactionIndex();
+
+/**
+ * Add a transaction to the customer-to-transactions index
+ * Transactions must be added in the order they appear in the transactions array
+ * @param slot Index of the transaction in the transactions array
+ * @return true if the transaction was indexed, false if it has no customer ID
+ */
+bool indexCustomerTransaction(int slot);
+
+/**
+ * Get the transactions made by a customer
+ * @param customerId The ID of the customer
+ * @param slots Array to store the transaction indexes (oldest first)
+ * @param maxSlots Maximum number of indexes to store
+ * @return Number of transactions found
+ */
+int getCustomerTransactions(int customerId, int *slots, int maxSlots);
+
+/**
+ * Rebuild the product-to-transactions index from the transactions array
+ */
+void rebuildProductTransactionIndex();
+
+/**
+ * Add the items of a transaction to the product-to-transactions index
+ * Transactions must be added in the order they appear in the transactions array
+ * @param slot Index of the transaction in the transactions array
+ * @return true if successful, false if memory could not be allocated
+ */
+bool indexProductTransaction(int slot);
+
+/**
+ * Open a cursor over the postings of a product
+ * @param productId The ID of the product
+ * @param cursor The cursor to initialize
+ * @return true if the product has postings, false otherwise
+ */
+bool openProductPostings(int productId, ProductPostingCursor *cursor);
+
+/**
+ * Read the next posting from a product cursor
+ * Postings are returned in transaction order
+ * @param cursor The cursor to read from
+ * @param slot Pointer to store the transaction slot
+ * @param itemOffset Pointer to store the item's position within the transaction
+ * @return true if a posting was read, false at the end of the postings
+ */
+bool nextProductPosting(ProductPostingCursor *cursor, int *slot, int *itemOffset);
+
+/**
+ * Remove all entries from an exact-match string index
+ * @param index The index to clear
+ */
+void clearStringIndex(StringHashIndex *index);
+
+/**
+ * Add a value for a key to an exact-match string index
+ * @param index The index to add to
+ * @param key The normalized key (empty keys are not indexed)
+ * @param value The value to store; other values already stored for the key are kept
+ * @return true if added, false if the key is empty, already has this value or the index is full
+ */
+bool addStringIndexEntry(StringHashIndex *index, const char *key, int value);
+
+/**
+ * Remove one value of a key from an exact-match string index
+ * @param index The index to remove from
+ * @param key The normalized key
+ * @param value The value to remove
+ * @return true if it was removed, false if the key did not have this value
+ */
+bool removeStringIndexEntry(StringHashIndex *index, const char *key, int value);
+
+/**
+ * Look up every value stored for a key in an exact-match string index
+ * @param index The index to search
+ * @param key The normalized key
+ * @param values Array to store the values (in no particular order)
+ * @param maxValues Maximum number of values to store
+ * @return Number of values stored for the key (may exceed maxValues)
+ */
+int findStringIndexEntries(const StringHashIndex *index, const char *key, int *values, int maxValues);
+
+/**
+ * Build a trigram index over a text field
+ * @param index The index to build
+ * @param recordCount Number of records to index
+ * @param getText Function returning the text of a record
+ * @return true if successful, false if memory could not be allocated
+ */
+bool buildTrigramIndex(TrigramIndex *index, int recordCount, TrigramTextGetter getText);
+
+/**
+ * Mark a trigram index as out of date so it is rebuilt before the next search
+ * @param index The index to invalidate
+ */
+void invalidateTrigramIndex(TrigramIndex *index);
+
+/**
+ * Find the records whose text contains a substring (case-insensitive)
+ * Candidates are found by intersecting the posting lists of the query's
+ * trigrams and then verified against the record text
+ * @param index The index to search (rebuilt first if invalid)
+ * @param recordCount Number of records currently in the array
+ * @param getText Function returning the text of a record
+ * @param query The substring to search for
+ * @param matches Array marking matching records (entries are set, never cleared)
+ * @return Number of newly marked records
+ */
+int searchTrigramIndex(TrigramIndex *index, int recordCount, TrigramTextGetter getText,
+                       const char *query, bool *matches);
+
+#endif /* INDEX_H */
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+ * JSON Writer Header File
+ * Contains the buffered writer that streams report results as one JSON
+ * document or as newline-delimited JSON (NDJSON), one record per line
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size of the output buffer; records are gathered here and written in large blocks
+#define JSON_WRITER_BUFFER_SIZE (256 * 1024)
+
+// Buffered JSON report output
+// A report is a header naming the report and its period followed by a stream of
+// flat records, each tagged with a "type" field. As a JSON document the records
+// form the "records" array of the header object; as NDJSON the header and every
+// record are separate lines, so a consumer can process them as they arrive.
+typedef struct {
+    FILE *file;            // The output file, or stdout
+    bool ownsFile;         // Whether the file is closed with the writer
+    bool lineDelimited;    // NDJSON rather than one JSON document
+    char *buffer;          // Bytes not yet written to the file
+    size_t length;         // Number of bytes in the buffer
+    int recordCount;       // Number of records started so far
+    bool fieldWritten;     // Whether the current object already has a field
+    bool failed;           // Whether any write has failed
+} JsonWriter;
+
+/**
+ * Start a report and write its header
+ * @param writer The writer to initialize
+ * @param path The file to create, or NULL or "-" for standard output
+ * @param lineDelimited true for NDJSON, false for one JSON document
+ * @param report Name of the report, such as income_statement
+ * @param startDate Start of the report period, or NULL/empty for none
+ * @param endDate End of the report period, or NULL/empty for none
+ * @return true if the output was opened, false otherwise
+ */
+bool openJsonReport(JsonWriter *writer, const char *path, bool lineDelimited,
+                    const char *report, const char *startDate, const char *endDate);
+
+/**
+ * Finish the report, write out the buffer and close the file
+ * @param writer The writer to close
+ * @return true if everything was written, false if any write failed
+ */
+bool closeJsonReport(JsonWriter *writer);
+
+/**
+ * Start a record
+ * @param writer The writer
+ * @param type Value of the record's "type" field, such as summary
+ */
+void beginJsonRecord(JsonWriter *writer, const char *type);
+
+/**
+ * End the current record
+ * @param writer The writer
+ */
+void endJsonRecord(JsonWriter *writer);
+
+/**
+ * Write a text field, escaping it as needed
+ * @param writer The writer
+ * @param key The field name
+ * @param value The field value, or NULL for null
+ */
+void writeJsonString(JsonWriter *writer, const char *key, const char *value);
+
+/**
+ * Write a whole number field
+ * @param writer The writer
+ * @param key The field name
+ * @param value The field value
+ */
+void writeJsonInt(JsonWriter *writer, const char *key, long long value);
+
+/**
+ * Write a number field with a fixed number of decimals
+ * @param writer The writer
+ * @param key The field name
+ * @param value The field value; NaN and infinity are written as null
+ * @param decimals Number of digits after the decimal point (0-9)
+ */
+void writeJsonNumber(JsonWriter *writer, const char *key, double value, int decimals);
+
+#endif /* JSON_WRITER_H */
\ No newline at end of file
@@ -0,0 +1,90 @@
+/**
+ * Lookup Table Header File
+ * Contains sorted key-to-slot tables (ID to slot, date to slot) that are
+ * saved next to the data files and reused on the next start while the
+ * data file generation they were built from still matches
+ */
+
+#ifndef LOOKUP_H
+#define LOOKUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// One key-to-slot pair; tables are kept sorted by key, then slot
+typedef struct {
+    int32_t key;    // Lookup key (an ID, a hash of an ID or a day number)
+    int32_t slot;   // Index of the record in its global array
+} LookupEntry;
+
+// Sorted key-to-slot table
+typedef struct {
+    LookupEntry *entries;   // Entries sorted by key, then slot
+    int count;              // Number of entries
+    int capacity;           // Number of entries allocated
+    bool valid;             // false when the table must be rebuilt
+} LookupTable;
+
+/**
+ * Empty a lookup table and mark it valid
+ * @param table The table to clear
+ */
+void clearLookupTable(LookupTable *table);
+
+/**
+ * Mark a lookup table as out of date
+ * @param table The table to invalidate
+ */
+void invalidateLookupTable(LookupTable *table);
+
+/**
+ * Append an entry without keeping the table sorted (call sortLookupTable afterwards)
+ * @param table The table to append to
+ * @param key The key
+ * @param slot The slot the key refers to
+ * @return true if successful, false if out of memory
+ */
+bool appendLookupEntry(LookupTable *table, int32_t key, int32_t slot);
+
+/**
+ * Sort a table filled with appendLookupEntry
+ * @param table The table to sort
+ */
+void sortLookupTable(LookupTable *table);
+
+/**
+ * Insert an entry at its sorted position
+ * @param table The table to insert into
+ * @param key The key
+ * @param slot The slot the key refers to
+ * @return true if successful, false if out of memory
+ */
+bool insertLookupEntry(LookupTable *table, int32_t key, int32_t slot);
+
+/**
+ * Find the first entry whose key is not less than the given key
+ * @param table The table to search
+ * @param key The key to search for
+ * @return Index of the entry, or table->count if every key is smaller
+ */
+int findLookupLowerBound(const LookupTable *table, int32_t key);
+
+/**
+ * Load a lookup table saved by saveLookupTable
+ * @param table Receives the entries
+ * @param path The index file
+ * @param sourceGeneration Current generation of the data file the table describes
+ * @return true if the file exists and matches the data file, false if the table must be rebuilt
+ */
+bool loadLookupTable(LookupTable *table, const char *path, uint64_t sourceGeneration);
+
+/**
+ * Save a lookup table next to its data file
+ * @param table The table to save
+ * @param path The index file
+ * @param sourceGeneration Generation of the data file the table describes
+ * @return true if successful, false otherwise
+ */
+bool saveLookupTable(const LookupTable *table, const char *path, uint64_t sourceGeneration);
+
+#endif /* LOOKUP_H */
\ No newline at end of file
@@ -0,0 +1,269 @@
+/**
+ * Menu Header File
+ * Contains the interactive menus, screens and prompts of each module. They sit
+ * on top of the core modules, which take query inputs, return result structures
+ * and never prompt, so the core can be built as a library without them
+ */
+
+#ifndef MENU_H
+#define MENU_H
+
+#include "product.h"
+#include "customer.h"
+#include "billing.h"
+#include "financial.h"
+#include "trend_analysis.h"
+
+// Product management screens (product_menu.c)
+
+/**
+ * Run the product management module
+ */
+void runProductManagement();
+
+/**
+ * Prompt for a new product and add it
+ * @return true if successful, false otherwise
+ */
+bool addProduct();
+
+/**
+ * Search for a product by ID
+ * @param id The ID to search for
+ * @return true if found, false otherwise
+ */
+bool searchProductById(int id);
+
+/**
+ * Search for products by name
+ * @param name The name (or part of name) to search for
+ */
+void searchProductsByName(const char *name);
+
+/**
+ * Search for products by category
+ * @param category The category to search for
+ */
+void searchProductsByCategory(const char *category);
+
+/**
+ * Display all products
+ */
+void displayAllProducts();
+
+/**
+ * Display products filtered by category
+ * @param category The category to filter by
+ */
+void displayProductsByCategory(const char *category);
+
+/**
+ * Display details for a specific product
+ * @param product Pointer to the product to display
+ */
+void displayProductDetails(const Product *product);
+
+/**
+ * Prompt for a product's new information and save it
+ * @param id The ID of the product to edit
+ * @return true if successful, false otherwise
+ */
+bool editProduct(int id);
+
+/**
+ * Confirm and delete a product
+ * @param id The ID of the product to delete
+ * @return true if successful, false otherwise
+ */
+bool deleteProduct(int id);
+
+/**
+ * Check if any products are low in stock
+ * @param threshold The threshold quantity
+ * @return Number of products below the threshold
+ */
+int checkLowStock(int threshold);
+
+// Customer management screens (customer_menu.c)
+
+/**
+ * Run the customer management module
+ */
+void runCustomerManagement();
+
+/**
+ * Prompt for a new customer and add it
+ * @return true if successful, false otherwise
+ */
+bool addCustomer();
+
+/**
+ * Search for a customer by ID
+ * @param id The ID to search for
+ * @return true if found, false otherwise
+ */
+bool searchCustomerById(int id);
+
+/**
+ * Search for customers by name
+ * @param name The name (or part of name) to search for
+ */
+void searchCustomersByName(const char *name);
+
+/**
+ * Display the purchase history of a customer
+ * @param id The ID of the customer
+ * @return true if the customer was found, false otherwise
+ */
+bool displayCustomerPurchaseHistory(int id);
+
+/**
+ * Display all customers
+ */
+void displayAllCustomers();
+
+/**
+ * Display details for a specific customer
+ * @param customer Pointer to the customer to display
+ */
+void displayCustomerDetails(const Customer *customer);
+
+/**
+ * Prompt for a customer's new information and save it
+ * @param id The ID of the customer to edit
+ * @return true if successful, false otherwise
+ */
+bool editCustomer(int id);
+
+/**
+ * Confirm and delete a customer
+ * @param id The ID of the customer to delete
+ * @return true if successful, false otherwise
+ */
+bool deleteCustomer(int id);
+
+// Billing screens (billing_menu.c)
+
+/**
+ * Run the billing system module
+ */
+void runBillingSystem();
+
+/**
+ * Display transaction history
+ * @param startDate Start date for filtering (optional)
+ * @param endDate End date for filtering (optional)
+ * @param paymentMethod Payment method for filtering (optional)
+ */
+void displayTransactionHistory(const char *startDate, const char *endDate, const char *paymentMethod);
+
+/**
+ * Display transaction details
+ * @param transactionId The ID of the transaction to display
+ * @return true if found, false otherwise
+ */
+bool displayTransactionDetails(const char *transactionId);
+
+/**
+ * Display a sales report computed by buildSalesReport
+ * @param startDate Start date for the period
+ * @param endDate End date for the period
+ * @param report The result to display
+ */
+void displaySalesReport(const char *startDate, const char *endDate, const SalesReport *report);
+
+/**
+ * Generate a sales report for a given period
+ * @param startDate Start date for the period
+ * @param endDate End date for the period
+ */
+void generateSalesReport(const char *startDate, const char *endDate);
+
+// Financial analysis screens (financial_menu.c)
+
+/**
+ * Run the financial analysis module
+ */
+void runFinancialAnalysis();
+
+/**
+ * Display an income statement computed by buildIncomeStatement
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param statement The result to display
+ */
+void displayIncomeStatement(const char *startDate, const char *endDate, const IncomeStatement *statement);
+
+/**
+ * Display an expense report computed by buildExpenseReport
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param report The result to display
+ */
+void displayExpenseReport(const char *startDate, const char *endDate, const ExpenseReport *report);
+
+/**
+ * Display a profit and loss report computed by buildProfitLossReport
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ * @param report The result to display
+ */
+void displayProfitLossReport(const char *startDate, const char *endDate, const ProfitLossReport *report);
+
+/**
+ * Generate income statement for a given period
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ */
+void generateIncomeStatement(const char *startDate, const char *endDate);
+
+/**
+ * Generate expense report for a given period
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ */
+void generateExpenseReport(const char *startDate, const char *endDate);
+
+/**
+ * Generate profit and loss report for a given period
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ */
+void generateProfitLossReport(const char *startDate, const char *endDate);
+
+/**
+ * Display financial records for a given period
+ * @param startDate Start date of the period
+ * @param endDate End date of the period
+ */
+void displayFinancialRecords(const char *startDate, const char *endDate);
+
+// Trend analysis screens (trend_menu.c)
+
+/**
+ * Run the trend analysis module
+ */
+void runTrendAnalysis();
+
+/**
+ * Show sales graph using Python script
+ * @param dataFile Path to CSV data file
+ * @param title Title for the graph
+ * @param xLabel Label for x-axis
+ * @param yLabel Label for y-axis
+ * @return true if successful, false otherwise
+ */
+bool showSalesGraph(const char *dataFile, const char *title, const char *xLabel, const char *yLabel);
+
+/**
+ * Generate sales forecast report
+ * @param months Number of months to forecast
+ */
+void generateSalesForecastReport(int months);
+
+/**
+ * Generate customer segmentation (RFM) report
+ */
+void generateCustomerSegmentationReport();
+
+#endif /* MENU_H */
\ No newline at end of file
@@ -0,0 +1,25 @@
+/**
+ * Migration Header File
+ * Contains the one-time conversion of data files written by the first
+ * version of the program, which stored a record count followed by the raw
+ * structure array, into the current data file layout
+ */
+
+#ifndef MIGRATION_H
+#define MIGRATION_H
+
+#include <stdbool.h>
+
+// Suffix added to a converted file, which is kept as a backup
+#define LEGACY_BACKUP_SUFFIX ".old"
+
+/**
+ * Convert any data file still in the first version's layout and save it in
+ * the current layout, keeping the original under LEGACY_BACKUP_SUFFIX
+ * Runs before the stores are loaded, one store at a time, since converting
+ * interns categories and statuses into the shared dictionary
+ * @return true if every legacy file was converted (or none was found), false otherwise
+ */
+bool migrateLegacyDataFiles();
+
+#endif /* MIGRATION_H */
\ No newline at end of file
@@ -0,0 +1,47 @@
+/**
+ * Parallel Tasks Header File
+ * Contains a small portable worker pool for running independent tasks
+ * concurrently (Win32 threads on Windows, POSIX threads elsewhere)
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdbool.h>
+
+// Upper bound on the number of worker threads started for one batch
+#define MAX_WORKER_THREADS 16
+
+// Function run by a task
+typedef void (*ParallelTaskFunction)(void *argument);
+
+// One unit of work for runParallelTasks
+typedef struct {
+    ParallelTaskFunction function;  // Work to run
+    void *argument;                 // Argument passed to the function
+    double elapsedMilliseconds;     // Filled in with the task's wall-clock time
+} ParallelTask;
+
+/**
+ * Get the number of worker threads worth starting on this machine
+ * @return The number of online processors, between 1 and MAX_WORKER_THREADS
+ */
+int getWorkerThreadCount();
+
+/**
+ * Run tasks concurrently on a pool of worker threads and wait for all of them
+ * The calling thread also takes tasks, so the batch still completes if no
+ * thread can be started
+ * @param tasks The tasks to run
+ * @param taskCount Number of tasks
+ * @param threadCount Maximum number of threads to use, including the caller
+ */
+void runParallelTasks(ParallelTask *tasks, int taskCount, int threadCount);
+
+/**
+ * Get a monotonic timestamp for measuring elapsed time
+ * @return Milliseconds since an arbitrary fixed point
+ */
+double getMonotonicMilliseconds();
+
+#endif /* PARALLEL_H */
\ No newline at end of file
@@ -7,85 +7,173 @@
 #define PRODUCT_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>  // For FILE
 
-// Product structure definition
+// Pending product changes are written once this many products are dirty...
+#define PRODUCT_FLUSH_THRESHOLD 32
+
+// ...or once the oldest pending change is this many milliseconds old
+#define PRODUCT_FLUSH_INTERVAL_MS 2000
+
+// Product structure definition (hot fields read on every checkout)
 typedef struct {
     int id;                // Unique identifier for the product
-    char name[50];         // Product name
     double price;          // Product price
     int quantity;          // Current stock quantity
-    char category[30];     // Product category
-    char description[200]; // Product description
+    uint32_t categoryId;   // Product category (dictionary ID)
 } Product;
 
+// Rarely read product text, kept apart from the hot array and loaded on demand
+typedef struct {
+    int id;                // ID of the product this text belongs to
+    char name[50];         // Product name
+    char description[200]; // Product description
+} ProductDetails;
+
+// One line of a goods-receiving batch
+typedef struct {
+    int productId;   // ID of the product to adjust
+    int delta;       // Quantity to add (positive) or remove (negative)
+} InventoryAdjustment;
+
+// A bulk price change applied to every product in a category
+typedef struct {
+    uint32_t categoryId;   // Category to reprice (dictionary ID), or INVALID_STRING_ID for every product
+    double percentChange;  // Percentage to apply, e.g. 4 for +4% or -10 for -10%
+    double amountChange;   // Fixed amount added after the percentage
+    double priceEnding;    // Round to the nearest price ending in these cents (e.g. 0.99), or negative to round to the cent
+} PriceRule;
+
+// Totals over the products a price rule matches, before and after the change
+typedef struct {
+    int productCount;          // Number of products matched
+    double totalBefore;        // Sum of their prices before the change
+    double totalAfter;         // Sum of their prices after the change
+    double stockValueBefore;   // Sum of price * quantity before the change
+    double stockValueAfter;    // Sum of price * quantity after the change
+} RepricingSummary;
+
 /**
- * Run the product management module
+ * Add a batch of new products and save them once
+ * @param newProducts The products to add; their IDs must not already exist
+ * @param newDetails Names and descriptions, parallel to newProducts
+ * @param count Number of products
+ * @return true if successful, false if the products do not fit or could not be saved
  */
-void runProductManagement();
+bool appendProducts(const Product *newProducts, const ProductDetails *newDetails, int count);
 
 /**
- * Add a new product
+ * Replace a product's price, quantity, category, name and description
+ * The change is written behind, like updateProductInventory
+ * @param id The ID of the product to update
+ * @param product The new price, quantity and category (the ID is not changed)
+ * @param details The new name and description, or NULL to keep them
  * @return true if successful, false otherwise
  */
-bool addProduct();
+bool updateProduct(int id, const Product *product, const ProductDetails *details);
 
 /**
- * Search for a product by ID
- * @param id The ID to search for
- * @return true if found, false otherwise
+ * Remove a product
+ * @param id The ID of the product to remove
+ * @return true if successful, false otherwise
+ */
+bool removeProduct(int id);
+
+/**
+ * Update product inventory
+ * The change is written behind: it is saved with other pending changes
+ * by flushProductChanges rather than immediately (completeTransaction
+ * flushes the stock a sale took as soon as the sale is saved)
+ * @param id The ID of the product to update
+ * @param quantity The quantity to add (positive) or remove (negative)
+ * @return true if successful, false otherwise
  */
-bool searchProductById(int id);
+bool updateProductInventory(int id, int quantity);
 
 /**
- * Search for products by name
- * @param name The name (or part of name) to search for
+ * Apply a batch of inventory adjustments
+ * Every adjustment is validated before any is applied, so a batch either
+ * applies in full or not at all; the changes are then saved once, and taken
+ * back again if the save fails
+ * @param adjustments The adjustments (a product may appear more than once)
+ * @param count Number of adjustments
+ * @return true if the batch was applied and saved, false otherwise
  */
-void searchProductsByName(const char *name);
+bool applyInventoryAdjustments(const InventoryAdjustment *adjustments, int count);
 
 /**
- * Search for products by category
- * @param category The category to search for
+ * Read inventory adjustments, one "id,delta" (or "id delta") pair per line
+ * Blank lines, lines starting with # and a header on the first line are skipped
+ * @param input The stream to read
+ * @param adjustments Receives a heap-allocated array the caller must free
+ * @return Number of adjustments read, or -1 if a line could not be parsed
  */
-void searchProductsByCategory(const char *category);
+int readInventoryAdjustments(FILE *input, InventoryAdjustment **adjustments);
 
 /**
- * Display all products
+ * Read a batch of inventory adjustments from a file and apply it
+ * @param path The file to read, or "-" for standard input
+ * @return true if the batch was applied and saved, false otherwise
  */
-void displayAllProducts();
+bool receiveInventoryFromFile(const char *path);
 
 /**
- * Display products filtered by category
- * @param category The category to filter by
+ * Work out the effect of a price rule without changing any product
+ * A price ending of 1 or more is rejected, as it is by applyRepricing
+ * @param rule The price change
+ * @param summary Receives the totals before and after
+ * @return Number of products the rule matches, or -1 if the rule is invalid
  */
-void displayProductsByCategory(const char *category);
+int previewRepricing(const PriceRule *rule, RepricingSummary *summary);
 
 /**
- * Display details for a specific product
- * @param product Pointer to the product to display
+ * Apply a price rule to every matching product and save once
+ * A price ending of 1 or more is rejected, and the prices are taken back if
+ * the save fails
+ * @param rule The price change
+ * @param summary Receives the totals before and after (optional)
+ * @return true if the prices were changed and saved, false otherwise
  */
-void displayProductDetails(const Product *product);
+bool applyRepricing(const PriceRule *rule, RepricingSummary *summary);
 
 /**
- * Edit a product's information
- * @param id The ID of the product to edit
- * @return true if successful, false otherwise
+ * Get a product's name, loading product details on first use
+ * @param index Index of the product in the products array
+ * @return The product name, or an empty string if unavailable
  */
-bool editProduct(int id);
+const char *getProductName(int index);
 
 /**
- * Delete a product
- * @param id The ID of the product to delete
- * @return true if successful, false otherwise
+ * Get a product's description, loading product details on first use
+ * @param index Index of the product in the products array
+ * @return The product description, or an empty string if unavailable
  */
-bool deleteProduct(int id);
+const char *getProductDescription(int index);
 
 /**
- * Update product inventory
- * @param id The ID of the product to update
- * @param quantity The quantity to add (positive) or remove (negative)
- * @return true if successful, false otherwise
+ * Load product names and descriptions if they are not loaded yet
+ * @return true if the details are available, false otherwise
  */
-bool updateProductInventory(int id, int quantity);
+bool loadProductDetails();
+
+/**
+ * Write pending product changes to file
+ * Changed records are overwritten in place. If the file was saved elsewhere in
+ * the meantime, it is read back and the changes re-applied first; the whole
+ * file is rewritten only when products were added, removed or reordered here
+ * @return true if successful (or nothing was pending), false otherwise
+ */
+bool flushProductChanges();
+
+/**
+ * Write pending product changes if the threshold or interval has been reached
+ * Added, removed or reordered products and name or description edits are
+ * always due; only per-record changes (stock, price, category) wait.
+ * Called from the menu loops so changes are not held indefinitely
+ * @return true if nothing needed writing or the write succeeded, false otherwise
+ */
+bool flushProductChangesIfDue();
 
 /**
  * Save product data to file
@@ -95,6 +183,9 @@ bool saveProductData();
 
 /**
  * Load product data from file
+ * Per-record changes not yet written are re-applied to the file's contents:
+ * stock changes are added to the stored quantity, and a changed price or
+ * category replaces the stored one
  * @return true if successful, false otherwise
  */
 bool loadProductData();
@@ -121,11 +212,11 @@ void sortProductsByQuantity();
 
 /**
  * Get product categories
- * @param categories Array to store unique categories
+ * @param categoryIds Array to store the dictionary IDs of unique categories
  * @param maxCategories Maximum number of categories to store
  * @return Number of unique categories found
  */
-int getProductCategories(char categories[][30], int maxCategories);
+int getProductCategories(uint32_t *categoryIds, int maxCategories);
 
 /**
  * Find a product by ID
@@ -142,10 +233,27 @@ int findProductById(int id);
 int findProductByName(const char *name);
 
 /**
- * Check if any products are low in stock
+ * Find the products whose name or description contains a search term (case-insensitive)
+ * @param query The term to search for
+ * @param matches Array of productCount flags, set for every matching product
+ * @return Number of matching products
+ */
+int searchProducts(const char *query, bool *matches);
+
+/**
+ * Find the products in a category
+ * @param category The category name
+ * @param slots Array to store the indexes of the matching products
+ * @return Number of matching products
+ */
+int findProductsByCategory(const char *category, int *slots);
+
+/**
+ * Find the products at or below a stock threshold
  * @param threshold The threshold quantity
- * @return Number of products below the threshold
+ * @param slots Array to store the indexes of the matching products
+ * @return Number of matching products
  */
-int checkLowStock(int threshold);
+int findLowStockProducts(int threshold, int *slots);
 
 #endif /* PRODUCT_H */
\ No newline at end of file
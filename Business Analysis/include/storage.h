@@ -0,0 +1,263 @@
+/**
+ * Storage Header File
+ * Contains the on-disk data file layout and memory-mapped file access
+ * Every data file starts with a fixed 64-byte header followed by its
+ * records, so fixed-size records are aligned in the mapping
+ *
+ * The stores are fixed-capacity arrays that the editors write to, so the
+ * loaders copy (or decode) the records out of the mapping and release it;
+ * nothing points into a mapping after a load returns. Mapping saves the
+ * stdio buffering and the separate read per array, not the copy itself.
+ */
+
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Identifies a data file written by this program ("BAMS")
+#define DATA_FILE_MAGIC 0x534D4142u
+
+// Bumped whenever the header or any record layout changes
+// 1: header and records as first mapped
+// 2: payloads may be stored compressed (storedSize)
+#define DATA_FILE_VERSION 2
+
+// Oldest version this program still reads; versions 1 and 2 differ only in storedSize
+#define DATA_FILE_OLDEST_VERSION 1
+
+// Size of the header; records start at this offset
+#define DATA_FILE_HEADER_SIZE 64
+
+// Record size used for files holding an encoded byte stream
+#define DATA_FILE_ENCODED 0
+
+// Suffix of the journal an in-place update writes before it touches the data file
+#define DATA_FILE_JOURNAL_SUFFIX ".journal"
+
+// Suffix of the lock file held while a process reads, changes and saves a data file
+#define DATA_FILE_LOCK_SUFFIX ".lock"
+
+// How long to wait for another process's lock, and the age at which a lock left by a run that died is broken
+#define DATA_FILE_LOCK_WAIT_MILLISECONDS 2000
+#define DATA_FILE_LOCK_STALE_SECONDS 10
+
+// Header at the start of every data file
+typedef struct {
+    uint32_t magic;             // DATA_FILE_MAGIC
+    uint32_t version;           // DATA_FILE_VERSION
+    uint32_t recordSize;        // Size of one record, or DATA_FILE_ENCODED
+    uint32_t recordCount;       // Number of records
+    uint64_t payloadSize;       // Number of bytes after the header
+    uint64_t generation;        // Incremented on every save
+    uint64_t sourceGeneration;  // Index files: generation of the data file they describe
+    uint64_t storedSize;        // Compressed payload bytes on disk, or 0 if stored as is
+    unsigned char reserved[DATA_FILE_HEADER_SIZE - 48];
+} DataFileHeader;
+
+// A data file mapped read-only into memory
+typedef struct {
+    const DataFileHeader *header;   // Header at the start of the mapping
+    const unsigned char *payload;   // Records following the header
+    size_t payloadSize;             // Number of payload bytes
+    void *decodedPayload;           // Decompressed copy of a compressed payload, or NULL
+    void *base;                     // Start of the mapping
+    size_t size;                    // Size of the mapping
+    void *fileHandle;               // Platform file handle (Windows only)
+    void *mappingHandle;            // Platform mapping handle (Windows only)
+} MappedDataFile;
+
+// What a store last saw of its data file, used to skip reloading unchanged files
+typedef struct {
+    bool valid;                 // false until the file has been loaded or saved
+    long long modified;         // Modification time in nanoseconds
+    long long size;             // File size in bytes
+    unsigned long long inode;   // File identity (each save renames a new file into place)
+    uint64_t generation;        // Generation from the file header
+} DataFileStamp;
+
+/**
+ * Map a data file read-only and validate its header
+ * A compressed payload is decompressed into memory owned by the mapping.
+ * The payload is only valid until unmapDataFile; copy out what must be kept.
+ * @param path The file to map
+ * @param recordSize Expected record size, or DATA_FILE_ENCODED
+ * @param file Receives the mapping
+ * @return true if the file was mapped and its header matches, false otherwise
+ */
+bool mapDataFile(const char *path, uint32_t recordSize, MappedDataFile *file);
+
+/**
+ * Release a mapping created by mapDataFile
+ * @param file The mapping to release
+ */
+void unmapDataFile(MappedDataFile *file);
+
+/**
+ * Write a data file with a fresh header
+ * The file is written under a temporary name (see makeTemporaryPath) and renamed
+ * into place, so processes that still map the old file keep a consistent view. An existing
+ * file that is not a data file or has a version this program does not
+ * understand is reported and left unchanged
+ * @param path The file to write
+ * @param recordSize Size of one record, or DATA_FILE_ENCODED
+ * @param recordCount Number of records
+ * @param payload The bytes following the header
+ * @param payloadSize Number of payload bytes
+ * @return true if successful, false otherwise
+ */
+bool writeDataFile(const char *path, uint32_t recordSize, uint32_t recordCount,
+                   const void *payload, size_t payloadSize);
+
+/**
+ * Write a data file with its payload compressed
+ * Used for files that are rarely rewritten; the payload is stored as is when
+ * compression does not make it smaller
+ * @param path The file to write
+ * @param recordSize Size of one record, or DATA_FILE_ENCODED
+ * @param recordCount Number of records
+ * @param payload The bytes following the header, before compression
+ * @param payloadSize Number of payload bytes before compression
+ * @return true if successful, false otherwise
+ */
+bool writeCompressedDataFile(const char *path, uint32_t recordSize, uint32_t recordCount,
+                             const void *payload, size_t payloadSize);
+
+/**
+ * Build the temporary name a file is written under before it is moved into place
+ * The name includes the process ID, so runs saving the same file at the same
+ * time never write into each other's temporary file
+ * @param path The file's final path
+ * @param temporaryPath Receives the temporary path
+ * @param size Size of the temporaryPath buffer
+ * @return true if the name fit in the buffer, false otherwise
+ */
+bool makeTemporaryPath(const char *path, char *temporaryPath, size_t size);
+
+/**
+ * Move a finished temporary file over its final path, replacing any file there
+ * Readers see either the old file or the whole new one, never a partial write
+ * @param temporaryPath The finished file
+ * @param path Where it belongs
+ * @return true if it was moved, false otherwise (the temporary file is then removed)
+ */
+bool moveFileIntoPlace(const char *temporaryPath, const char *path);
+
+/**
+ * Take the lock file of a data file, waiting while another process holds it
+ * The lock only excludes other runs of this program that lock the same file
+ * around reading, changing and saving it. A lock older than
+ * DATA_FILE_LOCK_STALE_SECONDS is taken to be left by a run that died and is broken
+ * @param path The data file
+ * @return true if the lock was taken, false if it could not be created or the wait ran out
+ */
+bool lockDataFile(const char *path);
+
+/**
+ * Release a lock taken with lockDataFile
+ * @param path The data file
+ */
+void unlockDataFile(const char *path);
+
+/**
+ * Map a file that has no data file header (such as a CSV file) read-only
+ * The whole file is exposed as the payload, and header is NULL
+ * @param path The file to map
+ * @param file Receives the mapping; release it with unmapDataFile
+ * @return true if the file was mapped, false if it could not be opened
+ */
+bool mapTextFile(const char *path, MappedDataFile *file);
+
+/**
+ * Check whether a mapped data file was stored compressed
+ * @param file The mapping
+ * @return true if the payload was decompressed on mapping
+ */
+bool isDataFileCompressed(const MappedDataFile *file);
+
+/**
+ * Copy the records of a fixed-record data file into memory
+ * Records that an in-place update is writing, or was writing when it was cut
+ * short, are taken from its journal, so the copy never holds a torn record
+ * @param path The file to read
+ * @param recordSize Size of one record
+ * @param records Receives the records
+ * @param maxRecords Capacity of the records array
+ * @param recordCount Receives the number of records
+ * @return true if the records were read, false if the file is missing, invalid or too large
+ */
+bool readDataFileRecords(const char *path, uint32_t recordSize, void *records,
+                         uint32_t maxRecords, uint32_t *recordCount);
+
+/**
+ * Overwrite changed records of a fixed-record data file in place and bump its generation
+ * Only the marked records and the header are written; the file must still be the
+ * uncompressed version the caller last saw, with the same number of records.
+ * The records are first written to a journal next to the file, which finishes
+ * the update on the next read or update if this one is cut short
+ * @param path The file to update
+ * @param recordSize Size of one record
+ * @param expectedGeneration Generation the caller last loaded or saved
+ * @param records The caller's full record array, in file order
+ * @param recordCount Number of records in the array and the file
+ * @param dirtyBitmap One bit per record, set for the records to write
+ * @return true if the records were written, false if the file must be rewritten in full
+ */
+bool updateDataFileRecords(const char *path, uint32_t recordSize, uint64_t expectedGeneration,
+                           const void *records, uint32_t recordCount, const uint64_t *dirtyBitmap);
+
+/**
+ * Point an index file at a new generation of its data file, when an in-place
+ * update left the keys the index describes unchanged
+ * @param path The index file
+ * @param oldSourceGeneration Generation the index currently describes
+ * @param newSourceGeneration Generation to describe instead
+ * @return true if the index was updated, false if it was missing or stale
+ */
+bool updateIndexFileSource(const char *path, uint64_t oldSourceGeneration, uint64_t newSourceGeneration);
+
+/**
+ * Write an index file derived from a data file
+ * @param path The file to write
+ * @param sourceGeneration Generation of the data file the index was built from
+ * @param recordSize Size of one record
+ * @param recordCount Number of records
+ * @param payload The bytes following the header
+ * @param payloadSize Number of payload bytes
+ * @return true if successful, false otherwise (including an unknown existing file)
+ */
+bool writeIndexFile(const char *path, uint64_t sourceGeneration, uint32_t recordSize,
+                    uint32_t recordCount, const void *payload, size_t payloadSize);
+
+/**
+ * Read the generation number stored in a data file's header
+ * @param path The file to inspect
+ * @return The generation, or 0 if the file is missing or invalid
+ */
+uint64_t readDataFileGeneration(const char *path);
+
+/**
+ * Record the current state of a data file after loading or saving it
+ * @param path The data file
+ * @param stamp Receives the file's current state
+ */
+void stampDataFile(const char *path, DataFileStamp *stamp);
+
+/**
+ * Forget a stamp so the next load reads the file again
+ * @param stamp The stamp to clear
+ */
+void invalidateDataFileStamp(DataFileStamp *stamp);
+
+/**
+ * Check whether a data file is unchanged since it was stamped
+ * Both the file's stat and the generation in its header must match
+ * @param path The data file
+ * @param stamp The stamp recorded at the last load or save
+ * @return true if the in-memory copy is still current, false if it must be reloaded
+ */
+bool isDataFileCurrent(const char *path, const DataFileStamp *stamp);
+
+#endif /* STORAGE_H */
\ No newline at end of file
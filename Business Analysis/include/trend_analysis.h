@@ -8,10 +8,36 @@
 
 #include <stdbool.h>
 
-/**
- * Run the trend analysis module
- */
-void runTrendAnalysis();
+// Number of quantile buckets used for RFM scoring (1 = lowest, RFM_SCORE_BUCKETS = highest)
+#define RFM_SCORE_BUCKETS 5
+
+// Recency, frequency and monetary (RFM) summary for a customer
+typedef struct {
+    int customerId;          // ID of the customer
+    int recencyDays;         // Days since the last completed purchase (-1 if none)
+    int frequency;           // Number of completed purchases
+    double monetary;         // Total amount spent on completed purchases
+    int recencyScore;        // Recency quantile score (higher is more recent)
+    int frequencyScore;      // Frequency quantile score (higher is more frequent)
+    int monetaryScore;       // Monetary quantile score (higher is more spent)
+    const char *segment;     // Segment name derived from the scores
+} CustomerRFM;
+
+// Customers and spending of one RFM segment
+typedef struct {
+    const char *segment;     // Segment name
+    int customerCount;       // Number of customers in the segment
+    double monetary;         // Total they spent on completed purchases
+} SegmentSummary;
+
+// Result of the sales forecast report (monthly figures)
+typedef struct {
+    int months;              // Number of months forecast
+    double revenue;          // Forecasted monthly revenue
+    double expenses;         // Forecasted monthly expenses
+    double profit;           // Forecasted monthly profit
+    double profitMargin;     // Profit as a percentage of revenue
+} SalesForecast;
 
 /**
  * Generate sales trend data for visualization
@@ -69,16 +95,6 @@ bool generateExpenseTrend(const char *category, const char *startDate, const cha
  */
 bool exportTrendData(const char *trendType, const char *filename);
 
-/**
- * Show sales graph using Python script
- * @param dataFile Path to CSV data file
- * @param title Title for the graph
- * @param xLabel Label for x-axis
- * @param yLabel Label for y-axis
- * @return true if successful, false otherwise
- */
-bool showSalesGraph(const char *dataFile, const char *title, const char *xLabel, const char *yLabel);
-
 /**
  * Calculate revenue forecast
  * @param months Number of months to forecast
@@ -101,9 +117,47 @@ double calculateExpenseForecast(int months);
 double calculateProfitForecast(int months);
 
 /**
- * Generate sales forecast report
+ * Compute the sales forecast report
  * @param months Number of months to forecast
+ * @param forecast Receives the result
+ */
+void buildSalesForecast(int months, SalesForecast *forecast);
+
+/**
+ * Export a sales forecast computed by buildSalesForecast to a CSV file
+ * @param filename The file to create, or "-" for standard output
+ * @param forecast The result to export
+ * @return true if successful, false otherwise
+ */
+bool exportSalesForecastCsv(const char *filename, const SalesForecast *forecast);
+
+/**
+ * Calculate RFM scores for every customer
+ * Transactions are joined to customers by customer ID in a single pass and
+ * each metric is then bucketed into quantiles
+ * @param results Array to store one entry per customer (in customer order)
+ * @param maxResults Maximum number of entries to store
+ * @param referenceDate Date recency is measured from (NULL or empty for today)
+ * @return Number of customers scored, or -1 if there was not enough memory
+ */
+int calculateCustomerRFM(CustomerRFM *results, int maxResults, const char *referenceDate);
+
+/**
+ * Total the customers and spending of each RFM segment
+ * @param results Scores from calculateCustomerRFM
+ * @param count Number of scored customers
+ * @param summaries Array of at least count entries, filled in order of first appearance
+ * @return Number of segments
+ */
+int summarizeCustomerSegments(const CustomerRFM *results, int count, SegmentSummary *summaries);
+
+/**
+ * Export customer RFM scores and segments to a CSV file
+ * @param filename The file to create, or "-" for standard output
+ * @param results Scores from calculateCustomerRFM (in customer order)
+ * @param count Number of scored customers
+ * @return true if successful, false otherwise
  */
-void generateSalesForecastReport(int months);
+bool exportCustomerSegmentsCsv(const char *filename, const CustomerRFM *results, int count);
 
 #endif /* TREND_ANALYSIS_H */
\ No newline at end of file
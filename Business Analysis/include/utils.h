@@ -22,8 +22,16 @@
 // File path constants
 #define CUSTOMER_FILE "data/customers.dat"
 #define PRODUCT_FILE "data/products.dat"
-#define TRANSACTION_FILE "data/transactions.dat"
+#define PRODUCT_DETAILS_FILE "data/product_details.dat"
+#define PRODUCT_INDEX_FILE "data/products_id.idx"
+#define TRANSACTION_FILE "data/transactions.dat"  // Single-file layout, imported once into partitions
+#define TRANSACTION_MANIFEST_FILE "data/transactions_manifest.dat"
+#define TRANSACTION_PARTITION_FILE "data/transactions_%s.dat"  // Formatted with the partition month
+#define TRANSACTION_ID_INDEX_FILE "data/transactions_id.idx"
+#define TRANSACTION_DATE_INDEX_FILE "data/transactions_date.idx"
 #define FINANCIAL_FILE "data/financial.dat"
+#define DICTIONARY_FILE "data/dictionary.dat"
+#define EXPORT_WATERMARK_FILE "data/export_%s.dat"  // Formatted with the consumer name
 #define SALES_DATA_CSV "data/sales_data.csv"
 
 // Maximum array sizes
@@ -39,6 +47,15 @@
 #define ERROR_DUPLICATE_ID 4
 #define ERROR_ID_NOT_FOUND 5
 
+// Kind of message passed to a message handler
+typedef enum {
+    MESSAGE_ERROR,
+    MESSAGE_SUCCESS
+} MessageKind;
+
+// Function that receives error and success messages in place of the terminal
+typedef void (*MessageHandler)(MessageKind kind, const char *message);
+
 /**
  * Clear the console screen
  */
@@ -83,13 +100,20 @@ bool fileExists(const char *filename);
 bool createDirectory(const char *directoryName);
 
 /**
- * Display an error message
+ * Send error and success messages to a handler instead of printing them,
+ * for programs that link the core modules without the menus
+ * @param handler The function to receive messages, or NULL to print them again
+ */
+void setMessageHandler(MessageHandler handler);
+
+/**
+ * Display an error message, or pass it to the message handler if one is set
  * @param message The error message to display
  */
 void displayError(const char *message);
 
 /**
- * Display a success message
+ * Display a success message, or pass it to the message handler if one is set
  * @param message The success message to display
  */
 void displaySuccess(const char *message);
@@ -109,6 +133,38 @@ void generateUniqueId(const char *prefix, char *idBuffer, size_t bufferSize);
  */
 void getCurrentDateTime(char *buffer, size_t bufferSize);
 
+/**
+ * Convert a date string (YYYY-MM-DD, optionally followed by a time) to a day number
+ * @param date The date string to convert
+ * @return Number of days since 1970-01-01, or -1 if the date is invalid
+ */
+int dateToDayNumber(const char *date);
+
+/**
+ * Check whether a string contains a lowercase substring, ignoring case
+ * @param text The string to search in
+ * @param loweredQuery The substring to search for (already lowercase)
+ * @return true if the substring is found, false otherwise
+ */
+bool containsIgnoreCase(const char *text, const char *loweredQuery);
+
+/**
+ * Encode an unsigned integer as a variable-length integer (7 bits per byte)
+ * @param value The value to encode
+ * @param buffer The buffer to store the encoded bytes (at least 5 bytes)
+ * @return The number of bytes written
+ */
+size_t encodeVarint(unsigned int value, unsigned char *buffer);
+
+/**
+ * Decode a variable-length integer
+ * @param position Pointer to the first encoded byte
+ * @param end Pointer one past the last readable byte
+ * @param value Pointer to store the decoded value
+ * @return Pointer to the byte after the decoded value, or NULL if the input is truncated
+ */
+const unsigned char *decodeVarint(const unsigned char *position, const unsigned char *end, unsigned int *value);
+
 /**
  * Encrypt a string (basic encryption for demonstration)
  * @param input The input string to encrypt
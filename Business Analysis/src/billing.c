@@ -7,6 +7,12 @@
 #include "product.h"
 #include "customer.h"
 #include "utils.h"
+#include "index.h"
+#include "storage.h"
+#include "lookup.h"
+#include "csv_writer.h"
+#include "json_writer.h"
+#include "columnar.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,164 +28,304 @@ extern int transactionCount;
 Transaction currentTransaction;
 bool hasCurrentTransaction = false;
 
-// Function to run the billing system module
-void runBillingSystem() {
-    int choice;
-    bool running = true;
+// State of the transaction manifest at the last load or save
+static DataFileStamp transactionFileStamp;
 
-    // Load transaction data
-    loadTransactionData();
+// One monthly partition: its manifest entry and the state of its file
+typedef struct {
+    TransactionPartitionInfo info;
+    bool dirty;         // The file needs rewriting
+    bool compressed;    // The file is stored compressed
+    bool damaged;       // The file did not load cleanly, so it is kept until a sale lands in it
+    TransactionPartitionInfo listed;  // The manifest entry of a damaged file, written back unchanged
+} TransactionPartition;
 
-    // Initialize current transaction
-    memset(&currentTransaction, 0, sizeof(Transaction));
-    hasCurrentTransaction = false;
-
-    while (running) {
-        clearScreen();
-        printf("\n\033[1;36m========================================\033[0m\n");
-        printf("\033[1;32m            BILLING SYSTEM\033[0m\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("1. Create New Bill\n");
-        printf("2. View Current Bill\n");
-        printf("3. Add Item to Bill\n");
-        printf("4. Remove Item from Bill\n");
-        printf("5. Complete Transaction\n");
-        printf("6. Transaction History\n");
-        printf("7. Generate Sales Report\n");
-        printf("8. Back to Main Menu\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        clearInputBuffer();
-
-        switch (choice) {
-            case 1:
-                createTransaction();
-                pressEnterToContinue();
-                break;
-            case 2:
-                if (hasCurrentTransaction) {
-                    printf("\n\033[1;36m========================================\033[0m\n");
-                    printf("\033[1;32m           CURRENT BILL\033[0m\n");
-                    printf("\033[1;36m========================================\033[0m\n");
-                    printf("Items:\n");
-                    
-                    for (int i = 0; i < currentTransaction.itemCount; i++) {
-                        printf("%d. %s - %d x $%.2f = $%.2f\n", 
-                               i + 1,
-                               currentTransaction.items[i].name, 
-                               currentTransaction.items[i].quantity,
-                               currentTransaction.items[i].price,
-                               currentTransaction.items[i].subtotal);
-                    }
-                    
-                    printf("\nTotal: $%.2f\n", calculateTransactionTotal());
-                } else {
-                    printf("No active transaction. Create a new bill first.\n");
-                }
-                pressEnterToContinue();
-                break;
-            case 3:
-                if (hasCurrentTransaction) {
-                    int productId, quantity;
-                    printf("Enter product ID: ");
-                    scanf("%d", &productId);
-                    clearInputBuffer();
-                    
-                    printf("Enter quantity: ");
-                    scanf("%d", &quantity);
-                    clearInputBuffer();
-                    
-                    if (addItemToTransaction(productId, quantity)) {
-                        printf("Item added to transaction.\n");
-                    }
-                } else {
-                    printf("No active transaction. Create a new bill first.\n");
-                }
-                pressEnterToContinue();
-                break;
-            case 4:
-                if (hasCurrentTransaction && currentTransaction.itemCount > 0) {
-                    int index;
-                    printf("Enter item number to remove (1-%d): ", currentTransaction.itemCount);
-                    scanf("%d", &index);
-                    clearInputBuffer();
-                    
-                    if (removeItemFromTransaction(index - 1)) {
-                        printf("Item removed from transaction.\n");
-                    } else {
-                        printf("Invalid item number.\n");
-                    }
-                } else {
-                    printf("No items in the current transaction.\n");
-                }
-                pressEnterToContinue();
-                break;
-            case 5:
-                if (hasCurrentTransaction && currentTransaction.itemCount > 0) {
-                    char customerId[20];
-                    char paymentMethod[20];
-                    
-                    printf("Enter customer ID (leave blank for anonymous): ");
-                    fgets(customerId, sizeof(customerId), stdin);
-                    customerId[strcspn(customerId, "\n")] = 0;
-                    
-                    printf("Enter payment method (Cash, Credit Card, Debit Card, etc.): ");
-                    fgets(paymentMethod, sizeof(paymentMethod), stdin);
-                    paymentMethod[strcspn(paymentMethod, "\n")] = 0;
-                    
-                    if (completeTransaction(customerId, paymentMethod)) {
-                        char receipt[2000];
-                        generateReceipt(&transactions[transactionCount - 1], receipt, sizeof(receipt));
-                        
-                        printf("\n%s\n", receipt);
-                        printf("\nTransaction completed successfully!\n");
-                        
-                        // Reset current transaction
-                        memset(&currentTransaction, 0, sizeof(Transaction));
-                        hasCurrentTransaction = false;
-                    }
-                } else {
-                    printf("No items in the current transaction.\n");
-                }
-                pressEnterToContinue();
-                break;
-            case 6:
-                displayTransactionHistory(NULL, NULL, NULL);
-                pressEnterToContinue();
-                break;
-            case 7: {
-                char startDate[20], endDate[20];
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                generateSalesReport(startDate, endDate);
-                pressEnterToContinue();
-                break;
-            }
-            case 8:
-                running = false;
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-                pressEnterToContinue();
+// Partitions in month order, and the transaction slots grouped by partition in the same order
+static TransactionPartition transactionPartitions[MAX_TRANSACTION_PARTITIONS];
+static int transactionPartitionCount = 0;
+static int partitionSlots[MAX_ARRAY_SIZE];
+static int partitionSlotCount = 0;
+
+// Some listed files or transactions have no partition, so saving the manifest would drop them
+static bool transactionPartitionsOverflowed = false;
+
+// Transaction ID (hashed) and day number to slot tables, persisted next to the manifest
+static LookupTable transactionIdLookup;
+static LookupTable transactionDateLookup;
+
+// Function to hash a transaction ID for the ID lookup (FNV-1a)
+static int32_t hashTransactionId(const char *transactionId) {
+    uint32_t hash = 2166136261u;
+    
+    for (; *transactionId; transactionId++) {
+        hash ^= (unsigned char)*transactionId;
+        hash *= 16777619u;
+    }
+    
+    return (int32_t)hash;
+}
+
+// Function to rebuild both transaction lookups from the transactions array
+static void rebuildTransactionLookups() {
+    clearLookupTable(&transactionIdLookup);
+    clearLookupTable(&transactionDateLookup);
+    
+    for (int i = 0; i < transactionCount; i++) {
+        if (!appendLookupEntry(&transactionIdLookup, hashTransactionId(transactions[i].transactionId), i) ||
+            !appendLookupEntry(&transactionDateLookup, dateToDayNumber(transactions[i].date), i)) {
+            invalidateLookupTable(&transactionIdLookup);
+            invalidateLookupTable(&transactionDateLookup);
+            return;
+        }
+    }
+    
+    sortLookupTable(&transactionIdLookup);
+    sortLookupTable(&transactionDateLookup);
+}
+
+// Function to save both transaction lookups stamped with the manifest's generation
+static void saveTransactionLookups() {
+    // A reload places the transactions in partition order, so lookups over any other order would be wrong
+    for (int i = 0; i < partitionSlotCount; i++) {
+        if (partitionSlots[i] != i) {
+            remove(TRANSACTION_ID_INDEX_FILE);
+            remove(TRANSACTION_DATE_INDEX_FILE);
+            return;
         }
     }
+    
+    if (!transactionIdLookup.valid || !transactionDateLookup.valid) {
+        rebuildTransactionLookups();
+    }
+    
+    if (transactionIdLookup.valid && transactionDateLookup.valid) {
+        saveLookupTable(&transactionIdLookup, TRANSACTION_ID_INDEX_FILE, transactionFileStamp.generation);
+        saveLookupTable(&transactionDateLookup, TRANSACTION_DATE_INDEX_FILE, transactionFileStamp.generation);
+    }
+}
+
+// Function to get the partition month (YYYY-MM) of a transaction date
+static void getPartitionMonth(const char *date, char *month) {
+    if (dateToDayNumber(date) == -1) {
+        strcpy(month, "0000-00");
+    } else {
+        memcpy(month, date, 7);
+        month[7] = '\0';
+    }
+}
+
+// Function to build the file path of a partition month
+static bool getPartitionPath(const char *partitionMonth, char *path, size_t size) {
+    char month[8];
+    
+    memcpy(month, partitionMonth, sizeof(month));
+    month[sizeof(month) - 1] = '\0';
+    
+    int length = snprintf(path, size, TRANSACTION_PARTITION_FILE, month);
+    return length >= 0 && (size_t)length < size;
+}
+
+// Function to find a month's partition, starting an empty one if there is none
+// The offset receives the number of slots held by the partitions before it; -1 means there is no room
+static int findOrStartPartition(const char *month, int *offset) {
+    int p = 0;
+    int comparison = 1;
+    
+    *offset = 0;
+    while (p < transactionPartitionCount &&
+           (comparison = strcmp(transactionPartitions[p].info.month, month)) < 0) {
+        *offset += transactionPartitions[p].info.count;
+        p++;
+    }
+    
+    if (p == transactionPartitionCount || comparison != 0) {
+        // Damaged files kept in the manifest can take the room a new month would need
+        if (transactionPartitionCount == MAX_TRANSACTION_PARTITIONS) {
+            transactionPartitionsOverflowed = true;
+            return -1;
+        }
+        
+        memmove(&transactionPartitions[p + 1], &transactionPartitions[p],
+                (transactionPartitionCount - p) * sizeof(TransactionPartition));
+        memset(&transactionPartitions[p], 0, sizeof(TransactionPartition));
+        strcpy(transactionPartitions[p].info.month, month);
+        transactionPartitionCount++;
+    }
+    
+    return p;
+}
+
+// Function to add a transaction to its monthly partition
+static void addToPartition(int slot) {
+    const Transaction *transaction = &transactions[slot];
+    char month[8];
+    getPartitionMonth(transaction->date, month);
+    
+    int offset;
+    int p = findOrStartPartition(month, &offset);
+    if (p == -1) {
+        return;
+    }
+    
+    TransactionPartitionInfo *info = &transactionPartitions[p].info;
+    if (info->count == 0) {
+        strcpy(info->minDate, transaction->date);
+        strcpy(info->maxDate, transaction->date);
+    }
+    offset += info->count;
+    
+    // Insert the slot at the end of its partition's group
+    memmove(&partitionSlots[offset + 1], &partitionSlots[offset],
+            (partitionSlotCount - offset) * sizeof(int));
+    partitionSlots[offset] = slot;
+    partitionSlotCount++;
+    
+    if (strcmp(transaction->date, info->minDate) < 0) {
+        strcpy(info->minDate, transaction->date);
+    }
+    if (strcmp(transaction->date, info->maxDate) > 0) {
+        strcpy(info->maxDate, transaction->date);
+    }
+    
+    info->count++;
+    if (transaction->statusId == STRING_ID_COMPLETED) {
+        info->completedCount++;
+        info->completedTotal += transaction->total;
+    }
+    
+    transactionPartitions[p].dirty = true;
+}
+
+// Function to rebuild the partitions from the transactions array
+static void rebuildTransactionPartitions() {
+    transactionPartitionCount = 0;
+    partitionSlotCount = 0;
+    
+    for (int i = 0; i < transactionCount; i++) {
+        addToPartition(i);
+    }
+    
+    for (int p = 0; p < transactionPartitionCount; p++) {
+        transactionPartitions[p].dirty = false;
+    }
+}
+
+// Function to check whether a partition may hold transactions in a date range
+static bool partitionOverlaps(const TransactionPartitionInfo *info, const char *startDate, const char *endDate) {
+    if (startDate && strlen(startDate) > 0 && strcmp(info->maxDate, startDate) < 0) {
+        return false;
+    }
+    
+    if (endDate && strlen(endDate) > 0 && strcmp(info->minDate, endDate) > 0) {
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to check whether every transaction in a partition falls in a date range
+static bool partitionCovered(const TransactionPartitionInfo *info, const char *startDate, const char *endDate) {
+    if (startDate && strlen(startDate) > 0 && strcmp(info->minDate, startDate) < 0) {
+        return false;
+    }
+    
+    if (endDate && strlen(endDate) > 0 && strcmp(info->maxDate, endDate) > 0) {
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to check whether a transaction falls in a date range (assumes YYYY-MM-DD format)
+static bool transactionInPeriod(const Transaction *transaction, const char *startDate, const char *endDate) {
+    if (startDate && strlen(startDate) > 0 && strcmp(transaction->date, startDate) < 0) {
+        return false;
+    }
+    
+    if (endDate && strlen(endDate) > 0 && strcmp(transaction->date, endDate) > 0) {
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to make room for at least the given number of items in a transaction
+static bool reserveTransactionItems(Transaction *transaction, int capacity) {
+    if (capacity <= transaction->itemCapacity) {
+        return true;
+    }
+    
+    int newCapacity = transaction->itemCapacity > 0 ? transaction->itemCapacity : INITIAL_TRANSACTION_ITEMS;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+    
+    BillingItem *items = realloc(transaction->items, newCapacity * sizeof(BillingItem));
+    if (!items) {
+        return false;
+    }
+    
+    transaction->items = items;
+    transaction->itemCapacity = newCapacity;
+    return true;
+}
+
+// Function to release the items owned by a transaction
+static void freeTransactionItems(Transaction *transaction) {
+    free(transaction->items);
+    transaction->items = NULL;
+    transaction->itemCount = 0;
+    transaction->itemCapacity = 0;
+}
+
+// Function to append a string as a varint length followed by its bytes
+static size_t encodeString(const char *text, unsigned char *buffer) {
+    size_t length = strlen(text);
+    size_t size = encodeVarint((unsigned int)length, buffer);
+    
+    memcpy(buffer + size, text, length);
+    return size + length;
+}
+
+// Function to read a length-prefixed string into a fixed-size field
+static const unsigned char *decodeString(const unsigned char *position, const unsigned char *end,
+                                         char *text, size_t textSize) {
+    unsigned int length;
+    
+    position = decodeVarint(position, end, &length);
+    if (!position || length >= textSize || length > (size_t)(end - position)) {
+        return NULL;
+    }
+    
+    memcpy(text, position, length);
+    text[length] = '\0';
+    return position + length;
+}
+
+// Function to append a double as its raw 8 bytes
+static size_t encodeDouble(double value, unsigned char *buffer) {
+    memcpy(buffer, &value, sizeof(double));
+    return sizeof(double);
+}
+
+// Function to read a double stored as its raw 8 bytes
+static const unsigned char *decodeDouble(const unsigned char *position, const unsigned char *end, double *value) {
+    if ((size_t)(end - position) < sizeof(double)) {
+        return NULL;
+    }
+    
+    memcpy(value, position, sizeof(double));
+    return position + sizeof(double);
 }
 
 // Function to create a new transaction
 bool createTransaction() {
     if (hasCurrentTransaction) {
-        printf("There is already an active transaction. Complete or clear it first.\n");
         return false;
     }
     
-    // Initialize new transaction
+    // Initialize new transaction, dropping any items left from a cleared one
+    freeTransactionItems(&currentTransaction);
     memset(&currentTransaction, 0, sizeof(Transaction));
     
     // Generate unique transaction ID
@@ -192,8 +338,6 @@ bool createTransaction() {
     currentTransaction.total = 0.0;
     
     hasCurrentTransaction = true;
-    
-    printf("New transaction created. Transaction ID: %s\n", currentTransaction.transactionId);
     return true;
 }
 
@@ -204,11 +348,6 @@ bool addItemToTransaction(int productId, int quantity) {
         return false;
     }
     
-    if (currentTransaction.itemCount >= MAX_ITEMS_PER_TRANSACTION) {
-        displayError("Maximum number of items reached for this transaction.");
-        return false;
-    }
-    
     // Load product data
     if (!loadProductData()) {
         displayError("Failed to load product data.");
@@ -243,8 +382,12 @@ bool addItemToTransaction(int productId, int quantity) {
     }
     
     // Add new item to transaction
+    if (!reserveTransactionItems(&currentTransaction, currentTransaction.itemCount + 1)) {
+        displayError("Not enough memory to add the item.");
+        return false;
+    }
+    
     currentTransaction.items[currentTransaction.itemCount].productId = productId;
-    strcpy(currentTransaction.items[currentTransaction.itemCount].name, products[productIndex].name);
     currentTransaction.items[currentTransaction.itemCount].price = products[productIndex].price;
     currentTransaction.items[currentTransaction.itemCount].quantity = quantity;
     currentTransaction.items[currentTransaction.itemCount].subtotal = products[productIndex].price * quantity;
@@ -257,6 +400,17 @@ bool addItemToTransaction(int productId, int quantity) {
     return true;
 }
 
+// Function to get the name of the product a billing item refers to
+const char *getBillingItemName(const BillingItem *item) {
+    int productIndex = findProductById(item->productId);
+    
+    if (productIndex == -1) {
+        return "Unknown Product";
+    }
+    
+    return getProductName(productIndex);
+}
+
 // Function to remove an item from the current transaction
 bool removeItemFromTransaction(int index) {
     if (!hasCurrentTransaction) {
@@ -302,32 +456,86 @@ bool completeTransaction(const char *customerId, const char *paymentMethod) {
         return false;
     }
     
-    // Set customer ID
+    // Set customer ID, resolving a phone number to the customer's ID
     if (customerId && strlen(customerId) > 0) {
-        strcpy(currentTransaction.customerId, customerId);
+        int id;
+        int customerIndex = -1;
+        
+        // A phone number shared by several customers is kept as typed; the caller picks one by ID
+        if (!parseCustomerId(customerId, &id) || findCustomerById(id) == -1) {
+            if (findCustomersByPhone(customerId, &customerIndex, 1) != 1) {
+                customerIndex = -1;
+            }
+        }
+        
+        if (customerIndex != -1) {
+            snprintf(currentTransaction.customerId, sizeof(currentTransaction.customerId), "%d", customers[customerIndex].id);
+        } else {
+            strcpy(currentTransaction.customerId, customerId);
+        }
     } else {
         strcpy(currentTransaction.customerId, "Anonymous");
     }
     
     // Set payment method
     if (paymentMethod && strlen(paymentMethod) > 0) {
-        strcpy(currentTransaction.paymentMethod, paymentMethod);
+        currentTransaction.paymentMethodId = internString(paymentMethod);
     } else {
-        strcpy(currentTransaction.paymentMethod, "Cash");
+        currentTransaction.paymentMethodId = STRING_ID_CASH;
     }
     
     // Calculate total
     currentTransaction.total = calculateTransactionTotal();
     
     // Set status
-    strcpy(currentTransaction.status, "Completed");
+    currentTransaction.statusId = STRING_ID_COMPLETED;
     
     // Add to transactions array
     if (transactionCount < MAX_ARRAY_SIZE) {
         transactions[transactionCount++] = currentTransaction;
         
-        // Save transaction data
-        saveTransactionData();
+        // The stored transaction now owns the item array
+        currentTransaction.items = NULL;
+        currentTransaction.itemCapacity = 0;
+        
+        // Add to the customer and product indexes and the ID and date lookups
+        int slot = transactionCount - 1;
+        indexTransaction(slot);
+        
+        if (!insertLookupEntry(&transactionIdLookup, hashTransactionId(transactions[slot].transactionId), slot) ||
+            !insertLookupEntry(&transactionDateLookup, dateToDayNumber(transactions[slot].date), slot)) {
+            invalidateLookupTable(&transactionIdLookup);
+            invalidateLookupTable(&transactionDateLookup);
+        }
+        
+        addToPartition(slot);
+        
+        // A sale that cannot be saved goes back to being the open transaction, and the
+        // store is reloaded from disk, unless the reload shows the sale did reach the file
+        if (!saveTransactionData()) {
+            currentTransaction.items = transactions[slot].items;
+            currentTransaction.itemCapacity = transactions[slot].itemCapacity;
+            transactions[slot].items = NULL;
+            transactions[slot].itemCapacity = 0;
+            
+            loadTransactionData();
+            if (findTransactionById(currentTransaction.transactionId) == -1) {
+                displayError("Failed to save the transaction. It is still open and can be completed again.");
+                return false;
+            }
+            freeTransactionItems(&currentTransaction);
+        }
+        
+        // The sale is recorded, so it can no longer be completed a second time
+        memset(&currentTransaction, 0, sizeof(Transaction));
+        hasCurrentTransaction = false;
+        
+        // The sale's stock decrements are written now rather than behind, so an
+        // interrupted run cannot keep the sale but lose the stock it took
+        if (!flushProductChanges()) {
+            displayError("Failed to save product data. The sale was recorded, but its stock changes are not saved yet.");
+            return false;
+        }
         
         return true;
     } else {
@@ -336,379 +544,899 @@ bool completeTransaction(const char *customerId, const char *paymentMethod) {
     }
 }
 
-// Function to generate a receipt for a transaction
-void generateReceipt(const Transaction *transaction, char *receipt, size_t bufferSize) {
-    char buffer[bufferSize];
-    int offset = 0;
-    
-    // Add header
-    offset += snprintf(buffer + offset, bufferSize - offset,
-                      "========================================\n"
-                      "           RECEIPT\n"
-                      "========================================\n"
-                      "Transaction ID: %s\n"
-                      "Date: %s\n"
-                      "Customer: %s\n"
-                      "----------------------------------------\n"
-                      "Items:\n",
-                      transaction->transactionId,
-                      transaction->date,
-                      transaction->customerId);
-    
-    // Add items
-    for (int i = 0; i < transaction->itemCount; i++) {
-        offset += snprintf(buffer + offset, bufferSize - offset,
-                          "%d. %s\n   %d x $%.2f = $%.2f\n",
-                          i + 1,
-                          transaction->items[i].name,
-                          transaction->items[i].quantity,
-                          transaction->items[i].price,
-                          transaction->items[i].subtotal);
-    }
-    
-    // Add footer
-    offset += snprintf(buffer + offset, bufferSize - offset,
-                      "----------------------------------------\n"
-                      "Total: $%.2f\n"
-                      "Payment Method: %s\n"
-                      "Status: %s\n"
-                      "========================================\n"
-                      "          Thank You!\n"
-                      "========================================\n",
-                      transaction->total,
-                      transaction->paymentMethod,
-                      transaction->status);
-    
-    // Copy to output buffer
-    strncpy(receipt, buffer, bufferSize);
-    receipt[bufferSize - 1] = '\0';
-}
-
-// Function to display transaction history
-void displayTransactionHistory(const char *startDate, const char *endDate, const char *paymentMethod) {
-    if (transactionCount == 0) {
-        printf("No transaction history available.\n");
-        return;
+// Function to add a batch of finished transactions and save them once
+bool appendTransactions(Transaction *newTransactions, int count) {
+    if (transactionCount + count > MAX_ARRAY_SIZE) {
+        displayError("Transaction database is full. Cannot add more transactions.");
+        return false;
     }
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m        TRANSACTION HISTORY\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("%-20s %-20s %-15s %-10s %s\n", 
-           "Transaction ID", "Date", "Customer", "Total", "Status");
-    printf("--------------------------------------------------------------------------------------------------------\n");
-    
-    for (int i = 0; i < transactionCount; i++) {
-        // Apply filters
-        bool include = true;
+    for (int i = 0; i < count; i++) {
+        int slot = transactionCount++;
+        transactions[slot] = newTransactions[i];
         
-        if (startDate && strlen(startDate) > 0) {
-            // Simple string comparison (assumes YYYY-MM-DD format)
-            if (strcmp(transactions[i].date, startDate) < 0) {
-                include = false;
-            }
-        }
+        // The stored transaction now owns the item array
+        newTransactions[i].items = NULL;
+        newTransactions[i].itemCapacity = 0;
         
-        if (endDate && strlen(endDate) > 0) {
-            // Simple string comparison (assumes YYYY-MM-DD format)
-            if (strcmp(transactions[i].date, endDate) > 0) {
-                include = false;
-            }
+        indexTransaction(slot);
+        
+        if (!insertLookupEntry(&transactionIdLookup, hashTransactionId(transactions[slot].transactionId), slot) ||
+            !insertLookupEntry(&transactionDateLookup, dateToDayNumber(transactions[slot].date), slot)) {
+            invalidateLookupTable(&transactionIdLookup);
+            invalidateLookupTable(&transactionDateLookup);
         }
         
-        if (paymentMethod && strlen(paymentMethod) > 0) {
-            if (strcmp(transactions[i].paymentMethod, paymentMethod) != 0) {
-                include = false;
+        addToPartition(slot);
+    }
+    
+    // A batch that cannot be saved is not kept in memory either; the reload frees its items
+    if (!saveTransactionData()) {
+        loadTransactionData();
+        
+        // Partition files are written before the manifest, so the batch may be in them anyway
+        int found = 0;
+        for (int i = 0; i < count; i++) {
+            if (findTransactionById(newTransactions[i].transactionId) != -1) {
+                found++;
             }
         }
         
-        if (include) {
-            printf("%-20s %-20s %-15s $%-10.2f %s\n", 
-                   transactions[i].transactionId,
-                   transactions[i].date,
-                   transactions[i].customerId,
-                   transactions[i].total,
-                   transactions[i].status);
+        if (found < count) {
+            displayError(found == 0 ? "Failed to save transaction data." :
+                                      "Failed to save transaction data. Some of the transactions were saved.");
+            return false;
         }
     }
     
-    printf("--------------------------------------------------------------------------------------------------------\n");
+    return true;
+}
+
+// Function to format the top of a receipt, returning its length (snprintf rules)
+static int formatReceiptHeader(const Transaction *transaction, char *buffer, size_t size) {
+    return snprintf(buffer, size,
+                    "========================================\n"
+                    "           RECEIPT\n"
+                    "========================================\n"
+                    "Transaction ID: %s\n"
+                    "Date: %s\n"
+                    "Customer: %s\n"
+                    "----------------------------------------\n"
+                    "Items:\n",
+                    transaction->transactionId,
+                    transaction->date,
+                    transaction->customerId);
+}
+    
+// Function to format one item line of a receipt, returning its length (snprintf rules)
+static int formatReceiptItem(const Transaction *transaction, int i, char *buffer, size_t size) {
+    return snprintf(buffer, size,
+                    "%d. %s\n   %d x $%.2f = $%.2f\n",
+                    i + 1,
+                    getBillingItemName(&transaction->items[i]),
+                    transaction->items[i].quantity,
+                    transaction->items[i].price,
+                    transaction->items[i].subtotal);
+}
     
-    // Display transaction details option
-    printf("\nEnter transaction ID to view details (or press Enter to return): ");
-    char transactionId[20];
-    fgets(transactionId, sizeof(transactionId), stdin);
-    transactionId[strcspn(transactionId, "\n")] = 0;
+// Function to format the bottom of a receipt, returning its length (snprintf rules)
+static int formatReceiptFooter(const Transaction *transaction, char *buffer, size_t size) {
+    return snprintf(buffer, size,
+                    "----------------------------------------\n"
+                    "Total: $%.2f\n"
+                    "Payment Method: %s\n"
+                    "Status: %s\n"
+                    "========================================\n"
+                    "          Thank You!\n"
+                    "========================================\n",
+                    transaction->total,
+                    lookupString(transaction->paymentMethodId),
+                    lookupString(transaction->statusId));
+}
+
+// Function to get the buffer size that holds a transaction's whole receipt
+size_t getReceiptSize(const Transaction *transaction) {
+    size_t size = (size_t)formatReceiptHeader(transaction, NULL, 0) +
+                  (size_t)formatReceiptFooter(transaction, NULL, 0) + 1;
     
-    if (strlen(transactionId) > 0) {
-        displayTransactionDetails(transactionId);
+    for (int i = 0; i < transaction->itemCount; i++) {
+        size += (size_t)formatReceiptItem(transaction, i, NULL, 0);
     }
+    
+    return size;
 }
 
-// Function to display transaction details
-bool displayTransactionDetails(const char *transactionId) {
-    int index = findTransactionById(transactionId);
+// Function to generate a receipt for a transaction
+bool generateReceipt(const Transaction *transaction, char *receipt, size_t bufferSize) {
+    size_t offset = 0;
     
-    if (index == -1) {
-        printf("Transaction not found.\n");
+    if (bufferSize == 0) {
         return false;
     }
     
-    char receipt[2000];
-    generateReceipt(&transactions[index], receipt, sizeof(receipt));
+    // Room is kept for the footer and, if items have to be left out, a line saying how many
+    size_t footerLength = (size_t)formatReceiptFooter(transaction, NULL, 0);
+    size_t omittedLength = (size_t)snprintf(NULL, 0, "... %d more item(s) not shown\n", transaction->itemCount);
     
-    printf("\n%s\n", receipt);
+    offset = (size_t)formatReceiptHeader(transaction, receipt, bufferSize);
+    if (offset >= bufferSize) {
+        return false;
+    }
     
-    return true;
+    int shown = 0;
+    while (shown < transaction->itemCount) {
+        size_t lineLength = (size_t)formatReceiptItem(transaction, shown, NULL, 0);
+        size_t reserve = footerLength + (shown < transaction->itemCount - 1 ? omittedLength : 0);
+        
+        if (offset + lineLength + reserve >= bufferSize) {
+            break;
+        }
+        
+        offset += (size_t)formatReceiptItem(transaction, shown, receipt + offset, bufferSize - offset);
+        shown++;
+    }
+    
+    if (shown < transaction->itemCount) {
+        offset += (size_t)snprintf(receipt + offset, bufferSize - offset,
+                                   "... %d more item(s) not shown\n", transaction->itemCount - shown);
+        if (offset >= bufferSize) {
+            return false;
+        }
+    }
+    
+    offset += (size_t)formatReceiptFooter(transaction, receipt + offset, bufferSize - offset);
+    return shown == transaction->itemCount && offset < bufferSize;
 }
 
-// Function to save transaction data to file
-bool saveTransactionData() {
-    FILE *file = fopen(TRANSACTION_FILE, "wb");
+// Function to encode one transaction record, returning the number of bytes written
+static size_t encodeTransaction(const Transaction *transaction, unsigned char *buffer) {
+    // A record is its strings, IDs, total and items, with integers as varints
+    size_t size = 0;
+    
+    size += encodeString(transaction->transactionId, buffer + size);
+    size += encodeString(transaction->date, buffer + size);
+    size += encodeString(transaction->customerId, buffer + size);
+    size += encodeVarint(transaction->paymentMethodId, buffer + size);
+    size += encodeVarint(transaction->statusId, buffer + size);
+    size += encodeDouble(transaction->total, buffer + size);
+    size += encodeVarint((unsigned int)transaction->itemCount, buffer + size);
+    
+    for (int j = 0; j < transaction->itemCount; j++) {
+        size += encodeVarint((unsigned int)transaction->items[j].productId, buffer + size);
+        size += encodeVarint((unsigned int)transaction->items[j].quantity, buffer + size);
+        size += encodeDouble(transaction->items[j].price, buffer + size);
+    }
+    
+    return size;
+}
+
+// Function to write one partition's transactions to its file, compressed if the partition is sealed
+static bool saveTransactionPartition(const TransactionPartitionInfo *info, const int *slots, bool sealed) {
+    // Size the encode buffer for the worst case of every varint at full length
+    size_t capacity = 0;
+    for (int s = 0; s < info->count; s++) {
+        const Transaction *transaction = &transactions[slots[s]];
+        capacity += sizeof(transaction->transactionId) + sizeof(transaction->date) +
+                    sizeof(transaction->customerId) + 8 * 5 + sizeof(double) +
+                    (size_t)transaction->itemCount * (2 * 5 + sizeof(double));
+    }
     
-    if (!file) {
+    unsigned char *buffer = malloc(capacity > 0 ? capacity : 1);
+    if (!buffer) {
         return false;
     }
     
-    // Write the number of transactions
-    fwrite(&transactionCount, sizeof(int), 1, file);
+    size_t size = 0;
+    for (int s = 0; s < info->count; s++) {
+        size += encodeTransaction(&transactions[slots[s]], buffer + size);
+    }
+    
+    char path[64];
+    if (!getPartitionPath(info->month, path, sizeof(path))) {
+        free(buffer);
+        return false;
+    }
     
-    // Write the transaction data
-    fwrite(transactions, sizeof(Transaction), transactionCount, file);
+    bool saved = sealed ? writeCompressedDataFile(path, DATA_FILE_ENCODED, info->count, buffer, size) :
+                          writeDataFile(path, DATA_FILE_ENCODED, info->count, buffer, size);
     
-    fclose(file);
-    return true;
+    free(buffer);
+    return saved;
 }
 
-// Function to load transaction data from file
-bool loadTransactionData() {
-    FILE *file = fopen(TRANSACTION_FILE, "rb");
+// Function to save transaction data to the partition files and manifest
+bool saveTransactionData() {
+    // A manifest without every partition would orphan the files and transactions left out
+    if (transactionPartitionsOverflowed) {
+        return false;
+    }
+    
+    bool saved = true;
+    TransactionPartitionInfo manifest[MAX_TRANSACTION_PARTITIONS];
+    
+    char now[20];
+    char currentMonth[8];
+    getCurrentDateTime(now, sizeof(now));
+    getPartitionMonth(now, currentMonth);
+    
+    // Rewrite only the partitions that changed; older months are left alone
+    for (int p = 0, offset = 0; p < transactionPartitionCount; offset += transactionPartitions[p].info.count, p++) {
+        TransactionPartition *partition = &transactionPartitions[p];
+        
+        // A damaged file is left as it is, with its old manifest entry, until a sale lands in it
+        if (partition->damaged && !partition->dirty) {
+            manifest[p] = partition->listed;
+            continue;
+        }
+        
+        // Months that have ended are sealed, and rewritten once more in compressed form
+        bool sealed = strcmp(partition->info.month, currentMonth) < 0;
+        
+        // Before the rows that did load replace a damaged file, it is kept aside, and put back if the write fails
+        if (partition->damaged) {
+            char path[64];
+            char damagedPath[80];
+            
+            if (!getPartitionPath(partition->info.month, path, sizeof(path)) ||
+                snprintf(damagedPath, sizeof(damagedPath), "%s%s", path, DAMAGED_PARTITION_SUFFIX) >= (int)sizeof(damagedPath) ||
+                rename(path, damagedPath) != 0) {
+                manifest[p] = partition->listed;
+                saved = false;
+                continue;
+            }
+            
+            if (!saveTransactionPartition(&partition->info, &partitionSlots[offset], sealed)) {
+                rename(damagedPath, path);
+                manifest[p] = partition->listed;
+                saved = false;
+                continue;
+            }
+            
+            char message[256];
+            snprintf(message, sizeof(message), "Some transactions in %s could not be read; the original was kept as %s.",
+                     path, damagedPath);
+            displayError(message);
+            
+            partition->damaged = false;
+            partition->dirty = false;
+            partition->compressed = sealed;
+        }
+        
+        if (partition->dirty || (sealed && !partition->compressed)) {
+            if (saveTransactionPartition(&partition->info, &partitionSlots[offset], sealed)) {
+                partition->dirty = false;
+                partition->compressed = sealed;
+            } else {
+                saved = false;
+            }
+        }
+        
+        manifest[p] = partition->info;
+    }
+    
+    // The manifest is written last, so it never lists a partition that was not saved
+    saved = saved && writeDataFile(TRANSACTION_MANIFEST_FILE, sizeof(TransactionPartitionInfo),
+                                   transactionPartitionCount, manifest,
+                                   transactionPartitionCount * sizeof(TransactionPartitionInfo));
+    
+    // Our own save does not make the in-memory copy stale
+    if (saved) {
+        stampDataFile(TRANSACTION_MANIFEST_FILE, &transactionFileStamp);
+        saveTransactionLookups();
+    } else {
+        invalidateDataFileStamp(&transactionFileStamp);
+    }
     
-    if (!file) {
-        transactionCount = 0;
+    return saved;
+}
+
+// Function to decode one transaction record
+static const unsigned char *decodeTransaction(const unsigned char *position, const unsigned char *end,
+                                              Transaction *transaction) {
+    unsigned int value;
+    
+    memset(transaction, 0, sizeof(Transaction));
+    
+    position = decodeString(position, end, transaction->transactionId, sizeof(transaction->transactionId));
+    if (position) position = decodeString(position, end, transaction->date, sizeof(transaction->date));
+    if (position) position = decodeString(position, end, transaction->customerId, sizeof(transaction->customerId));
+    if (position) position = decodeVarint(position, end, &transaction->paymentMethodId);
+    if (position) position = decodeVarint(position, end, &transaction->statusId);
+    if (position) position = decodeDouble(position, end, &transaction->total);
+    if (position) position = decodeVarint(position, end, &value);
+    
+    // Every item takes at least 10 bytes, which bounds a corrupt count
+    if (!position || value > (size_t)(end - position) / 10) {
+        return NULL;
+    }
+    
+    if (value > 0 && !reserveTransactionItems(transaction, (int)value)) {
+        return NULL;
+    }
+    
+    for (unsigned int j = 0; j < value; j++) {
+        BillingItem *item = &transaction->items[j];
+        unsigned int productId, quantity;
+        
+        position = decodeVarint(position, end, &productId);
+        if (position) position = decodeVarint(position, end, &quantity);
+        if (position) position = decodeDouble(position, end, &item->price);
+        
+        if (!position) {
+            freeTransactionItems(transaction);
+            return NULL;
+        }
+        
+        item->productId = (int)productId;
+        item->quantity = (int)quantity;
+        item->subtotal = item->price * item->quantity;
+        transaction->itemCount++;
+    }
+    
+    return position;
+}
+
+// Function to append the transactions stored in one data file to the transactions array
+static bool loadTransactionFile(const char *path, bool *compressed) {
+    MappedDataFile file;
+    
+    if (!mapDataFile(path, DATA_FILE_ENCODED, &file)) {
         return false;
     }
     
-    // Read the number of transactions
-    fread(&transactionCount, sizeof(int), 1, file);
+    *compressed = isDataFileCompressed(&file);
     
-    // Check if the number of transactions is valid
-    if (transactionCount < 0 || transactionCount > MAX_ARRAY_SIZE) {
-        transactionCount = 0;
-        fclose(file);
+    // Check if the number of transactions fits
+    if (file.header->recordCount > (uint32_t)(MAX_ARRAY_SIZE - transactionCount)) {
+        unmapDataFile(&file);
         return false;
     }
     
-    // Read the transaction data
-    fread(transactions, sizeof(Transaction), transactionCount, file);
+    // Decode the records directly from the mapping (or its decompressed copy)
+    const unsigned char *position = file.payload;
+    const unsigned char *end = file.payload + file.payloadSize;
+    int storedCount = (int)file.header->recordCount;
+    int decoded = 0;
     
-    fclose(file);
-    return true;
+    for (; decoded < storedCount; decoded++) {
+        position = decodeTransaction(position, end, &transactions[transactionCount]);
+        if (!position) {
+            break;
+        }
+        transactionCount++;
+    }
+    
+    unmapDataFile(&file);
+    return decoded == storedCount;
+}
+
+// Function to load transaction data from the partition files
+bool loadTransactionData() {
+    // Nothing to do if the manifest has not changed since it was last read or written
+    if (isDataFileCurrent(TRANSACTION_MANIFEST_FILE, &transactionFileStamp)) {
+        return true;
+    }
+    
+    invalidateDataFileStamp(&transactionFileStamp);
+    
+    // Release the items of the transactions being replaced
+    for (int i = 0; i < transactionCount; i++) {
+        freeTransactionItems(&transactions[i]);
+    }
+    transactionCount = 0;
+    
+    bool loaded = true;
+    bool imported = false;
+    bool compressed = false;
+    
+    // What each partition listed in the manifest looked like on disk
+    TransactionPartitionInfo listedInfo[MAX_TRANSACTION_PARTITIONS];
+    bool listedFailed[MAX_TRANSACTION_PARTITIONS];
+    bool listedCompressed[MAX_TRANSACTION_PARTITIONS];
+    int listedCount = 0;
+    MappedDataFile file;
+    
+    transactionPartitionsOverflowed = false;
+    
+    if (mapDataFile(TRANSACTION_MANIFEST_FILE, sizeof(TransactionPartitionInfo), &file)) {
+        const TransactionPartitionInfo *manifest = (const TransactionPartitionInfo *)file.payload;
+        int partitionCount = (int)file.header->recordCount;
+        
+        if (partitionCount > MAX_TRANSACTION_PARTITIONS) {
+            partitionCount = MAX_TRANSACTION_PARTITIONS;
+            transactionPartitionsOverflowed = true;
+            loaded = false;
+        }
+        
+        // Load every listed partition in month order
+        for (int p = 0; p < partitionCount; p++) {
+            char path[64];
+            
+            listedInfo[listedCount] = manifest[p];
+            listedInfo[listedCount].month[sizeof(listedInfo[listedCount].month) - 1] = '\0';
+            
+            compressed = false;
+            listedFailed[listedCount] = !getPartitionPath(listedInfo[listedCount].month, path, sizeof(path)) ||
+                                        !loadTransactionFile(path, &compressed);
+            listedCompressed[listedCount] = compressed;
+            
+            if (listedFailed[listedCount]) {
+                loaded = false;
+            }
+            listedCount++;
+        }
+        
+        unmapDataFile(&file);
+    } else if (loadTransactionFile(TRANSACTION_FILE, &compressed)) {
+        // A single-file store from an older version is split into partitions below
+        imported = true;
+    } else {
+        loaded = false;
+    }
+    
+    // Partition totals are recomputed from the rows rather than trusted from the manifest
+    rebuildTransactionPartitions();
+    
+    // Carry over the state of each listed file; one that did not load cleanly stays listed and untouched
+    for (int f = 0; f < listedCount; f++) {
+        int offset;
+        int p = findOrStartPartition(listedInfo[f].month, &offset);
+        if (p == -1) {
+            loaded = false;
+            continue;
+        }
+        
+        transactionPartitions[p].compressed = listedCompressed[f];
+        if (listedFailed[f]) {
+            transactionPartitions[p].damaged = true;
+            transactionPartitions[p].listed = listedInfo[f];
+        }
+    }
+    
+    if (imported) {
+        for (int p = 0; p < transactionPartitionCount; p++) {
+            transactionPartitions[p].dirty = true;
+        }
+        
+        // The old file is only removed once the partitions are safely written
+        if (saveTransactionData()) {
+            remove(TRANSACTION_FILE);
+        }
+    } else if (loaded) {
+        stampDataFile(TRANSACTION_MANIFEST_FILE, &transactionFileStamp);
+    }
+    
+    // Reuse the saved ID and date lookups if they were built from this version of the manifest
+    bool lookupsCurrent = loaded && transactionFileStamp.valid &&
+        loadLookupTable(&transactionIdLookup, TRANSACTION_ID_INDEX_FILE, transactionFileStamp.generation) &&
+        loadLookupTable(&transactionDateLookup, TRANSACTION_DATE_INDEX_FILE, transactionFileStamp.generation) &&
+        transactionIdLookup.count == transactionCount && transactionDateLookup.count == transactionCount;
+    
+    if (!lookupsCurrent) {
+        rebuildTransactionLookups();
+        if (loaded && transactionFileStamp.valid) {
+            saveTransactionLookups();
+        }
+    }
+    
+    // Rebuild the customer and product indexes
+    rebuildTransactionIndexes();
+    return loaded;
 }
 
 // Function to find a transaction by ID
 int findTransactionById(const char *transactionId) {
-    for (int i = 0; i < transactionCount; i++) {
-        if (strcmp(transactions[i].transactionId, transactionId) == 0) {
-            return i;
+    if (!transactionIdLookup.valid) {
+        rebuildTransactionLookups();
+    }
+    
+    // Fall back to a scan if the lookup could not be built
+    if (!transactionIdLookup.valid) {
+        for (int i = 0; i < transactionCount; i++) {
+            if (strcmp(transactions[i].transactionId, transactionId) == 0) {
+                return i;
+            }
+        }
+        
+        return -1; // Not found
+    }
+    
+    // Several IDs can share a hash, so compare the candidates
+    int32_t hash = hashTransactionId(transactionId);
+    for (int i = findLookupLowerBound(&transactionIdLookup, hash);
+         i < transactionIdLookup.count && transactionIdLookup.entries[i].key == hash; i++) {
+        int slot = transactionIdLookup.entries[i].slot;
+        
+        if (strcmp(transactions[slot].transactionId, transactionId) == 0) {
+            return slot;
         }
     }
     
     return -1; // Not found
 }
 
+// Function to find the transactions dated within a range of days
+int findTransactionsByDate(const char *startDate, const char *endDate, int *slots, int maxSlots) {
+    int count = 0;
+    
+    if (!transactionDateLookup.valid) {
+        rebuildTransactionLookups();
+    }
+    
+    if (!transactionDateLookup.valid) {
+        for (int i = 0; i < transactionCount && count < maxSlots; i++) {
+            slots[count++] = i;
+        }
+        return count;
+    }
+    
+    int firstDay = (startDate && strlen(startDate) > 0) ? dateToDayNumber(startDate) : INT32_MIN;
+    int lastDay = (endDate && strlen(endDate) > 0) ? dateToDayNumber(endDate) : INT32_MAX;
+    
+    // An unparseable bound cannot narrow the range
+    if (firstDay == -1) {
+        firstDay = INT32_MIN;
+    }
+    if (lastDay == -1) {
+        lastDay = INT32_MAX;
+    }
+    
+    // Transactions with unparseable dates (day -1) are always candidates
+    if (firstDay > -1) {
+        for (int i = findLookupLowerBound(&transactionDateLookup, -1);
+             i < transactionDateLookup.count && transactionDateLookup.entries[i].key == -1 && count < maxSlots; i++) {
+            slots[count++] = transactionDateLookup.entries[i].slot;
+        }
+    }
+    
+    for (int i = findLookupLowerBound(&transactionDateLookup, firstDay);
+         i < transactionDateLookup.count && transactionDateLookup.entries[i].key <= lastDay && count < maxSlots; i++) {
+        slots[count++] = transactionDateLookup.entries[i].slot;
+    }
+    
+    return count;
+}
+
 // Function to calculate total sales for a given period
 double calculateTotalSales(const char *startDate, const char *endDate) {
     double total = 0.0;
     
-    for (int i = 0; i < transactionCount; i++) {
-        // Apply date filters
-        bool include = true;
+    // Only visit the partitions whose months overlap the period
+    for (int p = 0, offset = 0; p < transactionPartitionCount; offset += transactionPartitions[p].info.count, p++) {
+        const TransactionPartitionInfo *info = &transactionPartitions[p].info;
         
-        if (startDate && strlen(startDate) > 0) {
-            // Simple string comparison (assumes YYYY-MM-DD format)
-            if (strcmp(transactions[i].date, startDate) < 0) {
-                include = false;
-            }
+        if (!partitionOverlaps(info, startDate, endDate)) {
+            continue;
         }
         
-        if (endDate && strlen(endDate) > 0) {
-            // Simple string comparison (assumes YYYY-MM-DD format)
-            if (strcmp(transactions[i].date, endDate) > 0) {
-                include = false;
-            }
+        // A month entirely inside the period is answered from its partition total
+        if (partitionCovered(info, startDate, endDate)) {
+            total += info->completedTotal;
+            continue;
         }
         
-        if (include && strcmp(transactions[i].status, "Completed") == 0) {
-            total += transactions[i].total;
+        for (int s = offset; s < offset + info->count; s++) {
+            int i = partitionSlots[s];
+            
+            if (transactionInPeriod(&transactions[i], startDate, endDate) &&
+                transactions[i].statusId == STRING_ID_COMPLETED) {
+                total += transactions[i].total;
+            }
         }
     }
     
     return total;
 }
 
-// Function to generate a sales report for a given period
-void generateSalesReport(const char *startDate, const char *endDate) {
-    if (transactionCount == 0) {
-        printf("No transaction data available for report.\n");
-        return;
-    }
-    
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           SALES REPORT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("Period: %s to %s\n\n", 
-           (startDate && strlen(startDate) > 0) ? startDate : "All time",
-           (endDate && strlen(endDate) > 0) ? endDate : "Present");
-    
+// Function to compute the sales report for a given period
+void buildSalesReport(const char *startDate, const char *endDate, SalesReport *report) {
     // Calculate total sales
-    double totalSales = calculateTotalSales(startDate, endDate);
+    report->totalSales = calculateTotalSales(startDate, endDate);
     
-    // Count transactions in period
-    int transactionCountInPeriod = 0;
-    for (int i = 0; i < transactionCount; i++) {
-        bool include = true;
+    // Count transactions in period, using partition counts for fully covered months
+    report->transactionCount = 0;
+    for (int p = 0, offset = 0; p < transactionPartitionCount; offset += transactionPartitions[p].info.count, p++) {
+        const TransactionPartitionInfo *info = &transactionPartitions[p].info;
         
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(transactions[i].date, startDate) < 0) {
-                include = false;
-            }
+        if (!partitionOverlaps(info, startDate, endDate)) {
+            continue;
         }
         
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(transactions[i].date, endDate) > 0) {
-                include = false;
-            }
+        if (partitionCovered(info, startDate, endDate)) {
+            report->transactionCount += info->completedCount;
+            continue;
         }
         
-        if (include && strcmp(transactions[i].status, "Completed") == 0) {
-            transactionCountInPeriod++;
+        for (int s = offset; s < offset + info->count; s++) {
+            int i = partitionSlots[s];
+            
+            if (transactionInPeriod(&transactions[i], startDate, endDate) &&
+                transactions[i].statusId == STRING_ID_COMPLETED) {
+                report->transactionCount++;
+            }
         }
     }
     
     // Calculate average sale
-    double averageSale = transactionCountInPeriod > 0 ? totalSales / transactionCountInPeriod : 0.0;
-    
-    printf("Total Sales: $%.2f\n", totalSales);
-    printf("Number of Transactions: %d\n", transactionCountInPeriod);
-    printf("Average Sale: $%.2f\n\n", averageSale);
+    report->averageSale = report->transactionCount > 0 ? report->totalSales / report->transactionCount : 0.0;
     
-    // Payment method breakdown
-    printf("Payment Method Breakdown:\n");
-    printf("------------------------\n");
+    // Count by payment method (rows indexed by dictionary ID, listed in order of first use)
+    int rowForMethod[MAX_DICTIONARY_SIZE];
+    report->paymentMethodCount = 0;
     
-    // Count by payment method
-    char paymentMethods[MAX_ARRAY_SIZE][20];
-    int paymentCounts[MAX_ARRAY_SIZE] = {0};
-    double paymentTotals[MAX_ARRAY_SIZE] = {0.0};
-    int methodCount = 0;
+    for (int i = 0; i < MAX_DICTIONARY_SIZE; i++) {
+        rowForMethod[i] = -1;
+    }
     
-    for (int i = 0; i < transactionCount; i++) {
-        bool include = true;
+    for (int p = 0, offset = 0; p < transactionPartitionCount; offset += transactionPartitions[p].info.count, p++) {
+        const TransactionPartitionInfo *info = &transactionPartitions[p].info;
         
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(transactions[i].date, startDate) < 0) {
-                include = false;
-            }
+        if (!partitionOverlaps(info, startDate, endDate)) {
+            continue;
         }
         
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(transactions[i].date, endDate) > 0) {
-                include = false;
+        for (int s = offset; s < offset + info->count; s++) {
+            int i = partitionSlots[s];
+            
+            if (transactionInPeriod(&transactions[i], startDate, endDate) &&
+                transactions[i].statusId == STRING_ID_COMPLETED) {
+                uint32_t methodId = transactions[i].paymentMethodId;
+                
+                if (methodId < MAX_DICTIONARY_SIZE) {
+                    if (rowForMethod[methodId] < 0) {
+                        PaymentMethodTotal *method = &report->paymentMethods[report->paymentMethodCount];
+                        method->paymentMethodId = methodId;
+                        method->transactionCount = 0;
+                        method->total = 0.0;
+                        rowForMethod[methodId] = report->paymentMethodCount++;
+                    }
+                    report->paymentMethods[rowForMethod[methodId]].transactionCount++;
+                    report->paymentMethods[rowForMethod[methodId]].total += transactions[i].total;
+                }
             }
         }
+    }
+    
+    for (int i = 0; i < report->paymentMethodCount; i++) {
+        report->paymentMethods[i].percentage = (report->paymentMethods[i].total / report->totalSales) * 100;
+    }
+}
+
+// Function to find the transactions of a period, optionally paid a given way, in partition order
+int findTransactionHistory(const char *startDate, const char *endDate, const char *paymentMethod, int *slots) {
+    int count = 0;
+    
+    // Resolve the payment method filter once and compare IDs
+    bool filterPaymentMethod = paymentMethod && strlen(paymentMethod) > 0;
+    uint32_t paymentMethodId = filterPaymentMethod ? findStringId(paymentMethod) : INVALID_STRING_ID;
+    
+    // Only visit the partitions whose months overlap the requested range
+    for (int p = 0, offset = 0; p < transactionPartitionCount; offset += transactionPartitions[p].info.count, p++) {
+        const TransactionPartitionInfo *info = &transactionPartitions[p].info;
         
-        if (include && strcmp(transactions[i].status, "Completed") == 0) {
-            // Check if payment method already exists
-            bool methodExists = false;
-            for (int j = 0; j < methodCount; j++) {
-                if (strcmp(paymentMethods[j], transactions[i].paymentMethod) == 0) {
-                    paymentCounts[j]++;
-                    paymentTotals[j] += transactions[i].total;
-                    methodExists = true;
-                    break;
-                }
+        if (!partitionOverlaps(info, startDate, endDate)) {
+            continue;
+        }
+        
+        for (int s = offset; s < offset + info->count; s++) {
+            int i = partitionSlots[s];
+            
+            if (transactionInPeriod(&transactions[i], startDate, endDate) &&
+                (!filterPaymentMethod || transactions[i].paymentMethodId == paymentMethodId)) {
+                slots[count++] = i;
             }
+        }
+    }
+    
+    return count;
+}
+
+// Function to find the completed transactions of a period, in partition order
+static int findSalesInPeriod(const char *startDate, const char *endDate, int *slots) {
+    int count = 0;
+    
+    for (int p = 0, offset = 0; p < transactionPartitionCount; offset += transactionPartitions[p].info.count, p++) {
+        const TransactionPartitionInfo *info = &transactionPartitions[p].info;
+        
+        if (!partitionOverlaps(info, startDate, endDate)) {
+            continue;
+        }
+        
+        for (int s = offset; s < offset + info->count; s++) {
+            int i = partitionSlots[s];
             
-            if (!methodExists && methodCount < MAX_ARRAY_SIZE) {
-                strcpy(paymentMethods[methodCount], transactions[i].paymentMethod);
-                paymentCounts[methodCount] = 1;
-                paymentTotals[methodCount] = transactions[i].total;
-                methodCount++;
+            if (transactionInPeriod(&transactions[i], startDate, endDate) &&
+                transactions[i].statusId == STRING_ID_COMPLETED) {
+                slots[count++] = i;
             }
         }
     }
     
-    for (int i = 0; i < methodCount; i++) {
-        double percentage = (paymentTotals[i] / totalSales) * 100;
-        printf("%s: %d transactions, $%.2f (%.1f%%)\n", 
-               paymentMethods[i], paymentCounts[i], paymentTotals[i], percentage);
+    return count;
+}
+
+// Function to export the sales report and the transactions of the period to a CSV file
+bool exportSalesReportCsv(const char *filename, const char *startDate, const char *endDate,
+                          const SalesReport *report) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, filename)) {
+        return false;
+    }
+    
+    char period[50];
+    snprintf(period, sizeof(period), "%s to %s",
+             (startDate && strlen(startDate) > 0) ? startDate : "All time",
+             (endDate && strlen(endDate) > 0) ? endDate : "Present");
+    
+    writeCsvText(&csv, "Report Period");
+    writeCsvText(&csv, period);
+    endCsvRow(&csv);
+    writeCsvMoneyRow(&csv, "Total Sales", report->totalSales);
+    writeCsvText(&csv, "Number of Transactions");
+    writeCsvInt(&csv, report->transactionCount);
+    endCsvRow(&csv);
+    writeCsvMoneyRow(&csv, "Average Sale", report->averageSale);
+    writeCsvRaw(&csv, "\n");
+    
+    writeCsvRaw(&csv, "Payment Method,Transactions,Total,Percentage\n");
+    for (int i = 0; i < report->paymentMethodCount; i++) {
+        const PaymentMethodTotal *method = &report->paymentMethods[i];
+        writeCsvText(&csv, lookupString(method->paymentMethodId));
+        writeCsvInt(&csv, method->transactionCount);
+        writeCsvMoney(&csv, method->total);
+        writeCsvPercent(&csv, method->percentage);
+        endCsvRow(&csv);
     }
     
-    printf("\n");
+    writeCsvRaw(&csv, "\nTransaction Details\n");
+    writeCsvRaw(&csv, "Transaction ID,Date,Customer,Total,Payment Method\n");
     
-    // Export option
-    printf("Would you like to export this report to a CSV file? (y/n): ");
-    char exportChoice;
-    scanf("%c", &exportChoice);
-    clearInputBuffer();
+    int slots[MAX_ARRAY_SIZE];
+    int slotCount = findSalesInPeriod(startDate, endDate, slots);
     
-    if (exportChoice == 'y' || exportChoice == 'Y') {
-        char filename[100];
-        snprintf(filename, sizeof(filename), "sales_report_%s_%s.csv", 
-                 (startDate && strlen(startDate) > 0) ? startDate : "all",
-                 (endDate && strlen(endDate) > 0) ? endDate : "present");
+    for (int s = 0; s < slotCount; s++) {
+        const Transaction *transaction = &transactions[slots[s]];
         
-        FILE *file = fopen(filename, "w");
-        if (file) {
-            fprintf(file, "Report Period,%s to %s\n", 
-                   (startDate && strlen(startDate) > 0) ? startDate : "All time",
-                   (endDate && strlen(endDate) > 0) ? endDate : "Present");
-            fprintf(file, "Total Sales,$%.2f\n", totalSales);
-            fprintf(file, "Number of Transactions,%d\n", transactionCountInPeriod);
-            fprintf(file, "Average Sale,$%.2f\n\n", averageSale);
-            
-            fprintf(file, "Payment Method,Transactions,Total,Percentage\n");
-            for (int i = 0; i < methodCount; i++) {
-                double percentage = (paymentTotals[i] / totalSales) * 100;
-                fprintf(file, "%s,%d,$%.2f,%.1f%%\n", 
-                       paymentMethods[i], paymentCounts[i], paymentTotals[i], percentage);
-            }
+        writeCsvText(&csv, transaction->transactionId);
+        writeCsvText(&csv, transaction->date);
+        writeCsvText(&csv, transaction->customerId);
+        writeCsvDecimal(&csv, transaction->total, 2);
+        writeCsvText(&csv, lookupString(transaction->paymentMethodId));
+        endCsvRow(&csv);
+    }
+    
+    return closeCsvWriter(&csv);
+}
+
+// Function to write the sales report as JSON or NDJSON
+bool writeSalesReportJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited) {
+    SalesReport report;
+    buildSalesReport(startDate, endDate, &report);
+    
+    JsonWriter json;
+    if (!openJsonReport(&json, path, lineDelimited, "sales_report", startDate, endDate)) {
+        return false;
+    }
+    
+    beginJsonRecord(&json, "summary");
+    writeJsonNumber(&json, "totalSales", report.totalSales, 2);
+    writeJsonInt(&json, "transactionCount", report.transactionCount);
+    writeJsonNumber(&json, "averageSale", report.averageSale, 2);
+    endJsonRecord(&json);
+    
+    for (int i = 0; i < report.paymentMethodCount; i++) {
+        const PaymentMethodTotal *method = &report.paymentMethods[i];
+        
+        beginJsonRecord(&json, "payment_method");
+        writeJsonString(&json, "paymentMethod", lookupString(method->paymentMethodId));
+        writeJsonInt(&json, "transactionCount", method->transactionCount);
+        writeJsonNumber(&json, "total", method->total, 2);
+        writeJsonNumber(&json, "percentage", method->percentage, 2);
+        endJsonRecord(&json);
+    }
+    
+    // Stream the transactions straight from the store
+    int slots[MAX_ARRAY_SIZE];
+    int slotCount = findSalesInPeriod(startDate, endDate, slots);
+    
+    for (int s = 0; s < slotCount; s++) {
+        const Transaction *transaction = &transactions[slots[s]];
+        
+        beginJsonRecord(&json, "transaction");
+        writeJsonString(&json, "transactionId", transaction->transactionId);
+        writeJsonString(&json, "date", transaction->date);
+        writeJsonString(&json, "customerId", transaction->customerId);
+        writeJsonNumber(&json, "total", transaction->total, 2);
+        writeJsonString(&json, "paymentMethod", lookupString(transaction->paymentMethodId));
+        endJsonRecord(&json);
+    }
+    
+    return closeJsonReport(&json);
+}
+
+// Function to export the transactions and their items as two columnar files
+bool exportTransactionsColumnar(const char *transactionsPath, const char *itemsPath) {
+    int itemCount = 0;
+    for (int i = 0; i < transactionCount; i++) {
+        itemCount += transactions[i].itemCount;
+    }
+    
+    // One array per column; strings point into the transactions rather than being copied
+    int rows = transactionCount > 0 ? transactionCount : 1;
+    int itemRows = itemCount > 0 ? itemCount : 1;
+    const char **ids = malloc(rows * sizeof(const char *));
+    const char **dates = malloc(rows * sizeof(const char *));
+    const char **customerIds = malloc(rows * sizeof(const char *));
+    const char **paymentMethods = malloc(rows * sizeof(const char *));
+    const char **statuses = malloc(rows * sizeof(const char *));
+    int32_t *itemCounts = malloc(rows * sizeof(int32_t));
+    double *totals = malloc(rows * sizeof(double));
+    const char **itemTransactionIds = malloc(itemRows * sizeof(const char *));
+    int32_t *productIds = malloc(itemRows * sizeof(int32_t));
+    int32_t *quantities = malloc(itemRows * sizeof(int32_t));
+    double *prices = malloc(itemRows * sizeof(double));
+    double *subtotals = malloc(itemRows * sizeof(double));
+    bool exported = false;
+    
+    if (ids && dates && customerIds && paymentMethods && statuses && itemCounts && totals &&
+        itemTransactionIds && productIds && quantities && prices && subtotals) {
+        int item = 0;
+        
+        for (int i = 0; i < transactionCount; i++) {
+            const Transaction *transaction = &transactions[i];
             
-            fprintf(file, "\nTransaction Details\n");
-            fprintf(file, "Transaction ID,Date,Customer,Total,Payment Method\n");
+            ids[i] = transaction->transactionId;
+            dates[i] = transaction->date;
+            customerIds[i] = transaction->customerId;
+            paymentMethods[i] = lookupString(transaction->paymentMethodId);
+            statuses[i] = lookupString(transaction->statusId);
+            itemCounts[i] = transaction->itemCount;
+            totals[i] = transaction->total;
             
-            for (int i = 0; i < transactionCount; i++) {
-                bool include = true;
-                
-                if (startDate && strlen(startDate) > 0) {
-                    if (strcmp(transactions[i].date, startDate) < 0) {
-                        include = false;
-                    }
-                }
-                
-                if (endDate && strlen(endDate) > 0) {
-                    if (strcmp(transactions[i].date, endDate) > 0) {
-                        include = false;
-                    }
-                }
-                
-                if (include && strcmp(transactions[i].status, "Completed") == 0) {
-                    fprintf(file, "%s,%s,%s,%.2f,%s\n",
-                           transactions[i].transactionId,
-                           transactions[i].date,
-                           transactions[i].customerId,
-                           transactions[i].total,
-                           transactions[i].paymentMethod);
-                }
+            for (int j = 0; j < transaction->itemCount; j++, item++) {
+                itemTransactionIds[item] = transaction->transactionId;
+                productIds[item] = transaction->items[j].productId;
+                quantities[item] = transaction->items[j].quantity;
+                prices[item] = transaction->items[j].price;
+                subtotals[item] = transaction->items[j].subtotal;
             }
-            
-            fclose(file);
-            printf("Report exported to %s\n", filename);
+        }
+        
+        ColumnarWriter columns;
+        if (openColumnarWriter(&columns, transactionsPath, 7, transactionCount)) {
+            writeColumnStrings(&columns, "transaction_id", ids);
+            writeColumnStrings(&columns, "date", dates);
+            writeColumnStrings(&columns, "customer_id", customerIds);
+            writeColumnStrings(&columns, "payment_method", paymentMethods);
+            writeColumnStrings(&columns, "status", statuses);
+            writeColumnInt32(&columns, "item_count", itemCounts);
+            writeColumnFloat64(&columns, "total", totals);
+            exported = closeColumnarWriter(&columns);
+        }
+        
+        if (exported && openColumnarWriter(&columns, itemsPath, 5, itemCount)) {
+            writeColumnStrings(&columns, "transaction_id", itemTransactionIds);
+            writeColumnInt32(&columns, "product_id", productIds);
+            writeColumnInt32(&columns, "quantity", quantities);
+            writeColumnFloat64(&columns, "price", prices);
+            writeColumnFloat64(&columns, "subtotal", subtotals);
+            exported = closeColumnarWriter(&columns);
         } else {
-            printf("Failed to export report.\n");
+            exported = false;
         }
     }
+    
+    free(ids);
+    free(dates);
+    free(customerIds);
+    free(paymentMethods);
+    free(statuses);
+    free(itemCounts);
+    free(totals);
+    free(itemTransactionIds);
+    free(productIds);
+    free(quantities);
+    free(prices);
+    free(subtotals);
+    return exported;
 }
\ No newline at end of file
@@ -0,0 +1,332 @@
+/**
+ * Billing Menu Implementation File
+ * Contains the billing screens and prompts built on the billing module
+ */
+
+#include "menu.h"
+#include "billing.h"
+#include "product.h"
+#include "customer.h"
+#include "dictionary.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "globals.h"
+
+// The bill being built, owned by the billing module
+extern Transaction currentTransaction;
+extern bool hasCurrentTransaction;
+
+// Function to print a transaction's receipt, sized to fit all of its items
+static void printReceipt(const Transaction *transaction) {
+    size_t size = getReceiptSize(transaction);
+    char *receipt = malloc(size);
+    
+    if (!receipt) {
+        // Fall back to a fixed buffer; the receipt then says how many items are left out
+        char fallback[2000];
+        if (!generateReceipt(transaction, fallback, sizeof(fallback))) {
+            displayError("Receipt shortened; not every item is shown.");
+        }
+        printf("\n%s\n", fallback);
+        return;
+    }
+    
+    generateReceipt(transaction, receipt, size);
+    printf("\n%s\n", receipt);
+    free(receipt);
+}
+
+// Function to run the billing system module
+void runBillingSystem() {
+    int choice;
+    bool running = true;
+    
+    // Load transaction data and customers for phone lookup at checkout
+    loadTransactionData();
+    loadCustomerData();
+    
+    // Initialize current transaction
+    memset(&currentTransaction, 0, sizeof(Transaction));
+    hasCurrentTransaction = false;
+    
+    while (running) {
+        // Write inventory changes that have waited long enough
+        flushProductChangesIfDue();
+        
+        clearScreen();
+        printf("\n\033[1;36m========================================\033[0m\n");
+        printf("\033[1;32m            BILLING SYSTEM\033[0m\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("1. Create New Bill\n");
+        printf("2. View Current Bill\n");
+        printf("3. Add Item to Bill\n");
+        printf("4. Remove Item from Bill\n");
+        printf("5. Complete Transaction\n");
+        printf("6. Transaction History\n");
+        printf("7. Generate Sales Report\n");
+        printf("8. Back to Main Menu\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        clearInputBuffer();
+        
+        switch (choice) {
+            case 1:
+                if (createTransaction()) {
+                    printf("New transaction created. Transaction ID: %s\n", currentTransaction.transactionId);
+                } else {
+                    printf("There is already an active transaction. Complete or clear it first.\n");
+                }
+                pressEnterToContinue();
+                break;
+            case 2:
+                if (hasCurrentTransaction) {
+                    printf("\n\033[1;36m========================================\033[0m\n");
+                    printf("\033[1;32m           CURRENT BILL\033[0m\n");
+                    printf("\033[1;36m========================================\033[0m\n");
+                    printf("Items:\n");
+                
+                    for (int i = 0; i < currentTransaction.itemCount; i++) {
+                        printf("%d. %s - %d x $%.2f = $%.2f\n", 
+                               i + 1,
+                               getBillingItemName(&currentTransaction.items[i]), 
+                               currentTransaction.items[i].quantity,
+                               currentTransaction.items[i].price,
+                               currentTransaction.items[i].subtotal);
+                    }
+                
+                    printf("\nTotal: $%.2f\n", calculateTransactionTotal());
+                } else {
+                    printf("No active transaction. Create a new bill first.\n");
+                }
+                pressEnterToContinue();
+                break;
+            case 3:
+                if (hasCurrentTransaction) {
+                    int productId, quantity;
+                    printf("Enter product ID: ");
+                    scanf("%d", &productId);
+                    clearInputBuffer();
+                
+                    printf("Enter quantity: ");
+                    scanf("%d", &quantity);
+                    clearInputBuffer();
+                
+                    if (addItemToTransaction(productId, quantity)) {
+                        printf("Item added to transaction.\n");
+                    }
+                } else {
+                    printf("No active transaction. Create a new bill first.\n");
+                }
+                pressEnterToContinue();
+                break;
+            case 4:
+                if (hasCurrentTransaction && currentTransaction.itemCount > 0) {
+                    int index;
+                    printf("Enter item number to remove (1-%d): ", currentTransaction.itemCount);
+                    scanf("%d", &index);
+                    clearInputBuffer();
+                
+                    if (removeItemFromTransaction(index - 1)) {
+                        printf("Item removed from transaction.\n");
+                    } else {
+                        printf("Invalid item number.\n");
+                    }
+                } else {
+                    printf("No items in the current transaction.\n");
+                }
+                pressEnterToContinue();
+                break;
+            case 5:
+                if (hasCurrentTransaction && currentTransaction.itemCount > 0) {
+                    char customerId[20];
+                    char paymentMethod[20];
+                
+                    printf("Enter customer ID or phone number (leave blank for anonymous): ");
+                    fgets(customerId, sizeof(customerId), stdin);
+                    customerId[strcspn(customerId, "\n")] = 0;
+                
+                    // Ask which customer is meant when a household shares the phone number
+                    int id;
+                    int sharing[MAX_ARRAY_SIZE];
+                    int sharingCount = 0;
+                    if (!parseCustomerId(customerId, &id) || findCustomerById(id) == -1) {
+                        sharingCount = findCustomersByPhone(customerId, sharing, MAX_ARRAY_SIZE);
+                    }
+                
+                    if (sharingCount > 1) {
+                        printf("Customers with this phone number:\n");
+                        for (int i = 0; i < sharingCount && i < MAX_ARRAY_SIZE; i++) {
+                            printf("  %d. %s\n", customers[sharing[i]].id, customers[sharing[i]].name);
+                        }
+                    
+                        printf("Enter customer ID: ");
+                        fgets(customerId, sizeof(customerId), stdin);
+                        customerId[strcspn(customerId, "\n")] = 0;
+                    }
+                
+                    printf("Enter payment method (Cash, Credit Card, Debit Card, etc.): ");
+                    fgets(paymentMethod, sizeof(paymentMethod), stdin);
+                    paymentMethod[strcspn(paymentMethod, "\n")] = 0;
+                
+                    char transactionId[20];
+                    strcpy(transactionId, currentTransaction.transactionId);
+                
+                    // A recorded sale closes the transaction, even if its stock changes were not saved
+                    bool completed = completeTransaction(customerId, paymentMethod);
+                    int completedIndex = findTransactionById(transactionId);
+                    if (!hasCurrentTransaction && completedIndex != -1) {
+                        printReceipt(&transactions[completedIndex]);
+                        if (completed) {
+                            printf("\nTransaction completed successfully!\n");
+                        }
+                    }
+                } else {
+                    printf("No items in the current transaction.\n");
+                }
+                pressEnterToContinue();
+                break;
+            case 6:
+                displayTransactionHistory(NULL, NULL, NULL);
+                pressEnterToContinue();
+                break;
+            case 7: {
+                char startDate[20], endDate[20];
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                generateSalesReport(startDate, endDate);
+                pressEnterToContinue();
+                break;
+            }
+            case 8:
+                running = false;
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+                pressEnterToContinue();
+        }
+    }
+}
+
+// Function to display transaction history
+void displayTransactionHistory(const char *startDate, const char *endDate, const char *paymentMethod) {
+    if (transactionCount == 0) {
+        printf("No transaction history available.\n");
+        return;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m        TRANSACTION HISTORY\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("%-20s %-20s %-15s %-10s %s\n", 
+           "Transaction ID", "Date", "Customer", "Total", "Status");
+    printf("--------------------------------------------------------------------------------------------------------\n");
+    
+    int slots[MAX_ARRAY_SIZE];
+    int count = findTransactionHistory(startDate, endDate, paymentMethod, slots);
+    
+    for (int s = 0; s < count; s++) {
+        const Transaction *transaction = &transactions[slots[s]];
+        
+        printf("%-20s %-20s %-15s $%-10.2f %s\n", 
+               transaction->transactionId,
+               transaction->date,
+               transaction->customerId,
+               transaction->total,
+               lookupString(transaction->statusId));
+    }
+    
+    printf("--------------------------------------------------------------------------------------------------------\n");
+    
+    // Display transaction details option
+    printf("\nEnter transaction ID to view details (or press Enter to return): ");
+    char transactionId[20];
+    fgets(transactionId, sizeof(transactionId), stdin);
+    transactionId[strcspn(transactionId, "\n")] = 0;
+    
+    if (strlen(transactionId) > 0) {
+        displayTransactionDetails(transactionId);
+    }
+}
+
+// Function to display transaction details
+bool displayTransactionDetails(const char *transactionId) {
+    int index = findTransactionById(transactionId);
+    
+    if (index == -1) {
+        printf("Transaction not found.\n");
+        return false;
+    }
+    
+    printReceipt(&transactions[index]);
+    
+    return true;
+}
+
+// Function to display a sales report
+void displaySalesReport(const char *startDate, const char *endDate, const SalesReport *report) {
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           SALES REPORT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Period: %s to %s\n\n", 
+           (startDate && strlen(startDate) > 0) ? startDate : "All time",
+           (endDate && strlen(endDate) > 0) ? endDate : "Present");
+    
+    printf("Total Sales: $%.2f\n", report->totalSales);
+    printf("Number of Transactions: %d\n", report->transactionCount);
+    printf("Average Sale: $%.2f\n\n", report->averageSale);
+    
+    // Payment method breakdown
+    printf("Payment Method Breakdown:\n");
+    printf("------------------------\n");
+    
+    for (int i = 0; i < report->paymentMethodCount; i++) {
+        const PaymentMethodTotal *method = &report->paymentMethods[i];
+        printf("%s: %d transactions, $%.2f (%.1f%%)\n", 
+               lookupString(method->paymentMethodId), method->transactionCount, method->total, method->percentage);
+    }
+    
+    printf("\n");
+}
+
+// Function to generate a sales report for a given period
+void generateSalesReport(const char *startDate, const char *endDate) {
+    if (transactionCount == 0) {
+        printf("No transaction data available for report.\n");
+        return;
+    }
+    
+    SalesReport report;
+    buildSalesReport(startDate, endDate, &report);
+    displaySalesReport(startDate, endDate, &report);
+    
+    // Export option
+    printf("Would you like to export this report to a CSV file? (y/n): ");
+    char exportChoice;
+    scanf("%c", &exportChoice);
+    clearInputBuffer();
+    
+    if (exportChoice == 'y' || exportChoice == 'Y') {
+        char filename[100];
+        snprintf(filename, sizeof(filename), "sales_report_%s_%s.csv", 
+                 (startDate && strlen(startDate) > 0) ? startDate : "all",
+                 (endDate && strlen(endDate) > 0) ? endDate : "present");
+        
+        if (exportSalesReportCsv(filename, startDate, endDate, &report)) {
+            printf("Report exported to %s\n", filename);
+        } else {
+            printf("Failed to export report.\n");
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,266 @@
+/**
+ * Command Line Implementation File
+ * Contains implementations of the non-interactive commands
+ */
+
+#include "cli.h"
+#include "menu.h"
+#include "product.h"
+#include "billing.h"
+#include "financial.h"
+#include "import.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Usage line of the report command
+#define REPORT_USAGE "report income|expenses|profit-loss|sales [--from YYYY-MM-DD] [--to YYYY-MM-DD] " \
+                     "[--format text|csv|json|ndjson] [--output file]"
+
+// Output formats of the report command
+typedef enum {
+    REPORT_TEXT,      // The same screen the menus show
+    REPORT_CSV,       // The same file the menus export
+    REPORT_JSON,      // One JSON document
+    REPORT_NDJSON     // One JSON record per line
+} ReportFormat;
+
+// One command: its name, usage line and the function that runs it (argv[0] is the command name)
+typedef struct {
+    const char *name;
+    const char *usage;
+    int (*run)(int argc, char *argv[]);
+} Command;
+
+// Function to report a command used the wrong way
+static int showUsage(const char *usage) {
+    char message[200];
+    snprintf(message, sizeof(message), "Usage: bams %s", usage);
+    displayError(message);
+    return 1;
+}
+
+// Function to run a report in one format
+static int runReport(int argc, char *argv[]) {
+    static const char *formatNames[] = { "text", "csv", "json", "ndjson" };
+    
+    if (argc < 2) {
+        return showUsage(REPORT_USAGE);
+    }
+    
+    const char *report = argv[1];
+    const char *startDate = "";
+    const char *endDate = "";
+    const char *output = "-";
+    ReportFormat format = REPORT_TEXT;
+    
+    // Every option takes a value; an empty date leaves that end of the period open
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return showUsage(REPORT_USAGE);
+        }
+        
+        if (strcmp(argv[i], "--from") == 0) {
+            startDate = argv[i + 1];
+        } else if (strcmp(argv[i], "--to") == 0) {
+            endDate = argv[i + 1];
+        } else if (strcmp(argv[i], "--output") == 0) {
+            output = argv[i + 1];
+        } else if (strcmp(argv[i], "--format") == 0) {
+            int f = 0;
+            while (f < 4 && strcmp(argv[i + 1], formatNames[f]) != 0) {
+                f++;
+            }
+            if (f == 4) {
+                return showUsage(REPORT_USAGE);
+            }
+            format = (ReportFormat)f;
+        } else {
+            return showUsage(REPORT_USAGE);
+        }
+    }
+    
+    // The text report is the menu screen, which only goes to standard output
+    if (format == REPORT_TEXT && strcmp(output, "-") != 0) {
+        displayError("Text reports are written to standard output; use --format csv, json or ndjson with --output.");
+        return 1;
+    }
+    
+    bool lineDelimited = format == REPORT_NDJSON;
+    bool written = true;
+    
+    if (strcmp(report, "income") == 0) {
+        loadFinancialData();
+        
+        if (format == REPORT_JSON || format == REPORT_NDJSON) {
+            written = writeIncomeStatementJson(output, startDate, endDate, lineDelimited);
+        } else {
+            IncomeStatement statement;
+            buildIncomeStatement(startDate, endDate, &statement);
+            
+            if (format == REPORT_CSV) {
+                written = exportIncomeStatementCsv(output, startDate, endDate, &statement);
+            } else {
+                displayIncomeStatement(startDate, endDate, &statement);
+            }
+        }
+    } else if (strcmp(report, "expenses") == 0) {
+        loadFinancialData();
+        
+        if (format == REPORT_JSON || format == REPORT_NDJSON) {
+            written = writeExpenseReportJson(output, startDate, endDate, lineDelimited);
+        } else {
+            ExpenseReport expenseReport;
+            buildExpenseReport(startDate, endDate, &expenseReport);
+            
+            if (format == REPORT_CSV) {
+                written = exportExpenseReportCsv(output, startDate, endDate, &expenseReport);
+            } else {
+                displayExpenseReport(startDate, endDate, &expenseReport);
+            }
+        }
+    } else if (strcmp(report, "profit-loss") == 0) {
+        loadFinancialData();
+        
+        if (format == REPORT_JSON || format == REPORT_NDJSON) {
+            written = writeProfitLossReportJson(output, startDate, endDate, lineDelimited);
+        } else {
+            ProfitLossReport profitLossReport;
+            buildProfitLossReport(startDate, endDate, &profitLossReport);
+            
+            if (format == REPORT_CSV) {
+                written = exportProfitLossReportCsv(output, startDate, endDate, &profitLossReport);
+            } else {
+                displayProfitLossReport(startDate, endDate, &profitLossReport);
+            }
+        }
+    } else if (strcmp(report, "sales") == 0) {
+        loadTransactionData();
+        
+        if (format == REPORT_JSON || format == REPORT_NDJSON) {
+            written = writeSalesReportJson(output, startDate, endDate, lineDelimited);
+        } else {
+            SalesReport salesReport;
+            buildSalesReport(startDate, endDate, &salesReport);
+            
+            if (format == REPORT_CSV) {
+                written = exportSalesReportCsv(output, startDate, endDate, &salesReport);
+            } else {
+                displaySalesReport(startDate, endDate, &salesReport);
+            }
+        }
+    } else {
+        return showUsage(REPORT_USAGE);
+    }
+    
+    if (!written) {
+        displayError("Failed to write report.");
+        return 1;
+    }
+    return 0;
+}
+
+// Function to load a CSV file into one store
+static int runImport(int argc, char *argv[]) {
+    ImportKind kind;
+    
+    if (argc < 3 || !parseImportKind(argv[1], &kind)) {
+        return showUsage("import products|customers|transactions|financial file.csv");
+    }
+    return importCsvFile(kind, argv[2]) ? 0 : 1;
+}
+
+// Function to apply a batch of product ID,quantity lines to the inventory
+static int runReceiveInventory(int argc, char *argv[]) {
+    loadProductData();
+    return receiveInventoryFromFile(argc >= 2 ? argv[1] : "-") ? 0 : 1;
+}
+
+// Function to append the financial records a consumer has not seen yet
+static int runExportFinancial(int argc, char *argv[]) {
+    if (argc < 3) {
+        return showUsage("export-financial consumer file.csv");
+    }
+    
+    loadFinancialData();
+    int exported = exportFinancialDataSince(argv[1], argv[2]);
+    if (exported < 0) {
+        displayError("Failed to export financial data.");
+        return 1;
+    }
+    
+    printf("Exported %d new financial record(s) to %s\n", exported, argv[2]);
+    return 0;
+}
+
+// Function to write the transaction, item and financial tables as columnar files
+static int runExportColumnar(int argc, char *argv[]) {
+    const char *directory = argc >= 2 ? argv[1] : ".";
+    char transactionsPath[256], itemsPath[256], financialPath[256];
+    
+    snprintf(transactionsPath, sizeof(transactionsPath), "%s/transactions.col", directory);
+    snprintf(itemsPath, sizeof(itemsPath), "%s/transaction_items.col", directory);
+    snprintf(financialPath, sizeof(financialPath), "%s/financial.col", directory);
+    
+    if (!createDirectory(directory)) {
+        displayError("Could not create the output folder.");
+        return 1;
+    }
+    
+    loadTransactionData();
+    loadFinancialData();
+    
+    if (!exportTransactionsColumnar(transactionsPath, itemsPath) || !exportFinancialColumnar(financialPath)) {
+        displayError("Failed to write the columnar files.");
+        return 1;
+    }
+    
+    printf("Columnar tables written to %s\n", directory);
+    return 0;
+}
+
+// Every command, in the order the help lists them
+static const Command commands[] = {
+    { "report", REPORT_USAGE, runReport },
+    { "import", "import products|customers|transactions|financial file.csv", runImport },
+    { "receive-inventory", "receive-inventory [file.csv|-]", runReceiveInventory },
+    { "export-financial", "export-financial consumer file.csv", runExportFinancial },
+    { "export-columnar", "export-columnar [folder]", runExportColumnar }
+};
+
+// Function to list every command
+static void displayCommands() {
+    printf("Run without arguments for the menus, or run one command:\n");
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        printf("  bams %s\n", commands[i].usage);
+    }
+}
+
+// Function to run a command without the menus
+int runCommandLine(int argc, char *argv[]) {
+    const char *name = argv[1];
+    
+    // Older scripts spell the commands as options
+    if (strncmp(name, "--", 2) == 0) {
+        name += 2;
+    }
+    
+    if (strcmp(name, "help") == 0) {
+        displayCommands();
+        return 0;
+    }
+    
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (strcmp(name, commands[i].name) == 0) {
+            return commands[i].run(argc - 1, argv + 1);
+        }
+    }
+    
+    char message[200];
+    snprintf(message, sizeof(message), "Unknown command: %s", argv[1]);
+    displayError(message);
+    displayCommands();
+    return 1;
+}
\ No newline at end of file
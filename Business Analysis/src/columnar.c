@@ -0,0 +1,287 @@
+/**
+ * Columnar Export Implementation File
+ * Contains implementations of the columnar file writer and reader
+ */
+
+#include "columnar.h"
+#include "storage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Function to write bytes at the current end of the file
+static void writeColumnarBytes(ColumnarWriter *writer, const void *bytes, size_t count) {
+    if (count > 0 && fwrite(bytes, 1, count, writer->file) != count) {
+        writer->failed = true;
+    }
+    writer->position += count;
+}
+
+// Function to pad the file so the next values start on an 8-byte boundary
+static void alignColumnarFile(ColumnarWriter *writer) {
+    static const unsigned char zeros[8] = { 0 };
+    
+    writeColumnarBytes(writer, zeros, (size_t)((8 - writer->position % 8) % 8));
+}
+
+// Function to add the next column to the directory, returning NULL once all promised columns are used
+static ColumnarColumn *startColumn(ColumnarWriter *writer, const char *name, ColumnType type) {
+    if ((int)writer->header.columnCount >= writer->expectedColumns) {
+        writer->failed = true;
+        return NULL;
+    }
+    
+    ColumnarColumn *column = &writer->columns[writer->header.columnCount++];
+    strncpy(column->name, name, COLUMNAR_NAME_LENGTH - 1);
+    column->type = type;
+    
+    alignColumnarFile(writer);
+    column->offset = writer->position;
+    return column;
+}
+
+// Function to create a columnar file, leaving room for its header and directory
+bool openColumnarWriter(ColumnarWriter *writer, const char *path, int columnCount, uint64_t rowCount) {
+    memset(writer, 0, sizeof(ColumnarWriter));
+    
+    if (columnCount <= 0 || columnCount > COLUMNAR_MAX_COLUMNS) {
+        return false;
+    }
+    
+    // Written beside the final path and renamed over it once complete
+    snprintf(writer->path, sizeof(writer->path), "%s", path);
+    if (!makeTemporaryPath(path, writer->temporaryPath, sizeof(writer->temporaryPath))) {
+        return false;
+    }
+    
+    writer->file = fopen(writer->temporaryPath, "wb");
+    if (!writer->file) {
+        return false;
+    }
+    
+    memcpy(writer->header.magic, COLUMNAR_MAGIC, sizeof(writer->header.magic));
+    writer->header.version = COLUMNAR_VERSION;
+    writer->header.rowCount = rowCount;
+    
+    // Placeholders; the real header and directory are written over them on close
+    writeColumnarBytes(writer, &writer->header, sizeof(ColumnarFileHeader));
+    writeColumnarBytes(writer, writer->columns, columnCount * sizeof(ColumnarColumn));
+    
+    writer->expectedColumns = columnCount;
+    
+    if (writer->failed) {
+        fclose(writer->file);
+        remove(writer->temporaryPath);
+        writer->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Function to write the header and directory and close the file
+bool closeColumnarWriter(ColumnarWriter *writer) {
+    // The space left for the directory only fits the columns promised when the file was opened
+    if ((int)writer->header.columnCount != writer->expectedColumns) {
+        writer->failed = true;
+    }
+    
+    if (fseek(writer->file, 0, SEEK_SET) != 0) {
+        writer->failed = true;
+    } else {
+        writeColumnarBytes(writer, &writer->header, sizeof(ColumnarFileHeader));
+        writeColumnarBytes(writer, writer->columns, writer->header.columnCount * sizeof(ColumnarColumn));
+    }
+    
+    if (fclose(writer->file) != 0) {
+        writer->failed = true;
+    }
+    writer->file = NULL;
+    
+    // An incomplete file never replaces the previous export
+    if (writer->failed) {
+        remove(writer->temporaryPath);
+        return false;
+    }
+    return moveFileIntoPlace(writer->temporaryPath, writer->path);
+}
+
+// Function to write the next column as 32-bit integers
+void writeColumnInt32(ColumnarWriter *writer, const char *name, const int32_t *values) {
+    ColumnarColumn *column = startColumn(writer, name, COLUMN_INT32);
+    if (!column) {
+        return;
+    }
+    
+    column->length = writer->header.rowCount * sizeof(int32_t);
+    writeColumnarBytes(writer, values, (size_t)column->length);
+}
+
+// Function to write the next column as 64-bit floating point numbers
+void writeColumnFloat64(ColumnarWriter *writer, const char *name, const double *values) {
+    ColumnarColumn *column = startColumn(writer, name, COLUMN_FLOAT64);
+    if (!column) {
+        return;
+    }
+    
+    column->length = writer->header.rowCount * sizeof(double);
+    writeColumnarBytes(writer, values, (size_t)column->length);
+}
+
+// Function to write the next column as strings
+void writeColumnStrings(ColumnarWriter *writer, const char *name, const char *const *values) {
+    ColumnarColumn *column = startColumn(writer, name, COLUMN_STRING);
+    if (!column) {
+        return;
+    }
+    
+    size_t rowCount = (size_t)writer->header.rowCount;
+    int32_t *offsets = malloc((rowCount + 1) * sizeof(int32_t));
+    if (!offsets) {
+        writer->failed = true;
+        return;
+    }
+    
+    // Offsets first: row i is bytes offsets[i] to offsets[i + 1] of the string data
+    uint64_t total = 0;
+    offsets[0] = 0;
+    for (size_t i = 0; i < rowCount; i++) {
+        total += strlen(values[i]);
+        if (total > INT32_MAX) {
+            writer->failed = true;
+            free(offsets);
+            return;
+        }
+        offsets[i + 1] = (int32_t)total;
+    }
+    
+    column->length = (rowCount + 1) * sizeof(int32_t);
+    writeColumnarBytes(writer, offsets, (size_t)column->length);
+    free(offsets);
+    
+    alignColumnarFile(writer);
+    column->dataOffset = writer->position;
+    column->dataLength = total;
+    
+    for (size_t i = 0; i < rowCount; i++) {
+        writeColumnarBytes(writer, values[i], strlen(values[i]));
+    }
+}
+
+// Function to get the size of one value of a fixed-width column type, or 0 for other types
+static size_t getColumnValueSize(uint32_t type) {
+    switch (type) {
+        case COLUMN_INT32:
+            return sizeof(int32_t);
+        case COLUMN_FLOAT64:
+            return sizeof(double);
+        default:
+            return 0;
+    }
+}
+
+// Function to check that a range of bytes lies inside the file
+static bool isColumnarRangeValid(uint64_t offset, uint64_t length, size_t fileSize) {
+    return offset <= fileSize && length <= fileSize - offset;
+}
+
+// Function to check one directory entry against the file it describes
+static bool validateColumnarColumn(const ColumnarFile *file, const ColumnarColumn *column) {
+    const unsigned char *base = file->mapping.payload;
+    size_t fileSize = file->mapping.payloadSize;
+    uint64_t rowCount = file->header->rowCount;
+    
+    // Values are aligned so they can be read in place
+    if (column->offset % 8 != 0 || !isColumnarRangeValid(column->offset, column->length, fileSize) ||
+        memchr(column->name, '\0', COLUMNAR_NAME_LENGTH) == NULL) {
+        return false;
+    }
+    
+    size_t valueSize = getColumnValueSize(column->type);
+    if (valueSize != 0) {
+        return rowCount <= UINT64_MAX / valueSize && column->length == rowCount * valueSize;
+    }
+    
+    if (column->type != COLUMN_STRING || rowCount >= UINT64_MAX / sizeof(int32_t) ||
+        column->length != (rowCount + 1) * sizeof(int32_t) ||
+        !isColumnarRangeValid(column->dataOffset, column->dataLength, fileSize)) {
+        return false;
+    }
+    
+    // Offsets start at 0, never decrease and end at the length of the string data
+    const int32_t *offsets = (const int32_t *)(base + column->offset);
+    if (offsets[0] != 0 || (uint64_t)offsets[rowCount] != column->dataLength) {
+        return false;
+    }
+    for (uint64_t i = 0; i < rowCount; i++) {
+        if (offsets[i + 1] < offsets[i]) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Function to map a columnar file and check its layout
+bool openColumnarFile(const char *path, ColumnarFile *file) {
+    memset(file, 0, sizeof(ColumnarFile));
+    
+    if (!mapTextFile(path, &file->mapping)) {
+        return false;
+    }
+    
+    const unsigned char *base = file->mapping.payload;
+    size_t fileSize = file->mapping.payloadSize;
+    
+    file->header = (const ColumnarFileHeader *)base;
+    file->columns = (const ColumnarColumn *)(base + sizeof(ColumnarFileHeader));
+    
+    bool valid = fileSize >= sizeof(ColumnarFileHeader) &&
+                 memcmp(file->header->magic, COLUMNAR_MAGIC, sizeof(file->header->magic)) == 0 &&
+                 file->header->version == COLUMNAR_VERSION &&
+                 file->header->columnCount <= COLUMNAR_MAX_COLUMNS &&
+                 fileSize - sizeof(ColumnarFileHeader) >= file->header->columnCount * sizeof(ColumnarColumn);
+    
+    for (uint32_t i = 0; valid && i < file->header->columnCount; i++) {
+        valid = validateColumnarColumn(file, &file->columns[i]);
+    }
+    
+    if (!valid) {
+        closeColumnarFile(file);
+        return false;
+    }
+    return true;
+}
+
+// Function to release a mapped columnar file
+void closeColumnarFile(ColumnarFile *file) {
+    unmapDataFile(&file->mapping);
+    file->header = NULL;
+    file->columns = NULL;
+}
+
+// Function to find a column by name and type
+const ColumnarColumn *findColumnarColumn(const ColumnarFile *file, const char *name, ColumnType type) {
+    for (uint32_t i = 0; i < file->header->columnCount; i++) {
+        if (file->columns[i].type == (uint32_t)type && strcmp(file->columns[i].name, name) == 0) {
+            return &file->columns[i];
+        }
+    }
+    
+    return NULL;
+}
+
+// Function to get the values of a fixed-width column
+const void *getColumnarValues(const ColumnarFile *file, const ColumnarColumn *column) {
+    return file->mapping.payload + column->offset;
+}
+
+// Function to get one row of a string column
+const char *getColumnarString(const ColumnarFile *file, const ColumnarColumn *column,
+                              uint64_t row, size_t *length) {
+    const int32_t *offsets = (const int32_t *)(file->mapping.payload + column->offset);
+    
+    *length = (size_t)(offsets[row + 1] - offsets[row]);
+    return (const char *)file->mapping.payload + column->dataOffset + offsets[row];
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+/**
+ * Compression Implementation File
+ * Contains implementations of the LZ77 block codec
+ *
+ * A block is a sequence of (token, literals, offset, match) groups. The token
+ * holds the literal length in its high nibble and the match length minus
+ * MIN_MATCH in its low nibble; a nibble of 15 is continued in following bytes
+ * of 255 until a smaller byte. The last group has literals only.
+ */
+
+#include "compression.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Shortest match worth encoding
+#define MIN_MATCH 4
+
+// Furthest back a match can refer to (offsets are 16 bits)
+#define MAX_OFFSET 65535
+
+// Size of the table of recent positions, indexed by a hash of 4 bytes
+#define HASH_BITS 12
+
+// Function to hash the 4 bytes at a position
+static uint32_t hashSequence(const unsigned char *position) {
+    uint32_t value;
+    memcpy(&value, position, sizeof(value));
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Function to write a length continuation (the part beyond a full nibble)
+static bool writeLength(size_t length, unsigned char *destination, size_t capacity, size_t *out) {
+    while (length >= 255) {
+        if (*out >= capacity) {
+            return false;
+        }
+        destination[(*out)++] = 255;
+        length -= 255;
+    }
+    
+    if (*out >= capacity) {
+        return false;
+    }
+    destination[(*out)++] = (unsigned char)length;
+    return true;
+}
+
+// Function to write one group of literals and an optional match
+static bool writeSequence(const unsigned char *literals, size_t literalLength, size_t offset, size_t matchLength,
+                          unsigned char *destination, size_t capacity, size_t *out) {
+    size_t matchCode = matchLength > 0 ? matchLength - MIN_MATCH : 0;
+    
+    if (*out >= capacity) {
+        return false;
+    }
+    destination[(*out)++] = (unsigned char)(((literalLength < 15 ? literalLength : 15) << 4) |
+                                            (matchCode < 15 ? matchCode : 15));
+    
+    if (literalLength >= 15 && !writeLength(literalLength - 15, destination, capacity, out)) {
+        return false;
+    }
+    
+    if (literalLength > capacity - *out) {
+        return false;
+    }
+    memcpy(destination + *out, literals, literalLength);
+    *out += literalLength;
+    
+    // The final group carries no match
+    if (matchLength == 0) {
+        return true;
+    }
+    
+    if (capacity - *out < 2) {
+        return false;
+    }
+    destination[(*out)++] = (unsigned char)(offset & 0xFF);
+    destination[(*out)++] = (unsigned char)(offset >> 8);
+    
+    return matchCode < 15 || writeLength(matchCode - 15, destination, capacity, out);
+}
+
+// Function to get the worst-case compressed size
+size_t getCompressBound(size_t sourceSize) {
+    return sourceSize + sourceSize / 255 + 16;
+}
+
+// Function to compress a block of bytes
+size_t compressBlock(const unsigned char *source, size_t sourceSize,
+                     unsigned char *destination, size_t capacity) {
+    // Positions are stored plus one so that zero means empty
+    uint32_t recent[1 << HASH_BITS];
+    memset(recent, 0, sizeof(recent));
+    
+    size_t anchor = 0;
+    size_t position = 0;
+    size_t out = 0;
+    
+    while (position + MIN_MATCH <= sourceSize) {
+        uint32_t hash = hashSequence(source + position);
+        size_t candidate = recent[hash];
+        recent[hash] = (uint32_t)(position + 1);
+        
+        if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET ||
+            memcmp(source + candidate - 1, source + position, MIN_MATCH) != 0) {
+            position++;
+            continue;
+        }
+        
+        // Extend the match as far as it goes
+        candidate--;
+        size_t matchLength = MIN_MATCH;
+        while (position + matchLength < sourceSize && source[candidate + matchLength] == source[position + matchLength]) {
+            matchLength++;
+        }
+        
+        if (!writeSequence(source + anchor, position - anchor, position - candidate, matchLength,
+                           destination, capacity, &out)) {
+            return 0;
+        }
+        
+        position += matchLength;
+        anchor = position;
+    }
+    
+    // Whatever is left after the last match is stored as literals
+    if (!writeSequence(source + anchor, sourceSize - anchor, 0, 0, destination, capacity, &out)) {
+        return 0;
+    }
+    
+    return out;
+}
+
+// Function to read a length continuation
+static bool readLength(const unsigned char **position, const unsigned char *end, size_t *length) {
+    unsigned char byte;
+    
+    do {
+        if (*position >= end) {
+            return false;
+        }
+        byte = *(*position)++;
+        *length += byte;
+    } while (byte == 255);
+    
+    return true;
+}
+
+// Function to decompress a block
+bool decompressBlock(const unsigned char *source, size_t sourceSize,
+                     unsigned char *destination, size_t destinationSize) {
+    const unsigned char *position = source;
+    const unsigned char *end = source + sourceSize;
+    size_t out = 0;
+    
+    while (position < end) {
+        unsigned char token = *position++;
+        
+        // Copy the literals
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(&position, end, &literalLength)) {
+            return false;
+        }
+        
+        if (literalLength > (size_t)(end - position) || literalLength > destinationSize - out) {
+            return false;
+        }
+        memcpy(destination + out, position, literalLength);
+        position += literalLength;
+        out += literalLength;
+        
+        // The final group ends the block
+        if (position == end) {
+            break;
+        }
+        
+        // Copy the match, byte by byte since it may overlap its own output
+        if (end - position < 2) {
+            return false;
+        }
+        size_t offset = position[0] | ((size_t)position[1] << 8);
+        position += 2;
+        
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(&position, end, &matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        
+        if (offset == 0 || offset > out || matchLength > destinationSize - out) {
+            return false;
+        }
+        
+        for (size_t i = 0; i < matchLength; i++, out++) {
+            destination[out] = destination[out - offset];
+        }
+    }
+    
+    return out == destinationSize;
+}
\ No newline at end of file
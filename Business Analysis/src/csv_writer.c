@@ -0,0 +1,270 @@
+/**
+ * CSV Writer Implementation File
+ * Contains implementations of the buffered CSV writer and number formatter
+ */
+
+#include "csv_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+// Function to format a number with a fixed number of decimals
+size_t formatFixed(double value, int decimals, char *buffer) {
+    static const double scales[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    
+    // Values too large to scale exactly, and NaN or infinity, are left to snprintf
+    double scale = decimals >= 0 && decimals <= 9 ? scales[decimals] : 1.0;
+    double scaled = fabs(value) * scale;
+    if (decimals < 0 || decimals > 9 || !(scaled < 9e15)) {
+        return (size_t)snprintf(buffer, FIXED_NUMBER_LENGTH, "%.*f", decimals, value);
+    }
+    
+    // Round to the nearest integer, ties to even, as printf does. The product
+    // above was itself rounded, so the exact remainder (from fma) corrects values
+    // that it pushed across or onto a halfway point
+    double rounded = nearbyint(scaled);
+    double remainder = fma(fabs(value), scale, -rounded);
+    
+    if (remainder > 0.5) {
+        rounded += 1.0;
+    } else if (remainder < -0.5) {
+        rounded -= 1.0;
+    } else if (remainder == 0.5 || remainder == -0.5) {
+        // Still a tie at this precision: what is left beyond the halfway point decides,
+        // and only an exact tie goes to the even neighbour
+        double halfway = rounded + remainder;
+        double excess = fma(fabs(value), scale, -halfway);
+        
+        if (excess > 0.0) {
+            rounded = halfway + 0.5;
+        } else if (excess < 0.0) {
+            rounded = halfway - 0.5;
+        } else {
+            rounded = 2.0 * nearbyint(halfway / 2.0);
+        }
+    }
+    
+    uint64_t units = (uint64_t)rounded;
+    char digits[FIXED_NUMBER_LENGTH];
+    int digitCount = 0;
+    
+    // Digits come out least significant first, with at least one before the point
+    do {
+        digits[digitCount++] = (char)('0' + units % 10);
+        units /= 10;
+    } while (units > 0 || digitCount <= decimals);
+    
+    size_t length = 0;
+    if (signbit(value)) {
+        buffer[length++] = '-';
+    }
+    
+    while (digitCount > decimals) {
+        buffer[length++] = digits[--digitCount];
+    }
+    
+    if (decimals > 0) {
+        buffer[length++] = '.';
+        while (digitCount > 0) {
+            buffer[length++] = digits[--digitCount];
+        }
+    }
+    
+    buffer[length] = '\0';
+    return length;
+}
+
+// Function to write the buffered bytes to the file
+static void flushCsvWriter(CsvWriter *writer) {
+    if (writer->length > 0 && fwrite(writer->buffer, 1, writer->length, writer->file) != writer->length) {
+        writer->failed = true;
+    }
+    writer->length = 0;
+}
+
+// Function to make room for the given number of bytes in the buffer
+static void reserveCsvBytes(CsvWriter *writer, size_t count) {
+    if (writer->length + count > CSV_WRITER_BUFFER_SIZE) {
+        flushCsvWriter(writer);
+    }
+}
+
+// Function to append bytes to the buffer
+static void appendCsvBytes(CsvWriter *writer, const char *bytes, size_t count) {
+    // Anything bigger than the buffer goes straight to the file
+    if (count > CSV_WRITER_BUFFER_SIZE) {
+        flushCsvWriter(writer);
+        if (fwrite(bytes, 1, count, writer->file) != count) {
+            writer->failed = true;
+        }
+        return;
+    }
+    
+    reserveCsvBytes(writer, count);
+    memcpy(writer->buffer + writer->length, bytes, count);
+    writer->length += count;
+}
+
+// Function to put a separator before every field but the first of a row
+static void startCsvField(CsvWriter *writer) {
+    if (writer->rowStarted) {
+        reserveCsvBytes(writer, 1);
+        writer->buffer[writer->length++] = ',';
+    }
+    writer->rowStarted = true;
+}
+
+// Function to open a CSV file in the given mode along with its output buffer
+static bool openCsvFile(CsvWriter *writer, const char *path, const char *mode) {
+    memset(writer, 0, sizeof(CsvWriter));
+    
+    writer->buffer = malloc(CSV_WRITER_BUFFER_SIZE);
+    if (!writer->buffer) {
+        return false;
+    }
+    
+    if (strcmp(path, "-") == 0) {
+        writer->file = stdout;
+    } else {
+        writer->file = fopen(path, mode);
+        writer->ownsFile = true;
+    }
+    
+    if (!writer->file) {
+        free(writer->buffer);
+        writer->buffer = NULL;
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to create a CSV file and its output buffer
+bool openCsvWriter(CsvWriter *writer, const char *path) {
+    return openCsvFile(writer, path, "w");
+}
+
+// Function to open a CSV file for adding rows to its end
+bool openCsvWriterForAppend(CsvWriter *writer, const char *path, bool *isNew) {
+    if (!openCsvFile(writer, path, "a")) {
+        return false;
+    }
+    
+    // Standard output is a stream of its own, so it always gets a header line
+    if (!writer->ownsFile) {
+        *isNew = true;
+        return true;
+    }
+    
+    // Nothing written yet means the caller still has to write the header line
+    if (fseek(writer->file, 0, SEEK_END) != 0) {
+        closeCsvWriter(writer);
+        return false;
+    }
+    *isNew = ftell(writer->file) == 0;
+    
+    return true;
+}
+
+// Function to write out the buffer and close the file
+bool closeCsvWriter(CsvWriter *writer) {
+    flushCsvWriter(writer);
+    
+    if (writer->ownsFile) {
+        if (fclose(writer->file) != 0) {
+            writer->failed = true;
+        }
+    } else if (fflush(writer->file) != 0) {
+        writer->failed = true;
+    }
+    
+    free(writer->buffer);
+    writer->buffer = NULL;
+    writer->file = NULL;
+    return !writer->failed;
+}
+
+// Function to write text exactly as given
+void writeCsvRaw(CsvWriter *writer, const char *text) {
+    appendCsvBytes(writer, text, strlen(text));
+}
+
+// Function to write a text field, quoting it when needed
+void writeCsvText(CsvWriter *writer, const char *text) {
+    size_t length = strlen(text);
+    
+    startCsvField(writer);
+    
+    if (strcspn(text, ",\"\r\n") == length) {
+        appendCsvBytes(writer, text, length);
+        return;
+    }
+    
+    // Quoted: surround with quotes and double any quote inside
+    if (2 * length + 2 > CSV_WRITER_BUFFER_SIZE) {
+        writer->failed = true;
+        return;
+    }
+    
+    reserveCsvBytes(writer, 2 * length + 2);
+    writer->buffer[writer->length++] = '"';
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '"') {
+            writer->buffer[writer->length++] = '"';
+        }
+        writer->buffer[writer->length++] = text[i];
+    }
+    writer->buffer[writer->length++] = '"';
+}
+
+// Function to write a whole number field
+void writeCsvInt(CsvWriter *writer, long long value) {
+    char text[FIXED_NUMBER_LENGTH];
+    
+    startCsvField(writer);
+    appendCsvBytes(writer, text, formatFixed((double)value, 0, text));
+}
+
+// Function to write a number field with a fixed number of decimals
+void writeCsvDecimal(CsvWriter *writer, double value, int decimals) {
+    char text[FIXED_NUMBER_LENGTH];
+    
+    startCsvField(writer);
+    appendCsvBytes(writer, text, formatFixed(value, decimals, text));
+}
+
+// Function to write a money field
+// CSV files are read by other programs, so the currency sign is left to the text screens
+void writeCsvMoney(CsvWriter *writer, double amount) {
+    writeCsvDecimal(writer, amount, 2);
+}
+
+// Function to write a percentage field
+// Written as a bare number, with the same precision as the JSON reports
+void writeCsvPercent(CsvWriter *writer, double percentage) {
+    writeCsvDecimal(writer, percentage, 2);
+}
+
+// Function to end the current row
+void endCsvRow(CsvWriter *writer) {
+    reserveCsvBytes(writer, 1);
+    writer->buffer[writer->length++] = '\n';
+    writer->rowStarted = false;
+}
+
+// Function to write a label and money amount row
+void writeCsvMoneyRow(CsvWriter *writer, const char *label, double amount) {
+    writeCsvText(writer, label);
+    writeCsvMoney(writer, amount);
+    endCsvRow(writer);
+}
+
+// Function to write a label and percentage row
+void writeCsvPercentRow(CsvWriter *writer, const char *label, double percentage) {
+    writeCsvText(writer, label);
+    writeCsvPercent(writer, percentage);
+    endCsvRow(writer);
+}
\ No newline at end of file
@@ -5,296 +5,175 @@
 
 #include "customer.h"
 #include "utils.h"
+#include "index.h"
+#include "storage.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include "globals.h"
 
 // Global array to store customers
-Customer customers[MAX_ARRAY_SIZE];
-int customerCount = 0;
+extern Customer customers[MAX_ARRAY_SIZE];
+extern int customerCount;
 
-// Function to run the customer management module
-void runCustomerManagement() {
-    int choice;
-    bool running = true;
+// Trigram indexes for customer search, rebuilt lazily after customers change
+static TrigramIndex customerNameIndex;
+static TrigramIndex customerEmailIndex;
 
-    // Load customer data
-    loadCustomerData();
+// Function to get a customer's name for the trigram index
+static const char *getCustomerNameText(int slot) {
+    return customers[slot].name;
+}
 
-    while (running) {
-        clearScreen();
-        printf("\n\033[1;36m========================================\033[0m\n");
-        printf("\033[1;32m        CUSTOMER MANAGEMENT\033[0m\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("1. Add Customer\n");
-        printf("2. Search Customer by ID\n");
-        printf("3. Search Customers by Name\n");
-        printf("4. Display All Customers\n");
-        printf("5. Edit Customer\n");
-        printf("6. Delete Customer\n");
-        printf("7. Back to Main Menu\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        clearInputBuffer();
+// Function to get a customer's email for the trigram index
+static const char *getCustomerEmailText(int slot) {
+    return customers[slot].email;
+}
 
-        switch (choice) {
-            case 1:
-                addCustomer();
-                pressEnterToContinue();
-                break;
-            case 2: {
-                int id;
-                printf("Enter customer ID to search: ");
-                scanf("%d", &id);
-                clearInputBuffer();
-                searchCustomerById(id);
-                pressEnterToContinue();
-                break;
-            }
-            case 3: {
-                char name[MAX_STRING_LENGTH];
-                printf("Enter customer name (or part of name) to search: ");
-                fgets(name, sizeof(name), stdin);
-                name[strcspn(name, "\n")] = 0; // Remove newline character
-                searchCustomersByName(name);
-                pressEnterToContinue();
-                break;
-            }
-            case 4:
-                displayAllCustomers();
-                pressEnterToContinue();
-                break;
-            case 5: {
-                int id;
-                printf("Enter customer ID to edit: ");
-                scanf("%d", &id);
-                clearInputBuffer();
-                editCustomer(id);
-                pressEnterToContinue();
-                break;
-            }
-            case 6: {
-                int id;
-                printf("Enter customer ID to delete: ");
-                scanf("%d", &id);
-                clearInputBuffer();
-                deleteCustomer(id);
-                pressEnterToContinue();
-                break;
-            }
-            case 7:
-                running = false;
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-                pressEnterToContinue();
-        }
-    }
+// Function to mark the customer search indexes as out of date
+static void invalidateCustomerSearchIndexes() {
+    invalidateTrigramIndex(&customerNameIndex);
+    invalidateTrigramIndex(&customerEmailIndex);
 }
 
-// Function to add a new customer
-bool addCustomer() {
-    if (customerCount >= MAX_ARRAY_SIZE) {
-        displayError("Customer database is full. Cannot add more customers.");
-        return false;
-    }
+// Exact-match indexes from normalized phone number and email to the IDs of the customers
+// sharing them (a household may share one phone number)
+static StringHashIndex customerPhoneIndex;
+static StringHashIndex customerEmailLookup;
 
-    Customer newCustomer;
-    
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           ADD NEW CUSTOMER\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("Enter ID: ");
-    scanf("%d", &newCustomer.id);
-    clearInputBuffer();
+// State of the customer file at the last load or save
+static DataFileStamp customerFileStamp;
+
+// Function to normalize a phone number (digits only)
+static void normalizePhone(const char *phone, char *normalized, size_t size) {
+    size_t length = 0;
     
-    // Check if ID already exists
-    for (int i = 0; i < customerCount; i++) {
-        if (customers[i].id == newCustomer.id) {
-            displayError("A customer with this ID already exists.");
-            return false;
+    for (; *phone && length < size - 1; phone++) {
+        if (isdigit((unsigned char)*phone)) {
+            normalized[length++] = *phone;
         }
     }
-    
-    printf("Enter Name: ");
-    fgets(newCustomer.name, sizeof(newCustomer.name), stdin);
-    newCustomer.name[strcspn(newCustomer.name, "\n")] = 0; // Remove newline character
-    
-    printf("Enter Phone: ");
-    fgets(newCustomer.phone, sizeof(newCustomer.phone), stdin);
-    newCustomer.phone[strcspn(newCustomer.phone, "\n")] = 0;
-    
-    printf("Enter Email: ");
-    fgets(newCustomer.email, sizeof(newCustomer.email), stdin);
-    newCustomer.email[strcspn(newCustomer.email, "\n")] = 0;
-    
-    printf("Enter Address: ");
-    fgets(newCustomer.address, sizeof(newCustomer.address), stdin);
-    newCustomer.address[strcspn(newCustomer.address, "\n")] = 0;
-    
-    printf("Enter Notes: ");
-    fgets(newCustomer.notes, sizeof(newCustomer.notes), stdin);
-    newCustomer.notes[strcspn(newCustomer.notes, "\n")] = 0;
-    
-    // Add the new customer to the array
-    customers[customerCount] = newCustomer;
-    customerCount++;
-    
-    // Sort customers by ID
-    sortCustomersById();
-    
-    // Save customer data
-    if (saveCustomerData()) {
-        displaySuccess("Customer added successfully.");
-        return true;
-    } else {
-        displayError("Failed to save customer data.");
-        return false;
-    }
+    normalized[length] = '\0';
 }
 
-// Function to search for a customer by ID
-bool searchCustomerById(int id) {
-    // Binary search since customers are sorted by ID
-    int index = findCustomerById(id);
+// Function to normalize an email address (trimmed and lowercase)
+static void normalizeEmail(const char *email, char *normalized, size_t size) {
+    size_t length = 0;
     
-    if (index != -1) {
-        printf("\n\033[1;36m========================================\033[0m\n");
-        printf("\033[1;32m            CUSTOMER FOUND\033[0m\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        displayCustomerDetails(&customers[index]);
-        return true;
-    } else {
-        displayError("Customer not found.");
-        return false;
+    while (isspace((unsigned char)*email)) {
+        email++;
     }
-}
-
-// Function to search for customers by name
-void searchCustomersByName(const char *name) {
-    bool found = false;
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           SEARCH RESULTS\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    for (int i = 0; i < customerCount; i++) {
-        // Case-insensitive search (crude implementation)
-        char lowerName[MAX_STRING_LENGTH];
-        char lowerCustomerName[MAX_STRING_LENGTH];
-        
-        // Convert both strings to lowercase
-        strcpy(lowerName, name);
-        strcpy(lowerCustomerName, customers[i].name);
-        
-        for (int j = 0; lowerName[j]; j++) {
-            lowerName[j] = tolower(lowerName[j]);
-        }
-        
-        for (int j = 0; lowerCustomerName[j]; j++) {
-            lowerCustomerName[j] = tolower(lowerCustomerName[j]);
-        }
-        
-        // Check if substring exists
-        if (strstr(lowerCustomerName, lowerName) != NULL) {
-            displayCustomerDetails(&customers[i]);
-            printf("-------------------\n");
-            found = true;
-        }
+    for (; *email && length < size - 1; email++) {
+        normalized[length++] = (char)tolower((unsigned char)*email);
     }
     
-    if (!found) {
-        printf("No customers found matching '%s'.\n", name);
+    while (length > 0 && isspace((unsigned char)normalized[length - 1])) {
+        length--;
     }
+    normalized[length] = '\0';
 }
 
-// Function to display all customers
-void displayAllCustomers() {
-    if (customerCount == 0) {
-        printf("No customers in the database.\n");
-        return;
-    }
+// Function to add a customer's phone number and email to the contact indexes
+static void indexCustomerContacts(const Customer *customer) {
+    char key[STRING_INDEX_KEY_LENGTH];
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           ALL CUSTOMERS\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
+    normalizePhone(customer->phone, key, sizeof(key));
+    addStringIndexEntry(&customerPhoneIndex, key, customer->id);
     
-    for (int i = 0; i < customerCount; i++) {
-        displayCustomerDetails(&customers[i]);
-        printf("-------------------\n");
-    }
+    normalizeEmail(customer->email, key, sizeof(key));
+    addStringIndexEntry(&customerEmailLookup, key, customer->id);
 }
 
-// Function to display details for a specific customer
-void displayCustomerDetails(const Customer *customer) {
-    printf("ID: %d\n", customer->id);
-    printf("Name: %s\n", customer->name);
-    printf("Phone: %s\n", customer->phone);
-    printf("Email: %s\n", customer->email);
-    printf("Address: %s\n", customer->address);
-    printf("Notes: %s\n", customer->notes);
+// Function to remove a customer's phone number and email from the contact indexes
+static void unindexCustomerContacts(const Customer *customer) {
+    char key[STRING_INDEX_KEY_LENGTH];
+    
+    normalizePhone(customer->phone, key, sizeof(key));
+    removeStringIndexEntry(&customerPhoneIndex, key, customer->id);
+    
+    normalizeEmail(customer->email, key, sizeof(key));
+    removeStringIndexEntry(&customerEmailLookup, key, customer->id);
 }
 
-// Function to edit a customer's information
-bool editCustomer(int id) {
-    int index = findCustomerById(id);
-    
-    if (index == -1) {
-        displayError("Customer not found.");
+// Function to add a batch of new customers and save them once
+bool appendCustomers(const Customer *newCustomers, int count) {
+    if (customerCount + count > MAX_ARRAY_SIZE) {
+        displayError("Customer database is full. Cannot add more customers.");
         return false;
     }
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           EDIT CUSTOMER\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("Editing customer with ID: %d\n", id);
-    printf("Current details:\n");
-    displayCustomerDetails(&customers[index]);
+    for (int i = 0; i < count; i++) {
+        indexCustomerContacts(&newCustomers[i]);
+    }
     
-    printf("\nEnter new details (leave blank to keep current):\n");
+    memcpy(&customers[customerCount], newCustomers, count * sizeof(Customer));
+    customerCount += count;
     
-    char buffer[MAX_STRING_LENGTH];
+    sortCustomersById();
+    return saveCustomerData();
+}
+
+// Function to insert a new customer in ID order and save
+bool insertCustomer(const Customer *customer) {
+    if (customerCount >= MAX_ARRAY_SIZE) {
+        displayError("Customer database is full. Cannot add more customers.");
+        return false;
+    }
     
-    printf("Name [%s]: ", customers[index].name);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(customers[index].name, buffer);
+    if (findCustomerById(customer->id) != -1) {
+        displayError("A customer with this ID already exists.");
+        return false;
     }
     
-    printf("Phone [%s]: ", customers[index].phone);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(customers[index].phone, buffer);
+    // Insert the new customer at its place in ID order instead of re-sorting
+    int position = customerCount;
+    while (position > 0 && customers[position - 1].id > customer->id) {
+        customers[position] = customers[position - 1];
+        position--;
     }
+    customers[position] = *customer;
+    customerCount++;
+    indexCustomerContacts(customer);
+    invalidateCustomerSearchIndexes();
     
-    printf("Email [%s]: ", customers[index].email);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(customers[index].email, buffer);
+    // Save customer data
+    if (saveCustomerData()) {
+        displaySuccess("Customer added successfully.");
+        return true;
+    } else {
+        displayError("Failed to save customer data.");
+        return false;
     }
+}
+
+// Function to replace a customer's details and save
+bool updateCustomer(int id, const Customer *customer) {
+    int index = findCustomerById(id);
     
-    printf("Address [%s]: ", customers[index].address);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(customers[index].address, buffer);
+    if (index == -1) {
+        displayError("Customer not found.");
+        return false;
     }
     
-    printf("Notes [%s]: ", customers[index].notes);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(customers[index].notes, buffer);
+    // Update the contact indexes if the phone number or email changed
+    if (strcmp(customer->phone, customers[index].phone) != 0 ||
+        strcmp(customer->email, customers[index].email) != 0) {
+        unindexCustomerContacts(&customers[index]);
+        safeStringCopy(customers[index].phone, sizeof(customers[index].phone), customer->phone);
+        safeStringCopy(customers[index].email, sizeof(customers[index].email), customer->email);
+        indexCustomerContacts(&customers[index]);
     }
     
+    safeStringCopy(customers[index].name, sizeof(customers[index].name), customer->name);
+    safeStringCopy(customers[index].address, sizeof(customers[index].address), customer->address);
+    safeStringCopy(customers[index].notes, sizeof(customers[index].notes), customer->notes);
+    invalidateCustomerSearchIndexes();
+    
     // Save customer data
     if (saveCustomerData()) {
         displaySuccess("Customer updated successfully.");
@@ -305,8 +184,8 @@ bool editCustomer(int id) {
     }
 }
 
-// Function to delete a customer
-bool deleteCustomer(int id) {
+// Function to remove a customer and save
+bool removeCustomer(int id) {
     int index = findCustomerById(id);
     
     if (index == -1) {
@@ -314,86 +193,103 @@ bool deleteCustomer(int id) {
         return false;
     }
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           DELETE CUSTOMER\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
+    unindexCustomerContacts(&customers[index]);
     
-    printf("Are you sure you want to delete the following customer?\n");
-    displayCustomerDetails(&customers[index]);
+    // Remove customer by shifting all elements down
+    for (int i = index; i < customerCount - 1; i++) {
+        customers[i] = customers[i + 1];
+    }
     
-    printf("\nConfirm deletion (y/n): ");
-    char confirmation;
-    scanf("%c", &confirmation);
-    clearInputBuffer();
+    customerCount--;
+    invalidateCustomerSearchIndexes();
     
-    if (confirmation == 'y' || confirmation == 'Y') {
-        // Remove customer by shifting all elements down
-        for (int i = index; i < customerCount - 1; i++) {
-            customers[i] = customers[i + 1];
-        }
-        
-        customerCount--;
-        
-        // Save customer data
-        if (saveCustomerData()) {
-            displaySuccess("Customer deleted successfully.");
-            return true;
-        } else {
-            displayError("Failed to save customer data.");
-            return false;
-        }
+    // Save customer data
+    if (saveCustomerData()) {
+        displaySuccess("Customer deleted successfully.");
+        return true;
     } else {
-        printf("Deletion cancelled.\n");
+        displayError("Failed to save customer data.");
         return false;
     }
 }
 
+// Function to find the customers whose name or email contains a search term
+int searchCustomers(const char *query, bool *matches) {
+    memset(matches, 0, customerCount * sizeof(bool));
+    
+    // Case-insensitive substring search over names and emails
+    int found = searchTrigramIndex(&customerNameIndex, customerCount, getCustomerNameText, query, matches);
+    found += searchTrigramIndex(&customerEmailIndex, customerCount, getCustomerEmailText, query, matches);
+    
+    return found;
+}
+
 // Function to save customer data to file
 bool saveCustomerData() {
-    FILE *file = fopen(CUSTOMER_FILE, "wb");
-    
-    if (!file) {
+    // Write the customer data
+    if (!writeDataFile(CUSTOMER_FILE, sizeof(Customer), customerCount,
+                       customers, customerCount * sizeof(Customer))) {
+        invalidateDataFileStamp(&customerFileStamp);
         return false;
     }
     
-    // Write the number of customers
-    fwrite(&customerCount, sizeof(int), 1, file);
-    
-    // Write the customer data
-    fwrite(customers, sizeof(Customer), customerCount, file);
-    
-    fclose(file);
+    // Our own save does not make the in-memory copy stale
+    stampDataFile(CUSTOMER_FILE, &customerFileStamp);
     return true;
 }
 
 // Function to load customer data from file
 bool loadCustomerData() {
-    FILE *file = fopen(CUSTOMER_FILE, "rb");
+    // Nothing to do if the file has not changed since it was last read or written
+    if (isDataFileCurrent(CUSTOMER_FILE, &customerFileStamp)) {
+        return true;
+    }
+    
+    invalidateDataFileStamp(&customerFileStamp);
+    
+    MappedDataFile file;
     
-    if (!file) {
+    if (!mapDataFile(CUSTOMER_FILE, sizeof(Customer), &file)) {
         customerCount = 0;
         return false;
     }
     
-    // Read the number of customers
-    fread(&customerCount, sizeof(int), 1, file);
-    
     // Check if the number of customers is valid
-    if (customerCount < 0 || customerCount > MAX_ARRAY_SIZE) {
+    if (file.header->recordCount > MAX_ARRAY_SIZE) {
         customerCount = 0;
-        fclose(file);
+        unmapDataFile(&file);
         return false;
     }
     
-    // Read the customer data
-    fread(customers, sizeof(Customer), customerCount, file);
+    // Copy the customer data straight out of the mapping
+    customerCount = (int)file.header->recordCount;
+    memcpy(customers, file.payload, customerCount * sizeof(Customer));
+    
+    unmapDataFile(&file);
+    stampDataFile(CUSTOMER_FILE, &customerFileStamp);
+    invalidateCustomerSearchIndexes();
     
-    fclose(file);
+    // findCustomerById binary-searches by ID; only sort if the file is out of order
+    for (int i = 1; i < customerCount; i++) {
+        if (customers[i - 1].id > customers[i].id) {
+            sortCustomersById();
+            break;
+        }
+    }
+    
+    // Rebuild the phone and email indexes
+    clearStringIndex(&customerPhoneIndex);
+    clearStringIndex(&customerEmailLookup);
+    for (int i = 0; i < customerCount; i++) {
+        indexCustomerContacts(&customers[i]);
+    }
     return true;
 }
 
 // Function to sort customers by ID
 void sortCustomersById() {
+    invalidateCustomerSearchIndexes();
+    
     // Selection sort algorithm
     for (int i = 0; i < customerCount - 1; i++) {
         int minIndex = i;
@@ -414,6 +310,8 @@ void sortCustomersById() {
 
 // Function to sort customers by name
 void sortCustomersByName() {
+    invalidateCustomerSearchIndexes();
+    
     // Selection sort algorithm
     for (int i = 0; i < customerCount - 1; i++) {
         int minIndex = i;
@@ -450,4 +348,88 @@ int findCustomerById(int id) {
     }
     
     return -1; // Not found
+}
+
+// Function to parse a transaction's customer ID field into a numeric customer ID
+bool parseCustomerId(const char *text, int *id) {
+    char *end;
+    
+    if (!text || strlen(text) == 0) {
+        return false;
+    }
+    
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return false; // Anonymous or free-text customer
+    }
+    
+    // A number too large for an ID (such as a long phone number) is not a customer ID
+    if (errno == ERANGE || value < INT_MIN || value > INT_MAX) {
+        return false;
+    }
+    
+    *id = (int)value;
+    return true;
+}
+
+// Function to turn the IDs found in a contact index into customer slots in ID order
+static int findCustomersByContact(const StringHashIndex *index, const char *key, int *slots, int maxSlots) {
+    int ids[MAX_ARRAY_SIZE];
+    int found = findStringIndexEntries(index, key, ids, MAX_ARRAY_SIZE);
+    int count = 0;
+    
+    if (found > MAX_ARRAY_SIZE) {
+        found = MAX_ARRAY_SIZE;
+    }
+    
+    // Insertion sort by ID, so the customers sharing a contact are listed in the same order every time
+    for (int i = 0; i < found; i++) {
+        int position = i;
+        while (position > 0 && ids[position - 1] > ids[i]) {
+            position--;
+        }
+        
+        int id = ids[i];
+        memmove(&ids[position + 1], &ids[position], (i - position) * sizeof(int));
+        ids[position] = id;
+    }
+    
+    for (int i = 0; i < found; i++) {
+        int slot = findCustomerById(ids[i]);
+        if (slot == -1) {
+            continue;
+        }
+        
+        if (count < maxSlots) {
+            slots[count] = slot;
+        }
+        count++;
+    }
+    
+    return count;
+}
+
+// Function to find the customers with a phone number
+int findCustomersByPhone(const char *phone, int *slots, int maxSlots) {
+    char key[STRING_INDEX_KEY_LENGTH];
+    
+    if (!phone) {
+        return 0;
+    }
+    
+    normalizePhone(phone, key, sizeof(key));
+    return findCustomersByContact(&customerPhoneIndex, key, slots, maxSlots);
+}
+
+// Function to find the customers with an email address
+int findCustomersByEmail(const char *email, int *slots, int maxSlots) {
+    char key[STRING_INDEX_KEY_LENGTH];
+    
+    if (!email) {
+        return 0;
+    }
+    
+    normalizeEmail(email, key, sizeof(key));
+    return findCustomersByContact(&customerEmailLookup, key, slots, maxSlots);
 }
\ No newline at end of file
@@ -0,0 +1,355 @@
+/**
+ * Customer Menu Implementation File
+ * Contains the customer management screens and prompts built on the customer module
+ */
+
+#include "menu.h"
+#include "customer.h"
+#include "billing.h"
+#include "dictionary.h"
+#include "index.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "globals.h"
+
+// Function to run the customer management module
+void runCustomerManagement() {
+    int choice;
+    bool running = true;
+    
+    // Load customer data and transactions for purchase history
+    loadCustomerData();
+    loadTransactionData();
+    
+    while (running) {
+        clearScreen();
+        printf("\n\033[1;36m========================================\033[0m\n");
+        printf("\033[1;32m        CUSTOMER MANAGEMENT\033[0m\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("1. Add Customer\n");
+        printf("2. Search Customer by ID\n");
+        printf("3. Search Customers by Name\n");
+        printf("4. Display All Customers\n");
+        printf("5. Edit Customer\n");
+        printf("6. Delete Customer\n");
+        printf("7. Customer Purchase History\n");
+        printf("8. Back to Main Menu\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        clearInputBuffer();
+        
+        switch (choice) {
+            case 1:
+                addCustomer();
+                pressEnterToContinue();
+                break;
+            case 2: {
+                int id;
+                printf("Enter customer ID to search: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                searchCustomerById(id);
+                pressEnterToContinue();
+                break;
+            }
+            case 3: {
+                char name[MAX_STRING_LENGTH];
+                printf("Enter customer name or email (or part of it) to search: ");
+                fgets(name, sizeof(name), stdin);
+                name[strcspn(name, "\n")] = 0; // Remove newline character
+                searchCustomersByName(name);
+                pressEnterToContinue();
+                break;
+            }
+            case 4:
+                displayAllCustomers();
+                pressEnterToContinue();
+                break;
+            case 5: {
+                int id;
+                printf("Enter customer ID to edit: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                editCustomer(id);
+                pressEnterToContinue();
+                break;
+            }
+            case 6: {
+                int id;
+                printf("Enter customer ID to delete: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                deleteCustomer(id);
+                pressEnterToContinue();
+                break;
+            }
+            case 7: {
+                int id;
+                printf("Enter customer ID to view purchase history: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                displayCustomerPurchaseHistory(id);
+                pressEnterToContinue();
+                break;
+            }
+            case 8:
+                running = false;
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+                pressEnterToContinue();
+        }
+    }
+}
+
+// Function to add a new customer
+bool addCustomer() {
+    if (customerCount >= MAX_ARRAY_SIZE) {
+        displayError("Customer database is full. Cannot add more customers.");
+        return false;
+    }
+    
+    Customer newCustomer;
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           ADD NEW CUSTOMER\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Enter ID: ");
+    scanf("%d", &newCustomer.id);
+    clearInputBuffer();
+    
+    // Check if ID already exists
+    if (findCustomerById(newCustomer.id) != -1) {
+        displayError("A customer with this ID already exists.");
+        return false;
+    }
+    
+    printf("Enter Name: ");
+    fgets(newCustomer.name, sizeof(newCustomer.name), stdin);
+    newCustomer.name[strcspn(newCustomer.name, "\n")] = 0; // Remove newline character
+    
+    printf("Enter Phone: ");
+    fgets(newCustomer.phone, sizeof(newCustomer.phone), stdin);
+    newCustomer.phone[strcspn(newCustomer.phone, "\n")] = 0;
+    
+    printf("Enter Email: ");
+    fgets(newCustomer.email, sizeof(newCustomer.email), stdin);
+    newCustomer.email[strcspn(newCustomer.email, "\n")] = 0;
+    
+    printf("Enter Address: ");
+    fgets(newCustomer.address, sizeof(newCustomer.address), stdin);
+    newCustomer.address[strcspn(newCustomer.address, "\n")] = 0;
+    
+    printf("Enter Notes: ");
+    fgets(newCustomer.notes, sizeof(newCustomer.notes), stdin);
+    newCustomer.notes[strcspn(newCustomer.notes, "\n")] = 0;
+    
+    return insertCustomer(&newCustomer);
+}
+
+// Function to search for a customer by ID
+bool searchCustomerById(int id) {
+    // Binary search since customers are sorted by ID
+    int index = findCustomerById(id);
+    
+    if (index != -1) {
+        printf("\n\033[1;36m========================================\033[0m\n");
+        printf("\033[1;32m            CUSTOMER FOUND\033[0m\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        displayCustomerDetails(&customers[index]);
+        return true;
+    } else {
+        displayError("Customer not found.");
+        return false;
+    }
+}
+
+// Function to search for customers by name
+void searchCustomersByName(const char *name) {
+    bool matches[MAX_ARRAY_SIZE] = {false};
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           SEARCH RESULTS\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    int found = searchCustomers(name, matches);
+    
+    for (int i = 0; i < customerCount; i++) {
+        if (matches[i]) {
+            displayCustomerDetails(&customers[i]);
+            printf("-------------------\n");
+        }
+    }
+    
+    if (found == 0) {
+        printf("No customers found matching '%s'.\n", name);
+    }
+}
+
+// Function to display the purchase history of a customer
+bool displayCustomerPurchaseHistory(int id) {
+    if (!searchCustomerById(id)) {
+        return false;
+    }
+    
+    // Look up the customer's transactions through the index instead of scanning all transactions
+    int slots[MAX_ARRAY_SIZE];
+    int purchaseCount = getCustomerTransactions(id, slots, MAX_ARRAY_SIZE);
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m        PURCHASE HISTORY\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    if (purchaseCount == 0) {
+        printf("No purchases recorded for this customer.\n");
+        return true;
+    }
+    
+    printf("%-20s %-20s %-8s %-10s %s\n", 
+           "Transaction ID", "Date", "Items", "Total", "Status");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    double totalSpent = 0.0;
+    
+    for (int i = 0; i < purchaseCount; i++) {
+        const Transaction *transaction = &transactions[slots[i]];
+        
+        printf("%-20s %-20s %-8d $%-9.2f %s\n", 
+               transaction->transactionId,
+               transaction->date,
+               transaction->itemCount,
+               transaction->total,
+               lookupString(transaction->statusId));
+        
+        if (transaction->statusId == STRING_ID_COMPLETED) {
+            totalSpent += transaction->total;
+        }
+    }
+    
+    printf("--------------------------------------------------------------------------------\n");
+    printf("Number of Purchases: %d\n", purchaseCount);
+    printf("Total Spent: $%.2f\n", totalSpent);
+    
+    return true;
+}
+
+// Function to display all customers
+void displayAllCustomers() {
+    if (customerCount == 0) {
+        printf("No customers in the database.\n");
+        return;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           ALL CUSTOMERS\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    for (int i = 0; i < customerCount; i++) {
+        displayCustomerDetails(&customers[i]);
+        printf("-------------------\n");
+    }
+}
+
+// Function to display details for a specific customer
+void displayCustomerDetails(const Customer *customer) {
+    printf("ID: %d\n", customer->id);
+    printf("Name: %s\n", customer->name);
+    printf("Phone: %s\n", customer->phone);
+    printf("Email: %s\n", customer->email);
+    printf("Address: %s\n", customer->address);
+    printf("Notes: %s\n", customer->notes);
+}
+
+// Function to edit a customer's information
+bool editCustomer(int id) {
+    int index = findCustomerById(id);
+    
+    if (index == -1) {
+        displayError("Customer not found.");
+        return false;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           EDIT CUSTOMER\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Editing customer with ID: %d\n", id);
+    printf("Current details:\n");
+    displayCustomerDetails(&customers[index]);
+    
+    printf("\nEnter new details (leave blank to keep current):\n");
+    
+    char buffer[MAX_STRING_LENGTH];
+    Customer updated = customers[index];
+    
+    printf("Name [%s]: ", customers[index].name);
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        strcpy(updated.name, buffer);
+    }
+    
+    printf("Phone [%s]: ", customers[index].phone);
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        safeStringCopy(updated.phone, sizeof(updated.phone), buffer);
+    }
+    
+    printf("Email [%s]: ", customers[index].email);
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        strcpy(updated.email, buffer);
+    }
+    
+    printf("Address [%s]: ", customers[index].address);
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        strcpy(updated.address, buffer);
+    }
+    
+    printf("Notes [%s]: ", customers[index].notes);
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        strcpy(updated.notes, buffer);
+    }
+    
+    return updateCustomer(id, &updated);
+}
+
+// Function to delete a customer
+bool deleteCustomer(int id) {
+    int index = findCustomerById(id);
+    
+    if (index == -1) {
+        displayError("Customer not found.");
+        return false;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           DELETE CUSTOMER\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Are you sure you want to delete the following customer?\n");
+    displayCustomerDetails(&customers[index]);
+    
+    printf("\nConfirm deletion (y/n): ");
+    char confirmation;
+    scanf("%c", &confirmation);
+    clearInputBuffer();
+    
+    if (confirmation == 'y' || confirmation == 'Y') {
+        return removeCustomer(id);
+    } else {
+        printf("Deletion cancelled.\n");
+        return false;
+    }
+}
\ No newline at end of file
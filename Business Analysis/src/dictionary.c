@@ -0,0 +1,238 @@
+/**
+ * String Dictionary Implementation File
+ * Contains implementations of the interned string dictionary
+ */
+
+#include "dictionary.h"
+#include "utils.h"
+#include "storage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Number of buckets in the string-to-ID hash table (must be a power of two)
+#define DICTIONARY_BUCKETS (MAX_DICTIONARY_SIZE * 2)
+
+// Strings indexed by ID
+static char dictionaryStrings[MAX_DICTIONARY_SIZE][DICTIONARY_STRING_LENGTH];
+static int dictionarySize = 0;
+
+// Hash table from string to ID (-1 marks an empty bucket)
+static int dictionaryBuckets[DICTIONARY_BUCKETS];
+
+// State of the dictionary file at the last load or save
+static DataFileStamp dictionaryFileStamp;
+
+// Function to hash a string (FNV-1a)
+static unsigned int hashDictionaryString(const char *value) {
+    unsigned int hash = 2166136261u;
+    
+    for (; *value; value++) {
+        hash ^= (unsigned char)*value;
+        hash *= 16777619u;
+    }
+    
+    return hash;
+}
+
+// Function to find the bucket for a string (either holding it or the empty bucket to use)
+static int findDictionaryBucket(const char *value) {
+    unsigned int hash = hashDictionaryString(value);
+    
+    for (int probe = 0; probe < DICTIONARY_BUCKETS; probe++) {
+        int bucket = (int)((hash + probe) & (DICTIONARY_BUCKETS - 1));
+        int id = dictionaryBuckets[bucket];
+        
+        if (id == -1 || strcmp(dictionaryStrings[id], value) == 0) {
+            return bucket;
+        }
+    }
+    
+    return -1;
+}
+
+// Function to add a string to the dictionary without saving
+static uint32_t addDictionaryString(const char *value) {
+    char truncated[DICTIONARY_STRING_LENGTH];
+    
+    // Strings are stored truncated, so look them up truncated too
+    safeStringCopy(truncated, sizeof(truncated), value);
+    
+    int bucket = findDictionaryBucket(truncated);
+    if (bucket == -1) {
+        return INVALID_STRING_ID;
+    }
+    
+    if (dictionaryBuckets[bucket] != -1) {
+        return (uint32_t)dictionaryBuckets[bucket];
+    }
+    
+    if (dictionarySize >= MAX_DICTIONARY_SIZE) {
+        return INVALID_STRING_ID;
+    }
+    
+    strcpy(dictionaryStrings[dictionarySize], truncated);
+    dictionaryBuckets[bucket] = dictionarySize;
+    
+    return (uint32_t)dictionarySize++;
+}
+
+// Function to start a new dictionary with the well-known strings
+static void resetDictionary() {
+    dictionarySize = 0;
+    for (int i = 0; i < DICTIONARY_BUCKETS; i++) {
+        dictionaryBuckets[i] = -1;
+    }
+    
+    // Order must match the STRING_ID_* constants
+    addDictionaryString("Income");
+    addDictionaryString("Expense");
+    addDictionaryString("Completed");
+    addDictionaryString("Cash");
+}
+
+// Function to get the ID of a string, adding it if needed
+uint32_t internString(const char *value) {
+    if (!value) {
+        return INVALID_STRING_ID;
+    }
+    
+    if (dictionarySize == 0) {
+        resetDictionary();
+    }
+    
+    // Pick up strings another process added before assigning a new ID
+    uint32_t id = findStringId(value);
+    if (id != INVALID_STRING_ID) {
+        return id;
+    }
+    
+    // Another process must not save between our load and save, or one of the
+    // two would hand out an ID the other's file no longer has. If the lock cannot
+    // be taken the data directory is unusable, and the save below fails as well
+    bool locked = lockDataFile(DICTIONARY_FILE);
+    loadDictionary();
+    
+    int sizeBefore = dictionarySize;
+    id = addDictionaryString(value);
+    
+    // Persist new strings right away so data files never refer to unknown IDs
+    if (dictionarySize != sizeBefore) {
+        saveDictionary();
+    }
+    
+    if (locked) {
+        unlockDataFile(DICTIONARY_FILE);
+    }
+    return id;
+}
+
+// Function to get the ID of a string without adding it
+uint32_t findStringId(const char *value) {
+    char truncated[DICTIONARY_STRING_LENGTH];
+    
+    if (!value) {
+        return INVALID_STRING_ID;
+    }
+    
+    if (dictionarySize == 0) {
+        resetDictionary();
+    }
+    
+    safeStringCopy(truncated, sizeof(truncated), value);
+    
+    int bucket = findDictionaryBucket(truncated);
+    if (bucket == -1 || dictionaryBuckets[bucket] == -1) {
+        return INVALID_STRING_ID;
+    }
+    
+    return (uint32_t)dictionaryBuckets[bucket];
+}
+
+// Function to get the string for an ID
+const char *lookupString(uint32_t id) {
+    if (dictionarySize == 0) {
+        resetDictionary();
+    }
+    
+    // An unknown ID may have been added by another process
+    if (id >= (uint32_t)dictionarySize && id < MAX_DICTIONARY_SIZE) {
+        loadDictionary();
+    }
+    
+    if (id >= (uint32_t)dictionarySize) {
+        return "";
+    }
+    
+    return dictionaryStrings[id];
+}
+
+// Function to get the number of strings in the dictionary
+int getDictionarySize() {
+    if (dictionarySize == 0) {
+        resetDictionary();
+    }
+    
+    return dictionarySize;
+}
+
+// Function to save the dictionary to file
+bool saveDictionary() {
+    // Write the strings in ID order
+    if (!writeDataFile(DICTIONARY_FILE, DICTIONARY_STRING_LENGTH, dictionarySize,
+                       dictionaryStrings, (size_t)dictionarySize * DICTIONARY_STRING_LENGTH)) {
+        invalidateDataFileStamp(&dictionaryFileStamp);
+        return false;
+    }
+    
+    stampDataFile(DICTIONARY_FILE, &dictionaryFileStamp);
+    return true;
+}
+
+// Function to load the dictionary from file
+bool loadDictionary() {
+    // Nothing to do if the file has not changed since it was last read or written
+    if (isDataFileCurrent(DICTIONARY_FILE, &dictionaryFileStamp)) {
+        return true;
+    }
+    
+    MappedDataFile file;
+    
+    invalidateDataFileStamp(&dictionaryFileStamp);
+    resetDictionary();
+    
+    if (!mapDataFile(DICTIONARY_FILE, DICTIONARY_STRING_LENGTH, &file)) {
+        return false;
+    }
+    
+    if (file.header->recordCount > MAX_DICTIONARY_SIZE) {
+        unmapDataFile(&file);
+        return false;
+    }
+    
+    // Rebuild the strings and hash table from the mapped records
+    char value[DICTIONARY_STRING_LENGTH];
+    int count = (int)file.header->recordCount;
+    dictionarySize = 0;
+    for (int i = 0; i < DICTIONARY_BUCKETS; i++) {
+        dictionaryBuckets[i] = -1;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        memcpy(value, file.payload + (size_t)i * DICTIONARY_STRING_LENGTH, DICTIONARY_STRING_LENGTH);
+        value[DICTIONARY_STRING_LENGTH - 1] = '\0';
+        addDictionaryString(value);
+    }
+    
+    unmapDataFile(&file);
+    
+    // A damaged file must not shift the well-known IDs
+    if (dictionarySize < 4 || strcmp(dictionaryStrings[STRING_ID_CASH], "Cash") != 0) {
+        resetDictionary();
+        return false;
+    }
+    
+    stampDataFile(DICTIONARY_FILE, &dictionaryFileStamp);
+    return true;
+}
\ No newline at end of file
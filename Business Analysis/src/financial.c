@@ -5,6 +5,10 @@
 
 #include "financial.h"
 #include "utils.h"
+#include "storage.h"
+#include "csv_writer.h"
+#include "json_writer.h"
+#include "columnar.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,170 +20,142 @@
 extern FinancialRecord financialRecords[MAX_ARRAY_SIZE];
 extern int financialRecordCount;
 
-// Function to run the financial analysis module
-void runFinancialAnalysis() {
-    int choice;
-    bool running = true;
-
-    // Load financial data
-    loadFinancialData();
-
-    while (running) {
-        clearScreen();
-        printf("\n\033[1;36m========================================\033[0m\n");
-        printf("\033[1;32m       FINANCIAL ANALYSIS\033[0m\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("1. Add Financial Record\n");
-        printf("2. View Financial Records\n");
-        printf("3. Generate Income Statement\n");
-        printf("4. Generate Expense Report\n");
-        printf("5. Generate Profit and Loss Report\n");
-        printf("6. Export Financial Data\n");
-        printf("7. Back to Main Menu\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        clearInputBuffer();
-
-        switch (choice) {
-            case 1: {
-                char date[20];
-                char category[30];
-                double amount;
-                char type[10];
-                char description[200];
-                
-                printf("\n\033[1;36m========================================\033[0m\n");
-                printf("\033[1;32m        ADD FINANCIAL RECORD\033[0m\n");
-                printf("\033[1;36m========================================\033[0m\n");
-                
-                printf("Enter date (YYYY-MM-DD): ");
-                fgets(date, sizeof(date), stdin);
-                date[strcspn(date, "\n")] = 0;
-                
-                printf("Enter category: ");
-                fgets(category, sizeof(category), stdin);
-                category[strcspn(category, "\n")] = 0;
-                
-                printf("Enter amount: ");
-                scanf("%lf", &amount);
-                clearInputBuffer();
-                
-                printf("Enter type (Income or Expense): ");
-                fgets(type, sizeof(type), stdin);
-                type[strcspn(type, "\n")] = 0;
-                
-                printf("Enter description: ");
-                fgets(description, sizeof(description), stdin);
-                description[strcspn(description, "\n")] = 0;
-                
-                if (addFinancialRecord(date, category, amount, type, description)) {
-                    displaySuccess("Financial record added successfully.");
-                } else {
-                    displayError("Failed to add financial record.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 2: {
-                char startDate[20], endDate[20];
-                
-                printf("Enter start date (YYYY-MM-DD, leave blank for all): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD, leave blank for all): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                displayFinancialRecords(
-                    strlen(startDate) > 0 ? startDate : NULL,
-                    strlen(endDate) > 0 ? endDate : NULL
-                );
-                pressEnterToContinue();
-                break;
-            }
-            case 3: {
-                char startDate[20], endDate[20];
-                
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                generateIncomeStatement(startDate, endDate);
-                pressEnterToContinue();
-                break;
-            }
-            case 4: {
-                char startDate[20], endDate[20];
-                
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                generateExpenseReport(startDate, endDate);
-                pressEnterToContinue();
-                break;
-            }
-            case 5: {
-                char startDate[20], endDate[20];
-                
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                generateProfitLossReport(startDate, endDate);
-                pressEnterToContinue();
-                break;
-            }
-            case 6: {
-                char filename[100];
-                char startDate[20], endDate[20];
-                
-                printf("Enter filename to export to: ");
-                fgets(filename, sizeof(filename), stdin);
-                filename[strcspn(filename, "\n")] = 0;
-                
-                printf("Enter start date (YYYY-MM-DD, leave blank for all): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD, leave blank for all): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                if (exportFinancialData(
-                        filename,
-                        strlen(startDate) > 0 ? startDate : NULL,
-                        strlen(endDate) > 0 ? endDate : NULL
-                    )) {
-                    displaySuccess("Financial data exported successfully.");
-                } else {
-                    displayError("Failed to export financial data.");
-                }
-                pressEnterToContinue();
-                break;
+// State of the financial file at the last load or save
+static DataFileStamp financialFileStamp;
+
+// Number of blocks needed to hold every financial record
+#define MAX_FINANCIAL_BLOCKS ((MAX_ARRAY_SIZE + FINANCIAL_BLOCK_RECORDS - 1) / FINANCIAL_BLOCK_RECORDS)
+
+// Zone maps of the blocks of the financial records array (block b holds records b * FINANCIAL_BLOCK_RECORDS onwards)
+static FinancialBlockHeader financialBlocks[MAX_FINANCIAL_BLOCKS];
+
+// Function to add a record to the zone map of its block
+static void addToFinancialBlock(int index) {
+    const FinancialRecord *record = &financialRecords[index];
+    FinancialBlockHeader *block = &financialBlocks[index / FINANCIAL_BLOCK_RECORDS];
+    
+    // The first record of a block starts a fresh zone map
+    if (index % FINANCIAL_BLOCK_RECORDS == 0) {
+        memset(block, 0, sizeof(FinancialBlockHeader));
+        strcpy(block->minDate, record->date);
+        strcpy(block->maxDate, record->date);
+    }
+    
+    if (strcmp(record->date, block->minDate) < 0) {
+        strcpy(block->minDate, record->date);
+    }
+    if (strcmp(record->date, block->maxDate) > 0) {
+        strcpy(block->maxDate, record->date);
+    }
+    
+    block->recordCount++;
+    
+    if (record->typeId == STRING_ID_INCOME) {
+        block->incomeCount++;
+        block->incomeTotal += record->amount;
+    } else if (record->typeId == STRING_ID_EXPENSE) {
+        block->expenseCount++;
+        block->expenseTotal += record->amount;
+    }
+    
+    if (record->categoryId < MAX_DICTIONARY_SIZE) {
+        block->categoryBitmap[record->categoryId / 64] |= (uint64_t)1 << (record->categoryId % 64);
+    }
+}
+
+// Function to rebuild every zone map from the financial records array
+static void rebuildFinancialBlocks() {
+    for (int i = 0; i < financialRecordCount; i++) {
+        addToFinancialBlock(i);
+    }
+}
+
+// Function to get the number of blocks in use
+static int getFinancialBlockCount() {
+    return (financialRecordCount + FINANCIAL_BLOCK_RECORDS - 1) / FINANCIAL_BLOCK_RECORDS;
+}
+
+// Function to check whether a block may hold records in a date range
+static bool blockOverlaps(const FinancialBlockHeader *block, const char *startDate, const char *endDate) {
+    if (startDate && strlen(startDate) > 0 && strcmp(block->maxDate, startDate) < 0) {
+        return false;
+    }
+    
+    if (endDate && strlen(endDate) > 0 && strcmp(block->minDate, endDate) > 0) {
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to check whether every record in a block falls in a date range
+static bool blockCovered(const FinancialBlockHeader *block, const char *startDate, const char *endDate) {
+    if (startDate && strlen(startDate) > 0 && strcmp(block->minDate, startDate) < 0) {
+        return false;
+    }
+    
+    if (endDate && strlen(endDate) > 0 && strcmp(block->maxDate, endDate) > 0) {
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to check whether a record falls in a date range
+static bool recordInPeriod(const FinancialRecord *record, const char *startDate, const char *endDate) {
+    if (startDate && strlen(startDate) > 0 && strcmp(record->date, startDate) < 0) {
+        return false;
+    }
+    
+    if (endDate && strlen(endDate) > 0 && strcmp(record->date, endDate) > 0) {
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to get the index one past the last record of a block
+static int getFinancialBlockEnd(int b) {
+    int end = (b + 1) * FINANCIAL_BLOCK_RECORDS;
+    return end < financialRecordCount ? end : financialRecordCount;
+}
+
+// Function to total one record type over a period, using block sums for fully covered blocks
+static double sumByType(const char *startDate, const char *endDate, uint32_t typeId) {
+    double total = 0.0;
+    int blockCount = getFinancialBlockCount();
+    
+    for (int b = 0; b < blockCount; b++) {
+        const FinancialBlockHeader *block = &financialBlocks[b];
+        
+        if (!blockOverlaps(block, startDate, endDate)) {
+            continue;
+        }
+        
+        // Only the blocks at the edges of the period need their records read
+        if (blockCovered(block, startDate, endDate)) {
+            total += typeId == STRING_ID_INCOME ? block->incomeTotal : block->expenseTotal;
+            continue;
+        }
+        
+        for (int i = b * FINANCIAL_BLOCK_RECORDS; i < getFinancialBlockEnd(b); i++) {
+            if (financialRecords[i].typeId == typeId && recordInPeriod(&financialRecords[i], startDate, endDate)) {
+                total += financialRecords[i].amount;
             }
-            case 7:
-                running = false;
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-                pressEnterToContinue();
         }
     }
+    
+    return total;
+}
+
+// Function to write the period line at the top of a report export
+static void writeCsvPeriodRow(CsvWriter *csv, const char *startDate, const char *endDate) {
+    char period[50];
+    
+    snprintf(period, sizeof(period), "%s to %s", startDate, endDate);
+    writeCsvText(csv, "Period");
+    writeCsvText(csv, period);
+    endCsvRow(csv);
 }
 
 // Function to add a new financial record
@@ -197,9 +173,9 @@ bool addFinancialRecord(const char *date, const char *category, double amount, c
     // Create new record
     FinancialRecord record;
     strcpy(record.date, date);
-    strcpy(record.category, category);
+    record.categoryId = internString(category);
     record.amount = amount;
-    strcpy(record.type, type);
+    record.typeId = internString(type);
     
     if (description && strlen(description) > 0) {
         strcpy(record.description, description);
@@ -207,67 +183,37 @@ bool addFinancialRecord(const char *date, const char *category, double amount, c
         strcpy(record.description, "");
     }
     
-    // Add record to array
+    // Add record to array and to its block's zone map
     financialRecords[financialRecordCount++] = record;
+    addToFinancialBlock(financialRecordCount - 1);
     
     // Save data
     return saveFinancialData();
 }
 
-// Function to calculate income for a given period
-double calculateIncome(const char *startDate, const char *endDate) {
-    double total = 0.0;
+// Function to add a batch of financial records and save them once
+bool appendFinancialRecords(const FinancialRecord *records, int count) {
+    if (financialRecordCount + count > MAX_ARRAY_SIZE) {
+        displayError("Financial records are full. Cannot add more records.");
+        return false;
+    }
     
-    for (int i = 0; i < financialRecordCount; i++) {
-        // Apply date filters
-        bool include = true;
-        
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(financialRecords[i].date, startDate) < 0) {
-                include = false;
-            }
-        }
-        
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(financialRecords[i].date, endDate) > 0) {
-                include = false;
-            }
-        }
-        
-        if (include && strcmp(financialRecords[i].type, "Income") == 0) {
-            total += financialRecords[i].amount;
-        }
+    for (int i = 0; i < count; i++) {
+        financialRecords[financialRecordCount++] = records[i];
+        addToFinancialBlock(financialRecordCount - 1);
     }
     
-    return total;
+    return saveFinancialData();
+}
+
+// Function to calculate income for a given period
+double calculateIncome(const char *startDate, const char *endDate) {
+    return sumByType(startDate, endDate, STRING_ID_INCOME);
 }
 
 // Function to calculate expenses for a given period
 double calculateExpenses(const char *startDate, const char *endDate) {
-    double total = 0.0;
-    
-    for (int i = 0; i < financialRecordCount; i++) {
-        // Apply date filters
-        bool include = true;
-        
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(financialRecords[i].date, startDate) < 0) {
-                include = false;
-            }
-        }
-        
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(financialRecords[i].date, endDate) > 0) {
-                include = false;
-            }
-        }
-        
-        if (include && strcmp(financialRecords[i].type, "Expense") == 0) {
-            total += financialRecords[i].amount;
-        }
-    }
-    
-    return total;
+    return sumByType(startDate, endDate, STRING_ID_EXPENSE);
 }
 
 // Function to calculate profit for a given period
@@ -290,634 +236,547 @@ double calculateProfitMargin(const char *startDate, const char *endDate) {
     }
 }
 
-// Function to generate income statement for a given period
-void generateIncomeStatement(const char *startDate, const char *endDate) {
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m        INCOME STATEMENT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    printf("Period: %s to %s\n\n", startDate, endDate);
-    
-    // Calculate totals
-    double totalIncome = calculateIncome(startDate, endDate);
-    double totalExpenses = calculateExpenses(startDate, endDate);
-    double profit = totalIncome - totalExpenses;
-    double profitMargin = totalIncome > 0 ? (profit / totalIncome) * 100.0 : 0.0;
+// Function to total one record type per category in first-seen order
+static int sumByCategory(const char *startDate, const char *endDate, uint32_t typeId,
+                         CategoryTotal *categories) {
+    // Map dictionary IDs straight to output rows instead of comparing names
+    int rowForId[MAX_DICTIONARY_SIZE];
+    int categoryCount = 0;
     
-    // Income breakdown by category
-    printf("INCOME\n");
-    printf("----------------------------------------------\n");
+    for (int i = 0; i < MAX_DICTIONARY_SIZE; i++) {
+        rowForId[i] = -1;
+    }
     
-    // Get income categories
-    char categories[MAX_ARRAY_SIZE][30];
-    double categoryTotals[MAX_ARRAY_SIZE] = {0.0};
-    int categoryCount = 0;
+    int blockCount = getFinancialBlockCount();
     
-    for (int i = 0; i < financialRecordCount; i++) {
-        // Apply date filters
-        bool include = true;
+    for (int b = 0; b < blockCount; b++) {
+        const FinancialBlockHeader *block = &financialBlocks[b];
         
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(financialRecords[i].date, startDate) < 0) {
-                include = false;
-            }
-        }
+        // Skip blocks outside the period or without any record of this type
+        int typeCount = typeId == STRING_ID_INCOME ? block->incomeCount :
+                        typeId == STRING_ID_EXPENSE ? block->expenseCount : block->recordCount;
         
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(financialRecords[i].date, endDate) > 0) {
-                include = false;
-            }
+        if (typeCount == 0 || !blockOverlaps(block, startDate, endDate)) {
+            continue;
         }
         
-        if (include && strcmp(financialRecords[i].type, "Income") == 0) {
-            // Check if category already exists
-            bool categoryExists = false;
-            for (int j = 0; j < categoryCount; j++) {
-                if (strcmp(categories[j], financialRecords[i].category) == 0) {
-                    categoryTotals[j] += financialRecords[i].amount;
-                    categoryExists = true;
-                    break;
-                }
+        bool covered = blockCovered(block, startDate, endDate);
+        
+        for (int i = b * FINANCIAL_BLOCK_RECORDS; i < getFinancialBlockEnd(b); i++) {
+            const FinancialRecord *record = &financialRecords[i];
+            
+            if (record->typeId != typeId || record->categoryId >= MAX_DICTIONARY_SIZE) {
+                continue;
             }
             
-            if (!categoryExists && categoryCount < MAX_ARRAY_SIZE) {
-                strcpy(categories[categoryCount], financialRecords[i].category);
-                categoryTotals[categoryCount] = financialRecords[i].amount;
-                categoryCount++;
+            // Apply date filters
+            if (!covered && !recordInPeriod(record, startDate, endDate)) {
+                continue;
             }
+            
+            int row = rowForId[record->categoryId];
+            if (row < 0) {
+                if (categoryCount >= MAX_ARRAY_SIZE) {
+                    continue;
+                }
+                
+                row = categoryCount++;
+                rowForId[record->categoryId] = row;
+                categories[row].categoryId = record->categoryId;
+                categories[row].amount = 0.0;
+                categories[row].percentage = 0.0;
+            }
+            
+            categories[row].amount += record->amount;
         }
     }
     
-    // Display income categories
+    return categoryCount;
+}
+
+// Function to compute the income, expenses and profit of a period
+static void buildFinancialSummary(const char *startDate, const char *endDate, FinancialSummary *summary) {
+    summary->totalIncome = calculateIncome(startDate, endDate);
+    summary->totalExpenses = calculateExpenses(startDate, endDate);
+    summary->profit = summary->totalIncome - summary->totalExpenses;
+    summary->profitMargin = summary->totalIncome > 0 ? (summary->profit / summary->totalIncome) * 100.0 : 0.0;
+}
+
+// Function to total one record type per category, with each category's share of the total
+static int buildCategoryTotals(const char *startDate, const char *endDate, uint32_t typeId,
+                               double total, CategoryTotal *categories) {
+    int categoryCount = sumByCategory(startDate, endDate, typeId, categories);
+    
     for (int i = 0; i < categoryCount; i++) {
-        printf("%-30s $%10.2f\n", categories[i], categoryTotals[i]);
+        categories[i].percentage = (categories[i].amount / total) * 100.0;
     }
     
-    printf("----------------------------------------------\n");
-    printf("%-30s $%10.2f\n\n", "Total Income", totalIncome);
-    
-    // Expense breakdown by category
-    printf("EXPENSES\n");
-    printf("----------------------------------------------\n");
+    return categoryCount;
+}
+
+// Function to compute the income statement for a given period
+void buildIncomeStatement(const char *startDate, const char *endDate, IncomeStatement *statement) {
+    buildFinancialSummary(startDate, endDate, &statement->summary);
+    
+    statement->incomeCategoryCount = buildCategoryTotals(startDate, endDate, STRING_ID_INCOME,
+                                                         statement->summary.totalIncome,
+                                                         statement->incomeCategories);
+    statement->expenseCategoryCount = buildCategoryTotals(startDate, endDate, STRING_ID_EXPENSE,
+                                                          statement->summary.totalExpenses,
+                                                          statement->expenseCategories);
+}
+
+// Function to compute the expense report for a given period
+void buildExpenseReport(const char *startDate, const char *endDate, ExpenseReport *report) {
+    report->totalExpenses = calculateExpenses(startDate, endDate);
+    report->categoryCount = buildCategoryTotals(startDate, endDate, STRING_ID_EXPENSE,
+                                                report->totalExpenses, report->categories);
+}
+
+// Function to compute the profit and loss report for a given period
+void buildProfitLossReport(const char *startDate, const char *endDate, ProfitLossReport *report) {
+    buildFinancialSummary(startDate, endDate, &report->summary);
+    report->monthCount = 0;
     
-    // Reset for expenses
-    memset(categories, 0, sizeof(categories));
-    memset(categoryTotals, 0, sizeof(categoryTotals));
-    categoryCount = 0;
+    // Only visit the blocks whose zone maps overlap the period
+    int slots[MAX_ARRAY_SIZE];
+    int slotCount = findFinancialRecordCandidates(startDate, endDate, INVALID_STRING_ID, slots, MAX_ARRAY_SIZE);
     
-    for (int i = 0; i < financialRecordCount; i++) {
-        // Apply date filters
-        bool include = true;
+    for (int s = 0; s < slotCount; s++) {
+        const FinancialRecord *record = &financialRecords[slots[s]];
         
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(financialRecords[i].date, startDate) < 0) {
-                include = false;
-            }
+        // Apply date filters
+        if (!recordInPeriod(record, startDate, endDate)) {
+            continue;
         }
         
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(financialRecords[i].date, endDate) > 0) {
-                include = false;
+        // Extract month (YYYY-MM)
+        char month[8];
+        strncpy(month, record->date, 7);
+        month[7] = '\0';
+        
+        // Find the month's row, adding it if this is its first record
+        int row = -1;
+        for (int j = 0; j < report->monthCount; j++) {
+            if (strcmp(report->months[j].month, month) == 0) {
+                row = j;
+                break;
             }
         }
         
-        if (include && strcmp(financialRecords[i].type, "Expense") == 0) {
-            // Check if category already exists
-            bool categoryExists = false;
-            for (int j = 0; j < categoryCount; j++) {
-                if (strcmp(categories[j], financialRecords[i].category) == 0) {
-                    categoryTotals[j] += financialRecords[i].amount;
-                    categoryExists = true;
-                    break;
-                }
+        if (row < 0) {
+            if (report->monthCount >= MAX_ARRAY_SIZE) {
+                continue;
             }
             
-            if (!categoryExists && categoryCount < MAX_ARRAY_SIZE) {
-                strcpy(categories[categoryCount], financialRecords[i].category);
-                categoryTotals[categoryCount] = financialRecords[i].amount;
-                categoryCount++;
-            }
+            row = report->monthCount++;
+            strcpy(report->months[row].month, month);
+            report->months[row].income = 0.0;
+            report->months[row].expenses = 0.0;
+        }
+        
+        if (record->typeId == STRING_ID_INCOME) {
+            report->months[row].income += record->amount;
+        } else if (record->typeId == STRING_ID_EXPENSE) {
+            report->months[row].expenses += record->amount;
         }
     }
     
-    // Display expense categories
-    for (int i = 0; i < categoryCount; i++) {
-        printf("%-30s $%10.2f\n", categories[i], categoryTotals[i]);
+    // Sort months (simple bubble sort)
+    for (int i = 0; i < report->monthCount - 1; i++) {
+        for (int j = 0; j < report->monthCount - i - 1; j++) {
+            if (strcmp(report->months[j].month, report->months[j + 1].month) > 0) {
+                MonthlyTotal temp = report->months[j];
+                report->months[j] = report->months[j + 1];
+                report->months[j + 1] = temp;
+            }
+        }
     }
     
-    printf("----------------------------------------------\n");
-    printf("%-30s $%10.2f\n\n", "Total Expenses", totalExpenses);
-    
-    // Net profit
-    printf("SUMMARY\n");
-    printf("----------------------------------------------\n");
-    printf("%-30s $%10.2f\n", "Total Income", totalIncome);
-    printf("%-30s $%10.2f\n", "Total Expenses", totalExpenses);
-    printf("%-30s $%10.2f\n", "Net Profit/Loss", profit);
-    printf("%-30s %10.1f%%\n", "Profit Margin", profitMargin);
-    
-    // Export option
-    printf("\nWould you like to export this statement to a CSV file? (y/n): ");
-    char exportChoice;
-    scanf("%c", &exportChoice);
-    clearInputBuffer();
-    
-    if (exportChoice == 'y' || exportChoice == 'Y') {
-        char filename[100];
-        snprintf(filename, sizeof(filename), "income_statement_%s_%s.csv", startDate, endDate);
+    for (int i = 0; i < report->monthCount; i++) {
+        report->months[i].profit = report->months[i].income - report->months[i].expenses;
+    }
+}
+
+// Function to find the expense records of a period, in file order
+static int findExpensesInPeriod(const char *startDate, const char *endDate, int *slots) {
+    // Only visit the blocks whose zone maps overlap the period
+    int candidates[MAX_ARRAY_SIZE];
+    int candidateCount = findFinancialRecordCandidates(startDate, endDate, INVALID_STRING_ID, candidates, MAX_ARRAY_SIZE);
+    int count = 0;
+    
+    for (int s = 0; s < candidateCount; s++) {
+        const FinancialRecord *record = &financialRecords[candidates[s]];
         
-        FILE *file = fopen(filename, "w");
-        if (file) {
-            fprintf(file, "INCOME STATEMENT\n");
-            fprintf(file, "Period,%s to %s\n\n", startDate, endDate);
-            
-            fprintf(file, "INCOME\n");
-            
-            // Reset for CSV export
-            memset(categories, 0, sizeof(categories));
-            memset(categoryTotals, 0, sizeof(categoryTotals));
-            categoryCount = 0;
-            
-            for (int i = 0; i < financialRecordCount; i++) {
-                // Apply date filters
-                bool include = true;
-                
-                if (startDate && strlen(startDate) > 0) {
-                    if (strcmp(financialRecords[i].date, startDate) < 0) {
-                        include = false;
-                    }
-                }
-                
-                if (endDate && strlen(endDate) > 0) {
-                    if (strcmp(financialRecords[i].date, endDate) > 0) {
-                        include = false;
-                    }
-                }
-                
-                if (include && strcmp(financialRecords[i].type, "Income") == 0) {
-                    // Check if category already exists
-                    bool categoryExists = false;
-                    for (int j = 0; j < categoryCount; j++) {
-                        if (strcmp(categories[j], financialRecords[i].category) == 0) {
-                            categoryTotals[j] += financialRecords[i].amount;
-                            categoryExists = true;
-                            break;
-                        }
-                    }
-                    
-                    if (!categoryExists && categoryCount < MAX_ARRAY_SIZE) {
-                        strcpy(categories[categoryCount], financialRecords[i].category);
-                        categoryTotals[categoryCount] = financialRecords[i].amount;
-                        categoryCount++;
-                    }
-                }
-            }
-            
-            // Write income categories
-            for (int i = 0; i < categoryCount; i++) {
-                fprintf(file, "%s,$%.2f\n", categories[i], categoryTotals[i]);
-            }
-            
-            fprintf(file, "Total Income,$%.2f\n\n", totalIncome);
-            
-            fprintf(file, "EXPENSES\n");
-            
-            // Reset for expenses CSV export
-            memset(categories, 0, sizeof(categories));
-            memset(categoryTotals, 0, sizeof(categoryTotals));
-            categoryCount = 0;
-            
-            for (int i = 0; i < financialRecordCount; i++) {
-                // Apply date filters
-                bool include = true;
-                
-                if (startDate && strlen(startDate) > 0) {
-                    if (strcmp(financialRecords[i].date, startDate) < 0) {
-                        include = false;
-                    }
-                }
-                
-                if (endDate && strlen(endDate) > 0) {
-                    if (strcmp(financialRecords[i].date, endDate) > 0) {
-                        include = false;
-                    }
-                }
-                
-                if (include && strcmp(financialRecords[i].type, "Expense") == 0) {
-                    // Check if category already exists
-                    bool categoryExists = false;
-                    for (int j = 0; j < categoryCount; j++) {
-                        if (strcmp(categories[j], financialRecords[i].category) == 0) {
-                            categoryTotals[j] += financialRecords[i].amount;
-                            categoryExists = true;
-                            break;
-                        }
-                    }
-                    
-                    if (!categoryExists && categoryCount < MAX_ARRAY_SIZE) {
-                        strcpy(categories[categoryCount], financialRecords[i].category);
-                        categoryTotals[categoryCount] = financialRecords[i].amount;
-                        categoryCount++;
-                    }
-                }
-            }
-            
-            // Write expense categories
-            for (int i = 0; i < categoryCount; i++) {
-                fprintf(file, "%s,$%.2f\n", categories[i], categoryTotals[i]);
-            }
-            
-            fprintf(file, "Total Expenses,$%.2f\n\n", totalExpenses);
-            
-            fprintf(file, "SUMMARY\n");
-            fprintf(file, "Total Income,$%.2f\n", totalIncome);
-            fprintf(file, "Total Expenses,$%.2f\n", totalExpenses);
-            fprintf(file, "Net Profit/Loss,$%.2f\n", profit);
-            fprintf(file, "Profit Margin,%.1f%%\n", profitMargin);
-            
-            fclose(file);
-            printf("Statement exported to %s\n", filename);
-        } else {
-            printf("Failed to export statement.\n");
+        if (record->typeId == STRING_ID_EXPENSE && recordInPeriod(record, startDate, endDate)) {
+            slots[count++] = candidates[s];
         }
     }
+    
+    return count;
+}
+
+// Function to write the income, expenses and profit of a period as summary rows
+static void writeCsvSummaryRows(CsvWriter *csv, const FinancialSummary *summary) {
+    writeCsvRaw(csv, "SUMMARY\n");
+    writeCsvMoneyRow(csv, "Total Income", summary->totalIncome);
+    writeCsvMoneyRow(csv, "Total Expenses", summary->totalExpenses);
+    writeCsvMoneyRow(csv, "Net Profit/Loss", summary->profit);
+    writeCsvPercentRow(csv, "Profit Margin", summary->profitMargin);
 }
 
-// Function to generate expense report for a given period
-void generateExpenseReport(const char *startDate, const char *endDate) {
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m        EXPENSE REPORT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    printf("Period: %s to %s\n\n", startDate, endDate);
+// Function to export the income statement to a CSV file
+bool exportIncomeStatementCsv(const char *filename, const char *startDate, const char *endDate,
+                              const IncomeStatement *statement) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, filename)) {
+        return false;
+    }
     
-    // Calculate total expenses
-    double totalExpenses = calculateExpenses(startDate, endDate);
+    writeCsvRaw(&csv, "INCOME STATEMENT\n");
+    writeCsvPeriodRow(&csv, startDate, endDate);
+    writeCsvRaw(&csv, "\n");
     
-    // Expense breakdown by category
-    printf("EXPENSE BREAKDOWN\n");
-    printf("----------------------------------------------\n");
+    writeCsvRaw(&csv, "INCOME\n");
     
-    // Get expense categories
-    char categories[MAX_ARRAY_SIZE][30];
-    double categoryTotals[MAX_ARRAY_SIZE] = {0.0};
-    int categoryCount = 0;
+    // Write income categories
+    for (int i = 0; i < statement->incomeCategoryCount; i++) {
+        writeCsvMoneyRow(&csv, lookupString(statement->incomeCategories[i].categoryId),
+                         statement->incomeCategories[i].amount);
+    }
     
-    for (int i = 0; i < financialRecordCount; i++) {
-        // Apply date filters
-        bool include = true;
-        
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(financialRecords[i].date, startDate) < 0) {
-                include = false;
-            }
-        }
-        
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(financialRecords[i].date, endDate) > 0) {
-                include = false;
-            }
-        }
-        
-        if (include && strcmp(financialRecords[i].type, "Expense") == 0) {
-            // Check if category already exists
-            bool categoryExists = false;
-            for (int j = 0; j < categoryCount; j++) {
-                if (strcmp(categories[j], financialRecords[i].category) == 0) {
-                    categoryTotals[j] += financialRecords[i].amount;
-                    categoryExists = true;
-                    break;
-                }
-            }
-            
-            if (!categoryExists && categoryCount < MAX_ARRAY_SIZE) {
-                strcpy(categories[categoryCount], financialRecords[i].category);
-                categoryTotals[categoryCount] = financialRecords[i].amount;
-                categoryCount++;
-            }
-        }
+    writeCsvMoneyRow(&csv, "Total Income", statement->summary.totalIncome);
+    writeCsvRaw(&csv, "\n");
+    
+    writeCsvRaw(&csv, "EXPENSES\n");
+    
+    // Write expense categories
+    for (int i = 0; i < statement->expenseCategoryCount; i++) {
+        writeCsvMoneyRow(&csv, lookupString(statement->expenseCategories[i].categoryId),
+                         statement->expenseCategories[i].amount);
     }
     
-    // Display expense categories with percentage
-    for (int i = 0; i < categoryCount; i++) {
-        double percentage = (categoryTotals[i] / totalExpenses) * 100.0;
-        printf("%-30s $%10.2f (%5.1f%%)\n", categories[i], categoryTotals[i], percentage);
+    writeCsvMoneyRow(&csv, "Total Expenses", statement->summary.totalExpenses);
+    writeCsvRaw(&csv, "\n");
+    
+    writeCsvSummaryRows(&csv, &statement->summary);
+    
+    return closeCsvWriter(&csv);
+}
+
+// Function to export the expense report and the expense records of the period to a CSV file
+bool exportExpenseReportCsv(const char *filename, const char *startDate, const char *endDate,
+                            const ExpenseReport *report) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, filename)) {
+        return false;
     }
     
-    printf("----------------------------------------------\n");
-    printf("%-30s $%10.2f (100.0%%)\n", "Total Expenses", totalExpenses);
+    writeCsvRaw(&csv, "EXPENSE REPORT\n");
+    writeCsvPeriodRow(&csv, startDate, endDate);
+    writeCsvRaw(&csv, "\n");
     
-    // Export option
-    printf("\nWould you like to export this report to a CSV file? (y/n): ");
-    char exportChoice;
-    scanf("%c", &exportChoice);
-    clearInputBuffer();
+    writeCsvRaw(&csv, "EXPENSE BREAKDOWN\n");
+    writeCsvRaw(&csv, "Category,Amount,Percentage\n");
     
-    if (exportChoice == 'y' || exportChoice == 'Y') {
-        char filename[100];
-        snprintf(filename, sizeof(filename), "expense_report_%s_%s.csv", startDate, endDate);
+    // Write expense categories
+    for (int i = 0; i < report->categoryCount; i++) {
+        writeCsvText(&csv, lookupString(report->categories[i].categoryId));
+        writeCsvMoney(&csv, report->categories[i].amount);
+        writeCsvPercent(&csv, report->categories[i].percentage);
+        endCsvRow(&csv);
+    }
+    
+    writeCsvText(&csv, "Total Expenses");
+    writeCsvMoney(&csv, report->totalExpenses);
+    writeCsvPercent(&csv, 100.0);
+    endCsvRow(&csv);
+    writeCsvRaw(&csv, "\n");
+    
+    writeCsvRaw(&csv, "EXPENSE DETAILS\n");
+    writeCsvRaw(&csv, "Date,Category,Amount,Description\n");
+    
+    // Write expense details
+    int slots[MAX_ARRAY_SIZE];
+    int slotCount = findExpensesInPeriod(startDate, endDate, slots);
+    
+    for (int s = 0; s < slotCount; s++) {
+        const FinancialRecord *record = &financialRecords[slots[s]];
         
-        FILE *file = fopen(filename, "w");
-        if (file) {
-            fprintf(file, "EXPENSE REPORT\n");
-            fprintf(file, "Period,%s to %s\n\n", startDate, endDate);
-            
-            fprintf(file, "EXPENSE BREAKDOWN\n");
-            fprintf(file, "Category,Amount,Percentage\n");
-            
-            // Write expense categories
-            for (int i = 0; i < categoryCount; i++) {
-                double percentage = (categoryTotals[i] / totalExpenses) * 100.0;
-                fprintf(file, "%s,$%.2f,%.1f%%\n", categories[i], categoryTotals[i], percentage);
-            }
-            
-            fprintf(file, "Total Expenses,$%.2f,100.0%%\n\n", totalExpenses);
-            
-            fprintf(file, "EXPENSE DETAILS\n");
-            fprintf(file, "Date,Category,Amount,Description\n");
-            
-            // Write expense details
-            for (int i = 0; i < financialRecordCount; i++) {
-                // Apply date filters
-                bool include = true;
-                
-                if (startDate && strlen(startDate) > 0) {
-                    if (strcmp(financialRecords[i].date, startDate) < 0) {
-                        include = false;
-                    }
-                }
-                
-                if (endDate && strlen(endDate) > 0) {
-                    if (strcmp(financialRecords[i].date, endDate) > 0) {
-                        include = false;
-                    }
-                }
-                
-                if (include && strcmp(financialRecords[i].type, "Expense") == 0) {
-                    fprintf(file, "%s,%s,$%.2f,%s\n", 
-                           financialRecords[i].date,
-                           financialRecords[i].category,
-                           financialRecords[i].amount,
-                           financialRecords[i].description);
-                }
-            }
-            
-            fclose(file);
-            printf("Report exported to %s\n", filename);
-        } else {
-            printf("Failed to export report.\n");
-        }
+        writeCsvText(&csv, record->date);
+        writeCsvText(&csv, lookupString(record->categoryId));
+        writeCsvMoney(&csv, record->amount);
+        writeCsvText(&csv, record->description);
+        endCsvRow(&csv);
     }
+    
+    return closeCsvWriter(&csv);
 }
 
-// Function to generate profit and loss report for a given period
-void generateProfitLossReport(const char *startDate, const char *endDate) {
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m      PROFIT AND LOSS REPORT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    printf("Period: %s to %s\n\n", startDate, endDate);
+// Function to export the profit and loss report to a CSV file
+bool exportProfitLossReportCsv(const char *filename, const char *startDate, const char *endDate,
+                               const ProfitLossReport *report) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, filename)) {
+        return false;
+    }
     
-    // Calculate totals
-    double totalIncome = calculateIncome(startDate, endDate);
-    double totalExpenses = calculateExpenses(startDate, endDate);
-    double profit = totalIncome - totalExpenses;
-    double profitMargin = totalIncome > 0 ? (profit / totalIncome) * 100.0 : 0.0;
+    writeCsvRaw(&csv, "PROFIT AND LOSS REPORT\n");
+    writeCsvPeriodRow(&csv, startDate, endDate);
+    writeCsvRaw(&csv, "\n");
     
-    printf("SUMMARY\n");
-    printf("----------------------------------------------\n");
-    printf("%-30s $%10.2f\n", "Total Income", totalIncome);
-    printf("%-30s $%10.2f\n", "Total Expenses", totalExpenses);
-    printf("%-30s $%10.2f\n", "Net Profit/Loss", profit);
-    printf("%-30s %10.1f%%\n\n", "Profit Margin", profitMargin);
+    writeCsvSummaryRows(&csv, &report->summary);
+    writeCsvRaw(&csv, "\n");
     
-    // Monthly breakdown
-    printf("MONTHLY BREAKDOWN\n");
-    printf("----------------------------------------------\n");
-    printf("%-10s %-12s %-12s %-12s\n", "Month", "Income", "Expenses", "Profit/Loss");
-    printf("----------------------------------------------\n");
+    writeCsvRaw(&csv, "MONTHLY BREAKDOWN\n");
+    writeCsvRaw(&csv, "Month,Income,Expenses,Profit/Loss\n");
     
-    // Get unique months in the period
-    char months[MAX_ARRAY_SIZE][10];
-    double monthlyIncome[MAX_ARRAY_SIZE] = {0.0};
-    double monthlyExpenses[MAX_ARRAY_SIZE] = {0.0};
-    int monthCount = 0;
+    // Write monthly breakdown
+    for (int i = 0; i < report->monthCount; i++) {
+        writeCsvText(&csv, report->months[i].month);
+        writeCsvMoney(&csv, report->months[i].income);
+        writeCsvMoney(&csv, report->months[i].expenses);
+        writeCsvMoney(&csv, report->months[i].profit);
+        endCsvRow(&csv);
+    }
     
-    for (int i = 0; i < financialRecordCount; i++) {
-        // Apply date filters
-        bool include = true;
-        
-        if (startDate && strlen(startDate) > 0) {
-            if (strcmp(financialRecords[i].date, startDate) < 0) {
-                include = false;
-            }
-        }
-        
-        if (endDate && strlen(endDate) > 0) {
-            if (strcmp(financialRecords[i].date, endDate) > 0) {
-                include = false;
-            }
-        }
-        
-        if (include) {
-            // Extract month (YYYY-MM)
-            char month[10];
-            strncpy(month, financialRecords[i].date, 7);
-            month[7] = '\0';
-            
-            // Check if month already exists
-            bool monthExists = false;
-            for (int j = 0; j < monthCount; j++) {
-                if (strcmp(months[j], month) == 0) {
-                    if (strcmp(financialRecords[i].type, "Income") == 0) {
-                        monthlyIncome[j] += financialRecords[i].amount;
-                    } else if (strcmp(financialRecords[i].type, "Expense") == 0) {
-                        monthlyExpenses[j] += financialRecords[i].amount;
-                    }
-                    monthExists = true;
-                    break;
-                }
-            }
-            
-            if (!monthExists && monthCount < MAX_ARRAY_SIZE) {
-                strcpy(months[monthCount], month);
-                
-                if (strcmp(financialRecords[i].type, "Income") == 0) {
-                    monthlyIncome[monthCount] = financialRecords[i].amount;
-                } else if (strcmp(financialRecords[i].type, "Expense") == 0) {
-                    monthlyExpenses[monthCount] = financialRecords[i].amount;
-                }
-                
-                monthCount++;
-            }
-        }
+    return closeCsvWriter(&csv);
+}
+
+// Function to write the income, expenses and profit of a period as a summary record
+static void writeJsonSummaryRecord(JsonWriter *json, const FinancialSummary *summary) {
+    beginJsonRecord(json, "summary");
+    writeJsonNumber(json, "totalIncome", summary->totalIncome, 2);
+    writeJsonNumber(json, "totalExpenses", summary->totalExpenses, 2);
+    writeJsonNumber(json, "profit", summary->profit, 2);
+    writeJsonNumber(json, "profitMargin", summary->profitMargin, 2);
+    endJsonRecord(json);
+}
+
+// Function to write category totals as one record each
+static void writeJsonCategoryRecords(JsonWriter *json, const char *type,
+                                     const CategoryTotal *categories, int categoryCount) {
+    for (int i = 0; i < categoryCount; i++) {
+        beginJsonRecord(json, type);
+        writeJsonString(json, "category", lookupString(categories[i].categoryId));
+        writeJsonNumber(json, "amount", categories[i].amount, 2);
+        writeJsonNumber(json, "percentage", categories[i].percentage, 2);
+        endJsonRecord(json);
     }
+}
+
+// Function to write the income statement as JSON or NDJSON
+bool writeIncomeStatementJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited) {
+    IncomeStatement statement;
+    buildIncomeStatement(startDate, endDate, &statement);
     
-    // Sort months (simple bubble sort)
-    for (int i = 0; i < monthCount - 1; i++) {
-        for (int j = 0; j < monthCount - i - 1; j++) {
-            if (strcmp(months[j], months[j + 1]) > 0) {
-                // Swap months
-                char tempMonth[10];
-                strcpy(tempMonth, months[j]);
-                strcpy(months[j], months[j + 1]);
-                strcpy(months[j + 1], tempMonth);
-                
-                // Swap income
-                double tempIncome = monthlyIncome[j];
-                monthlyIncome[j] = monthlyIncome[j + 1];
-                monthlyIncome[j + 1] = tempIncome;
-                
-                // Swap expenses
-                double tempExpenses = monthlyExpenses[j];
-                monthlyExpenses[j] = monthlyExpenses[j + 1];
-                monthlyExpenses[j + 1] = tempExpenses;
-            }
-        }
+    JsonWriter json;
+    if (!openJsonReport(&json, path, lineDelimited, "income_statement", startDate, endDate)) {
+        return false;
     }
     
-    // Display monthly breakdown
-    for (int i = 0; i < monthCount; i++) {
-        double monthlyProfit = monthlyIncome[i] - monthlyExpenses[i];
-        printf("%-10s $%-11.2f $%-11.2f $%-11.2f\n", 
-               months[i], 
-               monthlyIncome[i], 
-               monthlyExpenses[i], 
-               monthlyProfit);
+    writeJsonSummaryRecord(&json, &statement.summary);
+    writeJsonCategoryRecords(&json, "income", statement.incomeCategories, statement.incomeCategoryCount);
+    writeJsonCategoryRecords(&json, "expense", statement.expenseCategories, statement.expenseCategoryCount);
+    
+    return closeJsonReport(&json);
+}
+
+// Function to write the expense report as JSON or NDJSON
+bool writeExpenseReportJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited) {
+    ExpenseReport report;
+    buildExpenseReport(startDate, endDate, &report);
+    
+    JsonWriter json;
+    if (!openJsonReport(&json, path, lineDelimited, "expense_report", startDate, endDate)) {
+        return false;
     }
     
-    // Export option
-    printf("\nWould you like to export this report to a CSV file? (y/n): ");
-    char exportChoice;
-    scanf("%c", &exportChoice);
-    clearInputBuffer();
+    beginJsonRecord(&json, "summary");
+    writeJsonNumber(&json, "totalExpenses", report.totalExpenses, 2);
+    endJsonRecord(&json);
     
-    if (exportChoice == 'y' || exportChoice == 'Y') {
-        char filename[100];
-        snprintf(filename, sizeof(filename), "profit_loss_report_%s_%s.csv", startDate, endDate);
+    writeJsonCategoryRecords(&json, "category", report.categories, report.categoryCount);
+    
+    // Stream the expense records straight from the store
+    int slots[MAX_ARRAY_SIZE];
+    int slotCount = findExpensesInPeriod(startDate, endDate, slots);
+    
+    for (int s = 0; s < slotCount; s++) {
+        const FinancialRecord *record = &financialRecords[slots[s]];
         
-        FILE *file = fopen(filename, "w");
-        if (file) {
-            fprintf(file, "PROFIT AND LOSS REPORT\n");
-            fprintf(file, "Period,%s to %s\n\n", startDate, endDate);
-            
-            fprintf(file, "SUMMARY\n");
-            fprintf(file, "Total Income,$%.2f\n", totalIncome);
-            fprintf(file, "Total Expenses,$%.2f\n", totalExpenses);
-            fprintf(file, "Net Profit/Loss,$%.2f\n", profit);
-            fprintf(file, "Profit Margin,%.1f%%\n\n", profitMargin);
-            
-            fprintf(file, "MONTHLY BREAKDOWN\n");
-            fprintf(file, "Month,Income,Expenses,Profit/Loss\n");
-            
-            // Write monthly breakdown
-            for (int i = 0; i < monthCount; i++) {
-                double monthlyProfit = monthlyIncome[i] - monthlyExpenses[i];
-                fprintf(file, "%s,$%.2f,$%.2f,$%.2f\n", 
-                       months[i], 
-                       monthlyIncome[i], 
-                       monthlyExpenses[i], 
-                       monthlyProfit);
-            }
-            
-            fclose(file);
-            printf("Report exported to %s\n", filename);
-        } else {
-            printf("Failed to export report.\n");
-        }
+        beginJsonRecord(&json, "expense");
+        writeJsonString(&json, "date", record->date);
+        writeJsonString(&json, "category", lookupString(record->categoryId));
+        writeJsonNumber(&json, "amount", record->amount, 2);
+        writeJsonString(&json, "description", record->description);
+        endJsonRecord(&json);
     }
+    
+    return closeJsonReport(&json);
 }
 
-// Function to display financial records for a given period
-void displayFinancialRecords(const char *startDate, const char *endDate) {
-    if (financialRecordCount == 0) {
-        printf("No financial records available.\n");
-        return;
-    }
+// Function to write the profit and loss report as JSON or NDJSON
+bool writeProfitLossReportJson(const char *path, const char *startDate, const char *endDate, bool lineDelimited) {
+    ProfitLossReport report;
+    buildProfitLossReport(startDate, endDate, &report);
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m        FINANCIAL RECORDS\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    printf("Period: %s to %s\n\n", 
-           startDate ? startDate : "All time",
-           endDate ? endDate : "Present");
+    JsonWriter json;
+    if (!openJsonReport(&json, path, lineDelimited, "profit_loss", startDate, endDate)) {
+        return false;
+    }
     
-    printf("%-10s %-15s %-10s %-10s %s\n", 
-           "Date", "Category", "Amount", "Type", "Description");
-    printf("--------------------------------------------------------------------------------------------------------\n");
+    writeJsonSummaryRecord(&json, &report.summary);
     
-    int recordsDisplayed = 0;
+    for (int i = 0; i < report.monthCount; i++) {
+        beginJsonRecord(&json, "month");
+        writeJsonString(&json, "month", report.months[i].month);
+        writeJsonNumber(&json, "income", report.months[i].income, 2);
+        writeJsonNumber(&json, "expenses", report.months[i].expenses, 2);
+        writeJsonNumber(&json, "profit", report.months[i].profit, 2);
+        endJsonRecord(&json);
+    }
     
-    for (int i = 0; i < financialRecordCount; i++) {
-        // Apply date filters
-        bool include = true;
+    return closeJsonReport(&json);
+}
+
+// Function to find the financial records that may fall in a period
+int findFinancialRecordCandidates(const char *startDate, const char *endDate, uint32_t categoryId,
+                                  int *slots, int maxSlots) {
+    int count = 0;
+    int blockCount = getFinancialBlockCount();
+    
+    for (int b = 0; b < blockCount && count < maxSlots; b++) {
+        const FinancialBlockHeader *block = &financialBlocks[b];
         
-        if (startDate) {
-            if (strcmp(financialRecords[i].date, startDate) < 0) {
-                include = false;
-            }
+        if (!blockOverlaps(block, startDate, endDate)) {
+            continue;
         }
         
-        if (endDate) {
-            if (strcmp(financialRecords[i].date, endDate) > 0) {
-                include = false;
-            }
+        // The category bitmap rules out blocks without a single record of the category
+        if (categoryId < MAX_DICTIONARY_SIZE &&
+            !(block->categoryBitmap[categoryId / 64] & ((uint64_t)1 << (categoryId % 64)))) {
+            continue;
         }
         
-        if (include) {
-            printf("%-10s %-15s $%-9.2f %-10s %s\n", 
-                   financialRecords[i].date,
-                   financialRecords[i].category,
-                   financialRecords[i].amount,
-                   financialRecords[i].type,
-                   financialRecords[i].description);
-            
-            recordsDisplayed++;
+        for (int i = b * FINANCIAL_BLOCK_RECORDS; i < getFinancialBlockEnd(b) && count < maxSlots; i++) {
+            slots[count++] = i;
+        }
+    }
+    
+    return count;
+}
+
+// Function to find the financial records of a period, in storage order
+int findFinancialRecordsInPeriod(const char *startDate, const char *endDate, int *slots) {
+    // Only visit the blocks whose zone maps overlap the period
+    int count = findFinancialRecordCandidates(startDate, endDate, INVALID_STRING_ID, slots, MAX_ARRAY_SIZE);
+    int found = 0;
+    
+    for (int s = 0; s < count; s++) {
+        if (recordInPeriod(&financialRecords[slots[s]], startDate, endDate)) {
+            slots[found++] = slots[s];
         }
     }
     
-    printf("--------------------------------------------------------------------------------------------------------\n");
-    printf("Total records: %d\n", recordsDisplayed);
+    return found;
 }
 
 // Function to save financial data to file
 bool saveFinancialData() {
-    FILE *file = fopen(FINANCIAL_FILE, "wb");
-    
-    if (!file) {
+    // Lay the records out in fixed-size blocks, each led by its zone map
+    int blockCount = getFinancialBlockCount();
+    FinancialBlock *blocks = calloc(blockCount > 0 ? blockCount : 1, sizeof(FinancialBlock));
+    if (!blocks) {
+        invalidateDataFileStamp(&financialFileStamp);
         return false;
     }
     
-    // Write the number of records
-    fwrite(&financialRecordCount, sizeof(int), 1, file);
+    for (int b = 0; b < blockCount; b++) {
+        int first = b * FINANCIAL_BLOCK_RECORDS;
+    
+        blocks[b].header = financialBlocks[b];
+        memcpy(blocks[b].records, &financialRecords[first],
+               (getFinancialBlockEnd(b) - first) * sizeof(FinancialRecord));
+    }
+    
+    // Write the financial record blocks compressed; the fixed-size description fields are mostly padding
+    bool saved = writeCompressedDataFile(FINANCIAL_FILE, sizeof(FinancialBlock), blockCount,
+                                         blocks, blockCount * sizeof(FinancialBlock));
+    
+    free(blocks);
     
-    // Write the financial record data
-    fwrite(financialRecords, sizeof(FinancialRecord), financialRecordCount, file);
+    if (!saved) {
+        invalidateDataFileStamp(&financialFileStamp);
+        return false;
+    }
     
-    fclose(file);
+    // Our own save does not make the in-memory copy stale
+    stampDataFile(FINANCIAL_FILE, &financialFileStamp);
     return true;
 }
 
 // Function to load financial data from file
 bool loadFinancialData() {
-    FILE *file = fopen(FINANCIAL_FILE, "rb");
-    
-    if (!file) {
-        financialRecordCount = 0;
-        return false;
+    // Nothing to do if the file has not changed since it was last read or written
+    if (isDataFileCurrent(FINANCIAL_FILE, &financialFileStamp)) {
+        return true;
     }
     
-    // Read the number of records
-    fread(&financialRecordCount, sizeof(int), 1, file);
+    invalidateDataFileStamp(&financialFileStamp);
+    
+    MappedDataFile file;
+    
+    if (!mapDataFile(FINANCIAL_FILE, sizeof(FinancialBlock), &file)) {
+        // A file of bare records from an older version is converted on the next save
+        if (!mapDataFile(FINANCIAL_FILE, sizeof(FinancialRecord), &file)) {
+            financialRecordCount = 0;
+            return false;
+        }
+        
+        if (file.header->recordCount > MAX_ARRAY_SIZE) {
+            financialRecordCount = 0;
+            unmapDataFile(&file);
+            return false;
+        }
+        
+        financialRecordCount = (int)file.header->recordCount;
+        memcpy(financialRecords, file.payload, financialRecordCount * sizeof(FinancialRecord));
+        unmapDataFile(&file);
+        
+        rebuildFinancialBlocks();
+        return true;
+    }
     
-    // Check if the number of records is valid
-    if (financialRecordCount < 0 || financialRecordCount > MAX_ARRAY_SIZE) {
+    // Check if the number of blocks is valid
+    if (file.header->recordCount > MAX_FINANCIAL_BLOCKS) {
         financialRecordCount = 0;
-        fclose(file);
+        unmapDataFile(&file);
         return false;
     }
     
-    // Read the financial record data
-    fread(financialRecords, sizeof(FinancialRecord), financialRecordCount, file);
+    // Copy each block's zone map and records out of the (decompressed) mapping; only the last block may be partly filled
+    const FinancialBlock *blocks = (const FinancialBlock *)file.payload;
+    int blockCount = (int)file.header->recordCount;
+    
+    financialRecordCount = 0;
     
-    fclose(file);
+    for (int b = 0; b < blockCount; b++) {
+        int used = blocks[b].header.recordCount;
+        
+        if (used < 1 || used > FINANCIAL_BLOCK_RECORDS || (used < FINANCIAL_BLOCK_RECORDS && b < blockCount - 1)) {
+            financialRecordCount = 0;
+            unmapDataFile(&file);
+            return false;
+        }
+        
+        financialBlocks[b] = blocks[b].header;
+        memcpy(&financialRecords[financialRecordCount], blocks[b].records, used * sizeof(FinancialRecord));
+        financialRecordCount += used;
+    }
+    
+    unmapDataFile(&file);
+    stampDataFile(FINANCIAL_FILE, &financialFileStamp);
     return true;
 }
 
@@ -927,14 +786,20 @@ bool exportFinancialData(const char *filename, const char *startDate, const char
         return false;
     }
     
-    FILE *file = fopen(filename, "w");
-    if (!file) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, filename)) {
         return false;
     }
     
-    fprintf(file, "Date,Category,Amount,Type,Description\n");
+    writeCsvRaw(&csv, "Date,Category,Amount,Type,Description\n");
     
-    for (int i = 0; i < financialRecordCount; i++) {
+    // Only visit the blocks whose zone maps overlap the period
+    int slots[MAX_ARRAY_SIZE];
+    int slotCount = findFinancialRecordCandidates(startDate, endDate, INVALID_STRING_ID, slots, MAX_ARRAY_SIZE);
+    
+    for (int s = 0; s < slotCount; s++) {
+        int i = slots[s];
+        
         // Apply date filters
         bool include = true;
         
@@ -951,15 +816,180 @@ bool exportFinancialData(const char *filename, const char *startDate, const char
         }
         
         if (include) {
-            fprintf(file, "%s,%s,%.2f,%s,%s\n", 
-                   financialRecords[i].date,
-                   financialRecords[i].category,
-                   financialRecords[i].amount,
-                   financialRecords[i].type,
-                   financialRecords[i].description);
+            writeCsvText(&csv, financialRecords[i].date);
+            writeCsvText(&csv, lookupString(financialRecords[i].categoryId));
+            writeCsvDecimal(&csv, financialRecords[i].amount, 2);
+            writeCsvText(&csv, lookupString(financialRecords[i].typeId));
+            writeCsvText(&csv, financialRecords[i].description);
+            endCsvRow(&csv);
+        }
+    }
+    
+    return closeCsvWriter(&csv);
+}
+
+// Function to check that a consumer name is safe to use in a file name
+static bool isValidConsumerName(const char *consumer) {
+    size_t length = consumer ? strlen(consumer) : 0;
+    
+    if (length == 0 || length > MAX_EXPORT_CONSUMER_LENGTH) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)consumer[i]) && consumer[i] != '-' && consumer[i] != '_') {
+            return false;
         }
     }
     
-    fclose(file);
     return true;
+}
+
+// Function to load a consumer's watermark; a consumer without one starts at the first record
+static bool loadExportWatermark(const char *path, ExportWatermark *watermark) {
+    memset(watermark, 0, sizeof(ExportWatermark));
+    
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return true;
+    }
+    
+    MappedDataFile file;
+    if (!mapDataFile(path, sizeof(ExportWatermark), &file)) {
+        return false;
+    }
+    
+    bool loaded = file.header->recordCount == 1;
+    if (loaded) {
+        memcpy(watermark, file.payload, sizeof(ExportWatermark));
+    }
+    
+    unmapDataFile(&file);
+    return loaded;
+}
+
+// Function to append the financial records added since a consumer's last run to a CSV file
+int exportFinancialDataSince(const char *consumer, const char *filename) {
+    if (!isValidConsumerName(consumer)) {
+        displayError("Consumer names may only contain letters, digits, - and _.");
+        return -1;
+    }
+    
+    if (!filename || strlen(filename) == 0) {
+        return -1;
+    }
+    
+    char path[100];
+    snprintf(path, sizeof(path), EXPORT_WATERMARK_FILE, consumer);
+    
+    ExportWatermark watermark;
+    if (!loadExportWatermark(path, &watermark)) {
+        displayError("Could not read the export watermark.");
+        return -1;
+    }
+    
+    // The record the watermark ends at must still be there, unchanged
+    if (watermark.sequence > 0) {
+        const FinancialRecord *last = watermark.sequence <= (uint32_t)financialRecordCount ?
+                                      &financialRecords[watermark.sequence - 1] : NULL;
+        
+        if (!last || strcmp(last->date, watermark.date) != 0 || last->amount != watermark.amount ||
+            last->categoryId != watermark.categoryId || last->typeId != watermark.typeId) {
+            char message[200];
+            snprintf(message, sizeof(message),
+                     "Financial records no longer match the watermark; delete %s to export everything again.", path);
+            displayError(message);
+            return -1;
+        }
+    }
+    
+    bool isNew;
+    CsvWriter csv;
+    if (!openCsvWriterForAppend(&csv, filename, &isNew)) {
+        return -1;
+    }
+    
+    if (isNew) {
+        writeCsvRaw(&csv, "Sequence,Date,Category,Amount,Type,Description\n");
+    }
+    
+    // Only the records after the watermark, so the cost follows the new activity
+    for (int i = (int)watermark.sequence; i < financialRecordCount; i++) {
+        writeCsvInt(&csv, i + 1);
+        writeCsvText(&csv, financialRecords[i].date);
+        writeCsvText(&csv, lookupString(financialRecords[i].categoryId));
+        writeCsvDecimal(&csv, financialRecords[i].amount, 2);
+        writeCsvText(&csv, lookupString(financialRecords[i].typeId));
+        writeCsvText(&csv, financialRecords[i].description);
+        endCsvRow(&csv);
+    }
+    
+    if (!closeCsvWriter(&csv)) {
+        return -1;
+    }
+    
+    int exported = financialRecordCount - (int)watermark.sequence;
+    if (exported == 0) {
+        return 0;
+    }
+    
+    // Advance the watermark only now that the rows are safely written
+    const FinancialRecord *last = &financialRecords[financialRecordCount - 1];
+    
+    memset(&watermark, 0, sizeof(ExportWatermark));
+    watermark.sequence = (uint32_t)financialRecordCount;
+    watermark.categoryId = last->categoryId;
+    watermark.typeId = last->typeId;
+    watermark.amount = last->amount;
+    strcpy(watermark.date, last->date);
+    
+    if (!writeDataFile(path, sizeof(ExportWatermark), 1, &watermark, sizeof(ExportWatermark))) {
+        displayError("Could not save the export watermark.");
+        return -1;
+    }
+    
+    return exported;
+}
+
+// Function to export the financial records as a columnar file
+bool exportFinancialColumnar(const char *path) {
+    // One array per column; strings point into the records rather than being copied
+    int rows = financialRecordCount > 0 ? financialRecordCount : 1;
+    int32_t *sequences = malloc(rows * sizeof(int32_t));
+    const char **dates = malloc(rows * sizeof(const char *));
+    const char **types = malloc(rows * sizeof(const char *));
+    const char **categories = malloc(rows * sizeof(const char *));
+    double *amounts = malloc(rows * sizeof(double));
+    const char **descriptions = malloc(rows * sizeof(const char *));
+    bool exported = false;
+    
+    if (sequences && dates && types && categories && amounts && descriptions) {
+        for (int i = 0; i < financialRecordCount; i++) {
+            sequences[i] = i + 1;
+            dates[i] = financialRecords[i].date;
+            types[i] = lookupString(financialRecords[i].typeId);
+            categories[i] = lookupString(financialRecords[i].categoryId);
+            amounts[i] = financialRecords[i].amount;
+            descriptions[i] = financialRecords[i].description;
+        }
+        
+        ColumnarWriter columns;
+        if (openColumnarWriter(&columns, path, 6, financialRecordCount)) {
+            writeColumnInt32(&columns, "sequence", sequences);
+            writeColumnStrings(&columns, "date", dates);
+            writeColumnStrings(&columns, "type", types);
+            writeColumnStrings(&columns, "category", categories);
+            writeColumnFloat64(&columns, "amount", amounts);
+            writeColumnStrings(&columns, "description", descriptions);
+            exported = closeColumnarWriter(&columns);
+        }
+    }
+    
+    free(sequences);
+    free(dates);
+    free(types);
+    free(categories);
+    free(amounts);
+    free(descriptions);
+    return exported;
 }
\ No newline at end of file
@@ -0,0 +1,379 @@
+/**
+ * Financial Menu Implementation File
+ * Contains the financial analysis screens and prompts built on the financial module
+ */
+
+#include "menu.h"
+#include "financial.h"
+#include "dictionary.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "globals.h"
+
+// Function to run the financial analysis module
+void runFinancialAnalysis() {
+    int choice;
+    bool running = true;
+    
+    // Load financial data
+    loadFinancialData();
+    
+    while (running) {
+        clearScreen();
+        printf("\n\033[1;36m========================================\033[0m\n");
+        printf("\033[1;32m       FINANCIAL ANALYSIS\033[0m\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("1. Add Financial Record\n");
+        printf("2. View Financial Records\n");
+        printf("3. Generate Income Statement\n");
+        printf("4. Generate Expense Report\n");
+        printf("5. Generate Profit and Loss Report\n");
+        printf("6. Export Financial Data\n");
+        printf("7. Back to Main Menu\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        clearInputBuffer();
+        
+        switch (choice) {
+            case 1: {
+                char date[20];
+                char category[30];
+                double amount;
+                char type[10];
+                char description[200];
+                
+                printf("\n\033[1;36m========================================\033[0m\n");
+                printf("\033[1;32m        ADD FINANCIAL RECORD\033[0m\n");
+                printf("\033[1;36m========================================\033[0m\n");
+                
+                printf("Enter date (YYYY-MM-DD): ");
+                fgets(date, sizeof(date), stdin);
+                date[strcspn(date, "\n")] = 0;
+                
+                printf("Enter category: ");
+                fgets(category, sizeof(category), stdin);
+                category[strcspn(category, "\n")] = 0;
+                
+                printf("Enter amount: ");
+                scanf("%lf", &amount);
+                clearInputBuffer();
+                
+                printf("Enter type (Income or Expense): ");
+                fgets(type, sizeof(type), stdin);
+                type[strcspn(type, "\n")] = 0;
+                
+                printf("Enter description: ");
+                fgets(description, sizeof(description), stdin);
+                description[strcspn(description, "\n")] = 0;
+                
+                if (addFinancialRecord(date, category, amount, type, description)) {
+                    displaySuccess("Financial record added successfully.");
+                } else {
+                    displayError("Failed to add financial record.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 2: {
+                char startDate[20], endDate[20];
+                
+                printf("Enter start date (YYYY-MM-DD, leave blank for all): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD, leave blank for all): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                displayFinancialRecords(
+                    strlen(startDate) > 0 ? startDate : NULL,
+                    strlen(endDate) > 0 ? endDate : NULL
+                );
+                pressEnterToContinue();
+                break;
+            }
+            case 3: {
+                char startDate[20], endDate[20];
+                
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                generateIncomeStatement(startDate, endDate);
+                pressEnterToContinue();
+                break;
+            }
+            case 4: {
+                char startDate[20], endDate[20];
+                
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                generateExpenseReport(startDate, endDate);
+                pressEnterToContinue();
+                break;
+            }
+            case 5: {
+                char startDate[20], endDate[20];
+                
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                generateProfitLossReport(startDate, endDate);
+                pressEnterToContinue();
+                break;
+            }
+            case 6: {
+                char filename[100];
+                char startDate[20], endDate[20];
+                
+                printf("Enter filename to export to: ");
+                fgets(filename, sizeof(filename), stdin);
+                filename[strcspn(filename, "\n")] = 0;
+                
+                printf("Enter start date (YYYY-MM-DD, leave blank for all): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD, leave blank for all): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                if (exportFinancialData(
+                        filename,
+                        strlen(startDate) > 0 ? startDate : NULL,
+                        strlen(endDate) > 0 ? endDate : NULL
+                    )) {
+                    displaySuccess("Financial data exported successfully.");
+                } else {
+                    displayError("Failed to export financial data.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 7:
+                running = false;
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+                pressEnterToContinue();
+        }
+    }
+}
+
+// Function to display the income, expenses and profit of a period
+static void displayFinancialSummary(const FinancialSummary *summary) {
+    printf("SUMMARY\n");
+    printf("----------------------------------------------\n");
+    printf("%-30s $%10.2f\n", "Total Income", summary->totalIncome);
+    printf("%-30s $%10.2f\n", "Total Expenses", summary->totalExpenses);
+    printf("%-30s $%10.2f\n", "Net Profit/Loss", summary->profit);
+    printf("%-30s %10.1f%%\n", "Profit Margin", summary->profitMargin);
+}
+
+// Function to display an income statement
+void displayIncomeStatement(const char *startDate, const char *endDate, const IncomeStatement *statement) {
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m        INCOME STATEMENT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    printf("Period: %s to %s\n\n", startDate, endDate);
+    
+    // Income breakdown by category
+    printf("INCOME\n");
+    printf("----------------------------------------------\n");
+    
+    for (int i = 0; i < statement->incomeCategoryCount; i++) {
+        printf("%-30s $%10.2f\n", lookupString(statement->incomeCategories[i].categoryId),
+               statement->incomeCategories[i].amount);
+    }
+    
+    printf("----------------------------------------------\n");
+    printf("%-30s $%10.2f\n\n", "Total Income", statement->summary.totalIncome);
+    
+    // Expense breakdown by category
+    printf("EXPENSES\n");
+    printf("----------------------------------------------\n");
+    
+    for (int i = 0; i < statement->expenseCategoryCount; i++) {
+        printf("%-30s $%10.2f\n", lookupString(statement->expenseCategories[i].categoryId),
+               statement->expenseCategories[i].amount);
+    }
+    
+    printf("----------------------------------------------\n");
+    printf("%-30s $%10.2f\n\n", "Total Expenses", statement->summary.totalExpenses);
+    
+    // Net profit
+    displayFinancialSummary(&statement->summary);
+}
+
+// Function to generate income statement for a given period
+void generateIncomeStatement(const char *startDate, const char *endDate) {
+    IncomeStatement statement;
+    buildIncomeStatement(startDate, endDate, &statement);
+    displayIncomeStatement(startDate, endDate, &statement);
+    
+    // Export option
+    printf("\nWould you like to export this statement to a CSV file? (y/n): ");
+    char exportChoice;
+    scanf("%c", &exportChoice);
+    clearInputBuffer();
+    
+    if (exportChoice == 'y' || exportChoice == 'Y') {
+        char filename[100];
+        snprintf(filename, sizeof(filename), "income_statement_%s_%s.csv", startDate, endDate);
+        
+        if (exportIncomeStatementCsv(filename, startDate, endDate, &statement)) {
+            printf("Statement exported to %s\n", filename);
+        } else {
+            printf("Failed to export statement.\n");
+        }
+    }
+}
+
+// Function to display an expense report
+void displayExpenseReport(const char *startDate, const char *endDate, const ExpenseReport *report) {
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m        EXPENSE REPORT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    printf("Period: %s to %s\n\n", startDate, endDate);
+    
+    // Expense breakdown by category
+    printf("EXPENSE BREAKDOWN\n");
+    printf("----------------------------------------------\n");
+    
+    // Display expense categories with percentage
+    for (int i = 0; i < report->categoryCount; i++) {
+        printf("%-30s $%10.2f (%5.1f%%)\n", lookupString(report->categories[i].categoryId),
+               report->categories[i].amount, report->categories[i].percentage);
+    }
+    
+    printf("----------------------------------------------\n");
+    printf("%-30s $%10.2f (100.0%%)\n", "Total Expenses", report->totalExpenses);
+}
+
+// Function to generate expense report for a given period
+void generateExpenseReport(const char *startDate, const char *endDate) {
+    ExpenseReport report;
+    buildExpenseReport(startDate, endDate, &report);
+    displayExpenseReport(startDate, endDate, &report);
+    
+    // Export option
+    printf("\nWould you like to export this report to a CSV file? (y/n): ");
+    char exportChoice;
+    scanf("%c", &exportChoice);
+    clearInputBuffer();
+    
+    if (exportChoice == 'y' || exportChoice == 'Y') {
+        char filename[100];
+        snprintf(filename, sizeof(filename), "expense_report_%s_%s.csv", startDate, endDate);
+        
+        if (exportExpenseReportCsv(filename, startDate, endDate, &report)) {
+            printf("Report exported to %s\n", filename);
+        } else {
+            printf("Failed to export report.\n");
+        }
+    }
+}
+
+// Function to display a profit and loss report
+void displayProfitLossReport(const char *startDate, const char *endDate, const ProfitLossReport *report) {
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m      PROFIT AND LOSS REPORT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    printf("Period: %s to %s\n\n", startDate, endDate);
+    
+    displayFinancialSummary(&report->summary);
+    printf("\n");
+    
+    // Monthly breakdown
+    printf("MONTHLY BREAKDOWN\n");
+    printf("----------------------------------------------\n");
+    printf("%-10s %-12s %-12s %-12s\n", "Month", "Income", "Expenses", "Profit/Loss");
+    printf("----------------------------------------------\n");
+    
+    for (int i = 0; i < report->monthCount; i++) {
+        printf("%-10s $%-11.2f $%-11.2f $%-11.2f\n", 
+               report->months[i].month, 
+               report->months[i].income, 
+               report->months[i].expenses, 
+               report->months[i].profit);
+    }
+}
+
+// Function to generate profit and loss report for a given period
+void generateProfitLossReport(const char *startDate, const char *endDate) {
+    ProfitLossReport report;
+    buildProfitLossReport(startDate, endDate, &report);
+    displayProfitLossReport(startDate, endDate, &report);
+    
+    // Export option
+    printf("\nWould you like to export this report to a CSV file? (y/n): ");
+    char exportChoice;
+    scanf("%c", &exportChoice);
+    clearInputBuffer();
+    
+    if (exportChoice == 'y' || exportChoice == 'Y') {
+        char filename[100];
+        snprintf(filename, sizeof(filename), "profit_loss_report_%s_%s.csv", startDate, endDate);
+        
+        if (exportProfitLossReportCsv(filename, startDate, endDate, &report)) {
+            printf("Report exported to %s\n", filename);
+        } else {
+            printf("Failed to export report.\n");
+        }
+    }
+}
+
+// Function to display financial records for a given period
+void displayFinancialRecords(const char *startDate, const char *endDate) {
+    if (financialRecordCount == 0) {
+        printf("No financial records available.\n");
+        return;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m        FINANCIAL RECORDS\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    printf("Period: %s to %s\n\n", 
+           startDate ? startDate : "All time",
+           endDate ? endDate : "Present");
+    
+    printf("%-10s %-15s %-10s %-10s %s\n", 
+           "Date", "Category", "Amount", "Type", "Description");
+    printf("--------------------------------------------------------------------------------------------------------\n");
+    
+    int slots[MAX_ARRAY_SIZE];
+    int recordCount = findFinancialRecordsInPeriod(startDate, endDate, slots);
+    
+    for (int s = 0; s < recordCount; s++) {
+        const FinancialRecord *record = &financialRecords[slots[s]];
+        
+        printf("%-10s %-15s $%-9.2f %-10s %s\n", 
+               record->date,
+               lookupString(record->categoryId),
+               record->amount,
+               lookupString(record->typeId),
+               record->description);
+    }
+    
+    printf("--------------------------------------------------------------------------------------------------------\n");
+    printf("Total records: %d\n", recordCount);
+}
\ No newline at end of file
@@ -4,6 +4,9 @@
 Product products[MAX_ARRAY_SIZE];
 int productCount = 0;
 
+Customer customers[MAX_ARRAY_SIZE];
+int customerCount = 0;
+
 Transaction transactions[MAX_ARRAY_SIZE];
 int transactionCount = 0;
 
@@ -0,0 +1,1130 @@
+/**
+ * Bulk Import Implementation File
+ * Contains implementations of the parallel CSV importer
+ */
+
+#include "import.h"
+#include "product.h"
+#include "customer.h"
+#include "billing.h"
+#include "financial.h"
+#include "dictionary.h"
+#include "storage.h"
+#include "parallel.h"
+#include "utils.h"
+#include "globals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <ctype.h>
+
+// One product line, before its category is interned
+typedef struct {
+    Product product;
+    ProductDetails details;
+    char category[DICTIONARY_STRING_LENGTH];
+} ProductRow;
+
+// One transaction item line, before its strings are interned
+typedef struct {
+    char transactionId[20];
+    char date[20];
+    char customerId[20];
+    char paymentMethod[DICTIONARY_STRING_LENGTH];
+    char status[DICTIONARY_STRING_LENGTH];
+    BillingItem item;
+} TransactionRow;
+
+// The line that starts a transaction, whose payment method and status are interned last
+typedef struct {
+    const TransactionRow *row;
+    int line;
+} TransactionStart;
+
+// One financial line, before its category is interned
+typedef struct {
+    FinancialRecord record;
+    char category[DICTIONARY_STRING_LENGTH];
+} FinancialRow;
+
+// Slice of the file parsed by one task
+typedef struct {
+    ImportKind kind;
+    const char *start;     // First byte of the slice (always the start of a record)
+    const char *end;       // One past the last byte of the slice
+    bool firstSlice;       // Whether the slice may start with a header line
+    void *rows;            // Parsed rows
+    int *rowLines;         // First line of each row, counted from the start of the slice
+    int rowCount;          // Number of rows parsed
+    int lineCount;         // Number of lines read
+    int errorLine;         // Line of the first bad row, counted from the start of the slice
+    const char *error;     // What was wrong with it, or NULL
+} ImportChunk;
+
+// Cursor over the fields of one CSV line
+typedef struct {
+    const char *position;  // Start of the next field
+    const char *end;       // End of the line (without the line break)
+    bool finished;         // Whether the last field has been read
+} CsvCursor;
+
+// Entry of a duplicate-ID hash set
+typedef struct {
+    uint64_t hash;         // Hash of the ID
+    const char *text;      // The ID for text IDs, or NULL for numeric IDs
+    bool used;             // Whether the entry holds an ID
+} ImportKey;
+
+// Open-addressing hash set of the IDs already taken
+typedef struct {
+    ImportKey *keys;
+    size_t mask;           // Number of entries minus one (a power of two minus one)
+} ImportKeySet;
+
+// Names accepted on the command line, in ImportKind order
+static const char *importKindNames[] = { "products", "customers", "transactions", "financial" };
+
+// Plural names used in messages, in ImportKind order
+static const char *importRecordNames[] = { "products", "customers", "transactions", "financial records" };
+
+// Name of the first column of each kind, used to recognise a header line
+static const char *importFirstColumns[] = { "id", "id", "transaction_id", "date" };
+
+// Function to look up an import kind by its command-line name
+bool parseImportKind(const char *name, ImportKind *kind) {
+    for (int i = 0; i < (int)(sizeof(importKindNames) / sizeof(importKindNames[0])); i++) {
+        if (strcmp(name, importKindNames[i]) == 0) {
+            *kind = (ImportKind)i;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// Function to get the size of one parsed row of a kind
+static size_t getImportRowSize(ImportKind kind) {
+    switch (kind) {
+        case IMPORT_PRODUCTS:
+            return sizeof(ProductRow);
+        case IMPORT_CUSTOMERS:
+            return sizeof(Customer);
+        case IMPORT_TRANSACTIONS:
+            return sizeof(TransactionRow);
+        default:
+            return sizeof(FinancialRow);
+    }
+}
+
+// Function to read the next field of a CSV line, returning an error message or NULL
+static const char *readCsvField(CsvCursor *cursor, char *field, size_t fieldSize) {
+    const char *position = cursor->position;
+    const char *end = cursor->end;
+    size_t length = 0;
+    
+    if (cursor->finished) {
+        return "missing fields";
+    }
+    
+    if (position < end && *position == '"') {
+        // Quoted field: copy up to the closing quote, turning "" into "
+        bool closed = false;
+        
+        for (position++; position < end; position++) {
+            if (*position == '"') {
+                if (position + 1 < end && position[1] == '"') {
+                    position++;
+                } else {
+                    position++;
+                    closed = true;
+                    break;
+                }
+            }
+            
+            if (length + 1 >= fieldSize) {
+                return "field too long";
+            }
+            field[length++] = *position;
+        }
+        
+        if (!closed) {
+            return "unterminated quote";
+        }
+        if (position < end && *position != ',') {
+            return "text after closing quote";
+        }
+    } else {
+        const char *comma = position < end ? memchr(position, ',', (size_t)(end - position)) : NULL;
+        const char *fieldEnd = comma ? comma : end;
+        
+        // Unquoted fields are trimmed
+        while (position < fieldEnd && (*position == ' ' || *position == '\t')) {
+            position++;
+        }
+        const char *last = fieldEnd;
+        while (last > position && (last[-1] == ' ' || last[-1] == '\t')) {
+            last--;
+        }
+        
+        length = (size_t)(last - position);
+        if (length >= fieldSize) {
+            return "field too long";
+        }
+        memcpy(field, position, length);
+        position = fieldEnd;
+    }
+    
+    field[length] = '\0';
+    
+    // Step over the separator, or note that the line has no more fields
+    if (position < end) {
+        position++;
+    } else {
+        cursor->finished = true;
+    }
+    cursor->position = position;
+    return NULL;
+}
+
+// Function to compare two strings ignoring case
+static bool equalsIgnoreCase(const char *first, const char *second) {
+    for (; *first && *second; first++, second++) {
+        if (tolower((unsigned char)*first) != tolower((unsigned char)*second)) {
+            return false;
+        }
+    }
+    return *first == *second;
+}
+
+// Function to parse a whole number field
+static bool parseCsvInt(const char *text, int *value) {
+    bool negative = *text == '-';
+    long long result = 0;
+    
+    if (*text == '-' || *text == '+') {
+        text++;
+    }
+    if (!isdigit((unsigned char)*text)) {
+        return false;
+    }
+    
+    for (; isdigit((unsigned char)*text); text++) {
+        result = result * 10 + (*text - '0');
+        if (result > INT_MAX) {
+            return false;
+        }
+    }
+    
+    if (*text != '\0') {
+        return false;
+    }
+    
+    *value = (int)(negative ? -result : result);
+    return true;
+}
+
+// Function to parse a decimal field such as 12.50 by accumulating digits, without strtod
+static bool parseCsvDecimal(const char *text, double *value) {
+    static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    bool negative = *text == '-';
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    
+    if (*text == '-' || *text == '+') {
+        text++;
+    }
+    
+    for (; isdigit((unsigned char)*text); text++, digits++) {
+        mantissa = mantissa * 10 + (uint64_t)(*text - '0');
+    }
+    
+    if (*text == '.') {
+        for (text++; isdigit((unsigned char)*text); text++, digits++, fractionDigits++) {
+            mantissa = mantissa * 10 + (uint64_t)(*text - '0');
+        }
+    }
+    
+    // Up to 18 digits fit the mantissa exactly
+    if (*text != '\0' || digits == 0 || digits > 18 || fractionDigits > 9) {
+        return false;
+    }
+    
+    *value = (double)mantissa / powersOfTen[fractionDigits];
+    if (negative) {
+        *value = -*value;
+    }
+    return true;
+}
+
+// Function to check a date field (YYYY-MM-DD, optionally followed by HH:MM:SS)
+static bool isValidCsvDate(const char *text) {
+    size_t length = strlen(text);
+    const char *pattern = "dddd-dd-dd dd:dd:dd";
+    
+    if (length != 10 && length != 19) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < length; i++) {
+        if (pattern[i] == 'd' ? !isdigit((unsigned char)text[i]) : text[i] != pattern[i]) {
+            return false;
+        }
+    }
+    
+    int month = (text[5] - '0') * 10 + (text[6] - '0');
+    int day = (text[8] - '0') * 10 + (text[9] - '0');
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    
+    if (length == 19) {
+        int hour = (text[11] - '0') * 10 + (text[12] - '0');
+        int minute = (text[14] - '0') * 10 + (text[15] - '0');
+        int second = (text[17] - '0') * 10 + (text[18] - '0');
+        if (hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Function to parse a product line
+static const char *parseProductRow(CsvCursor *cursor, ProductRow *row) {
+    char field[MAX_STRING_LENGTH];
+    const char *error;
+    
+    memset(row, 0, sizeof(ProductRow));
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvInt(field, &row->product.id)) {
+        return "invalid product ID";
+    }
+    row->details.id = row->product.id;
+    
+    if ((error = readCsvField(cursor, row->details.name, sizeof(row->details.name))) != NULL) {
+        return error;
+    }
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvDecimal(field, &row->product.price) || row->product.price < 0) {
+        return "invalid price";
+    }
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvInt(field, &row->product.quantity) || row->product.quantity < 0) {
+        return "invalid quantity";
+    }
+    
+    if ((error = readCsvField(cursor, row->category, sizeof(row->category))) != NULL) {
+        return error;
+    }
+    if (row->category[0] == '\0') {
+        return "missing category";
+    }
+    
+    return readCsvField(cursor, row->details.description, sizeof(row->details.description));
+}
+
+// Function to parse a customer line
+static const char *parseCustomerRow(CsvCursor *cursor, Customer *row) {
+    char field[MAX_STRING_LENGTH];
+    const char *error;
+    
+    memset(row, 0, sizeof(Customer));
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvInt(field, &row->id)) {
+        return "invalid customer ID";
+    }
+    
+    if ((error = readCsvField(cursor, row->name, sizeof(row->name))) != NULL ||
+        (error = readCsvField(cursor, row->phone, sizeof(row->phone))) != NULL ||
+        (error = readCsvField(cursor, row->email, sizeof(row->email))) != NULL ||
+        (error = readCsvField(cursor, row->address, sizeof(row->address))) != NULL) {
+        return error;
+    }
+    
+    return readCsvField(cursor, row->notes, sizeof(row->notes));
+}
+
+// Function to parse a transaction item line
+static const char *parseTransactionRow(CsvCursor *cursor, TransactionRow *row) {
+    char field[MAX_STRING_LENGTH];
+    const char *error;
+    
+    memset(row, 0, sizeof(TransactionRow));
+    
+    if ((error = readCsvField(cursor, row->transactionId, sizeof(row->transactionId))) != NULL) {
+        return error;
+    }
+    if (row->transactionId[0] == '\0') {
+        return "missing transaction ID";
+    }
+    
+    if ((error = readCsvField(cursor, row->date, sizeof(row->date))) != NULL) {
+        return error;
+    }
+    if (!isValidCsvDate(row->date)) {
+        return "invalid date";
+    }
+    
+    if ((error = readCsvField(cursor, row->customerId, sizeof(row->customerId))) != NULL ||
+        (error = readCsvField(cursor, row->paymentMethod, sizeof(row->paymentMethod))) != NULL ||
+        (error = readCsvField(cursor, row->status, sizeof(row->status))) != NULL) {
+        return error;
+    }
+    
+    // Same defaults as the billing screen
+    if (row->customerId[0] == '\0') {
+        strcpy(row->customerId, "Anonymous");
+    }
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvInt(field, &row->item.productId)) {
+        return "invalid product ID";
+    }
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvInt(field, &row->item.quantity) || row->item.quantity <= 0) {
+        return "invalid quantity";
+    }
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvDecimal(field, &row->item.price) || row->item.price < 0) {
+        return "invalid price";
+    }
+    
+    row->item.subtotal = row->item.price * row->item.quantity;
+    return NULL;
+}
+
+// Function to parse a financial line
+static const char *parseFinancialRow(CsvCursor *cursor, FinancialRow *row) {
+    char field[MAX_STRING_LENGTH];
+    const char *error;
+    
+    memset(row, 0, sizeof(FinancialRow));
+    
+    if ((error = readCsvField(cursor, row->record.date, sizeof(row->record.date))) != NULL) {
+        return error;
+    }
+    if (!isValidCsvDate(row->record.date)) {
+        return "invalid date";
+    }
+    
+    // The type is one of the two fixed dictionary strings, so it needs no interning
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (equalsIgnoreCase(field, "Income")) {
+        row->record.typeId = STRING_ID_INCOME;
+    } else if (equalsIgnoreCase(field, "Expense")) {
+        row->record.typeId = STRING_ID_EXPENSE;
+    } else {
+        return "type must be Income or Expense";
+    }
+    
+    if ((error = readCsvField(cursor, row->category, sizeof(row->category))) != NULL) {
+        return error;
+    }
+    if (row->category[0] == '\0') {
+        return "missing category";
+    }
+    
+    if ((error = readCsvField(cursor, field, sizeof(field))) != NULL) {
+        return error;
+    }
+    if (!parseCsvDecimal(field, &row->record.amount) || row->record.amount <= 0) {
+        return "invalid amount";
+    }
+    
+    return readCsvField(cursor, row->record.description, sizeof(row->record.description));
+}
+
+// Function to parse one line into a row of the given kind
+static const char *parseImportRow(ImportKind kind, CsvCursor *cursor, void *row) {
+    switch (kind) {
+        case IMPORT_PRODUCTS:
+            return parseProductRow(cursor, (ProductRow *)row);
+        case IMPORT_CUSTOMERS:
+            return parseCustomerRow(cursor, (Customer *)row);
+        case IMPORT_TRANSACTIONS:
+            return parseTransactionRow(cursor, (TransactionRow *)row);
+        default:
+            return parseFinancialRow(cursor, (FinancialRow *)row);
+    }
+}
+
+// Function to check whether a line is the column header of a kind
+static bool isHeaderLine(ImportKind kind, const char *start, const char *end) {
+    CsvCursor cursor = { start, end, false };
+    char field[MAX_STRING_LENGTH];
+    
+    return readCsvField(&cursor, field, sizeof(field)) == NULL &&
+           equalsIgnoreCase(field, importFirstColumns[kind]);
+}
+
+// Function to find the line break that ends a record, counting the breaks inside quoted fields
+// Returns NULL if the record runs to the end of the data
+static const char *findRecordEnd(const char *position, const char *end, int *embeddedBreaks) {
+    const char *newline = memchr(position, '\n', (size_t)(end - position));
+    const char *lineEnd = newline ? newline : end;
+    
+    *embeddedBreaks = 0;
+    
+    // Most lines have no quotes, and then the first line break ends the record
+    if (!memchr(position, '"', (size_t)(lineEnd - position))) {
+        return newline;
+    }
+    
+    // A quote only opens a quoted field at the start of a field, as in readCsvField
+    bool fieldStart = true;
+    bool quoted = false;
+    
+    for (; position < end; position++) {
+        if (quoted) {
+            if (*position == '"') {
+                if (position + 1 < end && position[1] == '"') {
+                    position++;
+                } else {
+                    quoted = false;
+                }
+            } else if (*position == '\n') {
+                (*embeddedBreaks)++;
+            }
+            continue;
+        }
+        
+        if (*position == '\n') {
+            return position;
+        }
+        
+        quoted = fieldStart && *position == '"';
+        fieldStart = *position == ',';
+    }
+    
+    return NULL;
+}
+
+// Function run by each parser task to turn one slice of the file into rows
+static void parseImportChunk(void *argument) {
+    ImportChunk *chunk = (ImportChunk *)argument;
+    size_t rowSize = getImportRowSize(chunk->kind);
+    
+    // Every row ends at a line break, so the number of line breaks bounds the rows
+    int capacity = 1;
+    for (const char *p = chunk->start; (p = memchr(p, '\n', (size_t)(chunk->end - p))) != NULL; p++) {
+        capacity++;
+    }
+    
+    chunk->rows = malloc(capacity * rowSize);
+    chunk->rowLines = malloc(capacity * sizeof(int));
+    if (!chunk->rows || !chunk->rowLines) {
+        chunk->error = "out of memory";
+        return;
+    }
+    
+    const char *position = chunk->start;
+    
+    while (position < chunk->end) {
+        const char *lineStart = position;
+        int embeddedBreaks;
+        const char *newline = findRecordEnd(position, chunk->end, &embeddedBreaks);
+        const char *lineEnd = newline ? newline : chunk->end;
+        
+        // A quoted field may span lines; the row is numbered by its first line
+        int line = chunk->lineCount + 1;
+        
+        position = newline ? newline + 1 : chunk->end;
+        chunk->lineCount += 1 + embeddedBreaks;
+        
+        if (lineEnd > lineStart && lineEnd[-1] == '\r') {
+            lineEnd--;
+        }
+        
+        // Blank lines and the header are skipped
+        if (lineEnd == lineStart ||
+            (chunk->firstSlice && line == 1 && isHeaderLine(chunk->kind, lineStart, lineEnd))) {
+            continue;
+        }
+        
+        CsvCursor cursor = { lineStart, lineEnd, false };
+        void *row = (char *)chunk->rows + chunk->rowCount * rowSize;
+        const char *error = parseImportRow(chunk->kind, &cursor, row);
+        
+        if (!error && !cursor.finished) {
+            error = "too many fields";
+        }
+        if (error) {
+            chunk->error = error;
+            chunk->errorLine = line;
+            return;
+        }
+        
+        chunk->rowLines[chunk->rowCount++] = line;
+    }
+}
+
+// Function to report a problem with the file, with its line number when there is one
+static void reportImportError(const char *path, int line, const char *error) {
+    char message[300];
+    
+    if (line > 0) {
+        snprintf(message, sizeof(message), "%s line %d: %s.", path, line, error);
+    } else {
+        snprintf(message, sizeof(message), "%s: %s.", path, error);
+    }
+    displayError(message);
+}
+
+// Function to hash a numeric ID (a bijection, so equal hashes mean equal IDs)
+static uint64_t hashImportInt(int value) {
+    uint64_t hash = (uint64_t)(uint32_t)value;
+    
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Function to hash a text ID (FNV-1a)
+static uint64_t hashImportText(const char *text) {
+    uint64_t hash = 14695981039346656037ULL;
+    
+    for (; *text; text++) {
+        hash ^= (unsigned char)*text;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Function to create a hash set with room for the given number of IDs
+static bool createImportKeySet(ImportKeySet *set, int count) {
+    size_t capacity = 16;
+    
+    // Keep the set at most half full so probe sequences stay short
+    while (capacity < (size_t)count * 2) {
+        capacity *= 2;
+    }
+    
+    set->keys = calloc(capacity, sizeof(ImportKey));
+    set->mask = capacity - 1;
+    return set->keys != NULL;
+}
+
+// Function to add an ID to a hash set, returning false if it was already there
+static bool addImportKey(ImportKeySet *set, uint64_t hash, const char *text) {
+    size_t index = (size_t)hash & set->mask;
+    
+    while (set->keys[index].used) {
+        if (set->keys[index].hash == hash && (!text || strcmp(set->keys[index].text, text) == 0)) {
+            return false;
+        }
+        index = (index + 1) & set->mask;
+    }
+    
+    set->keys[index].hash = hash;
+    set->keys[index].text = text;
+    set->keys[index].used = true;
+    return true;
+}
+
+// Function to intern a dictionary string from the file
+static bool internImportString(const char *path, int line, const char *value, uint32_t *id) {
+    *id = internString(value);
+    
+    if (*id == INVALID_STRING_ID) {
+        reportImportError(path, line, "too many distinct categories, payment methods and statuses");
+        return false;
+    }
+    return true;
+}
+
+// Function to note a dictionary string the file would add, failing once the dictionary would overflow
+static bool checkImportString(const char *path, int line, const char *value, ImportKeySet *newStrings, int *newCount) {
+    if (value[0] == '\0' || findStringId(value) != INVALID_STRING_ID ||
+        !addImportKey(newStrings, hashImportText(value), value)) {
+        return true;
+    }
+    
+    (*newCount)++;
+    if (getDictionarySize() + *newCount > MAX_DICTIONARY_SIZE) {
+        reportImportError(path, line, "too many distinct categories, payment methods and statuses");
+        return false;
+    }
+    return true;
+}
+
+// Function to check that the rows fit in a store
+static bool checkImportSpace(const char *path, int rowCount, int storeCount, const char *what) {
+    if (storeCount + rowCount <= MAX_ARRAY_SIZE) {
+        return true;
+    }
+    
+    char message[100];
+    snprintf(message, sizeof(message), "the file has %d %s but only %d more fit", rowCount, what,
+             MAX_ARRAY_SIZE - storeCount);
+    reportImportError(path, 0, message);
+    return false;
+}
+
+// Function to add the parsed products to the product store
+static int commitProductRows(const char *path, ImportChunk *chunks, int chunkCount,
+                             const int *lineBase, int rowCount) {
+    if (!checkImportSpace(path, rowCount, productCount, importRecordNames[IMPORT_PRODUCTS])) {
+        return -1;
+    }
+    
+    ImportKeySet ids = { NULL, 0 };
+    ImportKeySet newStrings = { NULL, 0 };
+    Product *newProducts = malloc((rowCount > 0 ? rowCount : 1) * sizeof(Product));
+    ProductDetails *newDetails = malloc((rowCount > 0 ? rowCount : 1) * sizeof(ProductDetails));
+    int newStringCount = 0;
+    int count = 0;
+    
+    if (!newProducts || !newDetails || !createImportKeySet(&ids, productCount + rowCount) ||
+        !createImportKeySet(&newStrings, rowCount)) {
+        free(ids.keys);
+        free(newProducts);
+        free(newDetails);
+        reportImportError(path, 0, "out of memory");
+        return -1;
+    }
+    
+    for (int i = 0; i < productCount; i++) {
+        addImportKey(&ids, hashImportInt(products[i].id), NULL);
+    }
+    
+    // Check every ID and that the new categories fit before interning anything,
+    // so a rejected file leaves the dictionary alone
+    loadDictionary();
+    
+    for (int c = 0; c < chunkCount && count >= 0; c++) {
+        const ProductRow *rows = (const ProductRow *)chunks[c].rows;
+        
+        for (int r = 0; r < chunks[c].rowCount; r++) {
+            int line = lineBase[c] + chunks[c].rowLines[r];
+            
+            if (!addImportKey(&ids, hashImportInt(rows[r].product.id), NULL)) {
+                reportImportError(path, line, "duplicate product ID");
+                count = -1;
+                break;
+            }
+            if (!checkImportString(path, line, rows[r].category, &newStrings, &newStringCount)) {
+                count = -1;
+                break;
+            }
+        }
+    }
+    
+    for (int c = 0; c < chunkCount && count >= 0; c++) {
+        const ProductRow *rows = (const ProductRow *)chunks[c].rows;
+        
+        for (int r = 0; r < chunks[c].rowCount; r++) {
+            newProducts[count] = rows[r].product;
+            newDetails[count] = rows[r].details;
+            
+            if (!internImportString(path, lineBase[c] + chunks[c].rowLines[r], rows[r].category,
+                                    &newProducts[count].categoryId)) {
+                count = -1;
+                break;
+            }
+            count++;
+        }
+    }
+    
+    if (count >= 0 && !appendProducts(newProducts, newDetails, count)) {
+        count = -1;
+    }
+    
+    free(ids.keys);
+    free(newStrings.keys);
+    free(newProducts);
+    free(newDetails);
+    return count;
+}
+
+// Function to add the parsed customers to the customer store
+static int commitCustomerRows(const char *path, ImportChunk *chunks, int chunkCount,
+                              const int *lineBase, int rowCount) {
+    if (!checkImportSpace(path, rowCount, customerCount, importRecordNames[IMPORT_CUSTOMERS])) {
+        return -1;
+    }
+    
+    ImportKeySet ids;
+    Customer *newCustomers = malloc((rowCount > 0 ? rowCount : 1) * sizeof(Customer));
+    int count = 0;
+    
+    if (!newCustomers || !createImportKeySet(&ids, customerCount + rowCount)) {
+        free(newCustomers);
+        reportImportError(path, 0, "out of memory");
+        return -1;
+    }
+    
+    for (int i = 0; i < customerCount; i++) {
+        addImportKey(&ids, hashImportInt(customers[i].id), NULL);
+    }
+    
+    for (int c = 0; c < chunkCount && count >= 0; c++) {
+        const Customer *rows = (const Customer *)chunks[c].rows;
+        
+        for (int r = 0; r < chunks[c].rowCount; r++) {
+            if (!addImportKey(&ids, hashImportInt(rows[r].id), NULL)) {
+                reportImportError(path, lineBase[c] + chunks[c].rowLines[r], "duplicate customer ID");
+                count = -1;
+                break;
+            }
+            newCustomers[count++] = rows[r];
+        }
+    }
+    
+    if (count >= 0 && !appendCustomers(newCustomers, count)) {
+        count = -1;
+    }
+    
+    free(ids.keys);
+    free(newCustomers);
+    return count;
+}
+
+// Function to group the parsed item lines into transactions and add them to the transaction store
+static int commitTransactionRows(const char *path, ImportChunk *chunks, int chunkCount,
+                                 const int *lineBase, int rowCount) {
+    ImportKeySet ids = { NULL, 0 };
+    ImportKeySet newStrings = { NULL, 0 };
+    const TransactionRow *previous = NULL;
+    int newStringCount = 0;
+    int groupCount = 0;
+    
+    if (!createImportKeySet(&ids, transactionCount + rowCount) || !createImportKeySet(&newStrings, rowCount * 2)) {
+        free(ids.keys);
+        reportImportError(path, 0, "out of memory");
+        return -1;
+    }
+    
+    for (int i = 0; i < transactionCount; i++) {
+        addImportKey(&ids, hashImportText(transactions[i].transactionId), transactions[i].transactionId);
+    }
+    
+    // Items must refer to products in the product store
+    loadProductData();
+    loadDictionary();
+    
+    // Consecutive lines with the same ID are items of one transaction; an ID seen
+    // again further on, or already in the store, is a duplicate. The new payment
+    // methods and statuses are only counted here, so a rejected file leaves the dictionary alone
+    for (int c = 0; c < chunkCount; c++) {
+        const TransactionRow *rows = (const TransactionRow *)chunks[c].rows;
+        
+        for (int r = 0; r < chunks[c].rowCount; r++) {
+            int line = lineBase[c] + chunks[c].rowLines[r];
+            
+            if (findProductById(rows[r].item.productId) == -1) {
+                reportImportError(path, line, "unknown product ID");
+                free(ids.keys);
+                free(newStrings.keys);
+                return -1;
+            }
+            
+            if (previous && strcmp(previous->transactionId, rows[r].transactionId) == 0) {
+                previous = &rows[r];
+                continue;
+            }
+            
+            if (!addImportKey(&ids, hashImportText(rows[r].transactionId), rows[r].transactionId)) {
+                reportImportError(path, line, "duplicate transaction ID");
+                free(ids.keys);
+                free(newStrings.keys);
+                return -1;
+            }
+            
+            if (!checkImportString(path, line, rows[r].paymentMethod, &newStrings, &newStringCount) ||
+                !checkImportString(path, line, rows[r].status, &newStrings, &newStringCount)) {
+                free(ids.keys);
+                free(newStrings.keys);
+                return -1;
+            }
+            
+            previous = &rows[r];
+            groupCount++;
+        }
+    }
+    
+    free(ids.keys);
+    free(newStrings.keys);
+    
+    if (!checkImportSpace(path, groupCount, transactionCount, importRecordNames[IMPORT_TRANSACTIONS])) {
+        return -1;
+    }
+    
+    Transaction *newTransactions = calloc(groupCount > 0 ? groupCount : 1, sizeof(Transaction));
+    TransactionStart *starts = malloc((groupCount > 0 ? groupCount : 1) * sizeof(TransactionStart));
+    int count = 0;
+    bool ok = newTransactions != NULL && starts != NULL;
+    
+    if (!ok) {
+        free(newTransactions);
+        free(starts);
+        reportImportError(path, 0, "out of memory");
+        return -1;
+    }
+    
+    previous = NULL;
+    
+    for (int c = 0; c < chunkCount && ok; c++) {
+        const TransactionRow *rows = (const TransactionRow *)chunks[c].rows;
+        
+        for (int r = 0; r < chunks[c].rowCount; r++) {
+            const TransactionRow *row = &rows[r];
+            int line = lineBase[c] + chunks[c].rowLines[r];
+            
+            // The first line of a transaction supplies its date, customer, payment method and status
+            if (!previous || strcmp(previous->transactionId, row->transactionId) != 0) {
+                Transaction *transaction = &newTransactions[count];
+                
+                strcpy(transaction->transactionId, row->transactionId);
+                strcpy(transaction->date, row->date);
+                strcpy(transaction->customerId, row->customerId);
+                starts[count].row = row;
+                starts[count].line = line;
+                count++;
+            }
+            previous = row;
+            
+            // Grow the item array by doubling
+            Transaction *transaction = &newTransactions[count - 1];
+            if (transaction->itemCount == transaction->itemCapacity) {
+                int capacity = transaction->itemCapacity > 0 ? transaction->itemCapacity * 2 : 4;
+                BillingItem *items = realloc(transaction->items, capacity * sizeof(BillingItem));
+                
+                if (!items) {
+                    reportImportError(path, line, "out of memory");
+                    ok = false;
+                    break;
+                }
+                transaction->items = items;
+                transaction->itemCapacity = capacity;
+            }
+            
+            transaction->items[transaction->itemCount++] = row->item;
+            transaction->total += row->item.subtotal;
+        }
+    }
+    
+    // Nothing else can reject the file now, so its strings are interned last
+    for (int i = 0; i < count && ok; i++) {
+        const TransactionRow *row = starts[i].row;
+        
+        newTransactions[i].paymentMethodId = STRING_ID_CASH;
+        newTransactions[i].statusId = STRING_ID_COMPLETED;
+        
+        if (row->paymentMethod[0] != '\0') {
+            ok = internImportString(path, starts[i].line, row->paymentMethod, &newTransactions[i].paymentMethodId);
+        }
+        if (ok && row->status[0] != '\0') {
+            ok = internImportString(path, starts[i].line, row->status, &newTransactions[i].statusId);
+        }
+    }
+    
+    // The store takes ownership of the item arrays of the transactions it accepts
+    if (ok && !appendTransactions(newTransactions, count)) {
+        ok = false;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        free(newTransactions[i].items);
+    }
+    free(newTransactions);
+    free(starts);
+    return ok ? count : -1;
+}
+
+// Function to add the parsed financial records to the financial store
+static int commitFinancialRows(const char *path, ImportChunk *chunks, int chunkCount,
+                               const int *lineBase, int rowCount) {
+    if (!checkImportSpace(path, rowCount, financialRecordCount, importRecordNames[IMPORT_FINANCIAL])) {
+        return -1;
+    }
+    
+    FinancialRecord *records = malloc((rowCount > 0 ? rowCount : 1) * sizeof(FinancialRecord));
+    int count = 0;
+    
+    if (!records) {
+        reportImportError(path, 0, "out of memory");
+        return -1;
+    }
+    
+    for (int c = 0; c < chunkCount && count >= 0; c++) {
+        const FinancialRow *rows = (const FinancialRow *)chunks[c].rows;
+        
+        for (int r = 0; r < chunks[c].rowCount; r++) {
+            records[count] = rows[r].record;
+            
+            if (!internImportString(path, lineBase[c] + chunks[c].rowLines[r], rows[r].category,
+                                    &records[count].categoryId)) {
+                count = -1;
+                break;
+            }
+            count++;
+        }
+    }
+    
+    if (count >= 0 && !appendFinancialRecords(records, count)) {
+        count = -1;
+    }
+    
+    free(records);
+    return count;
+}
+
+// Function to import every line of a CSV file into a store
+bool importCsvFile(ImportKind kind, const char *path) {
+    double start = getMonotonicMilliseconds();
+    MappedDataFile file;
+    
+    // Start from the current contents of the store so IDs are checked against them
+    switch (kind) {
+        case IMPORT_PRODUCTS:
+            loadProductData();
+            break;
+        case IMPORT_CUSTOMERS:
+            loadCustomerData();
+            break;
+        case IMPORT_TRANSACTIONS:
+            loadTransactionData();
+            break;
+        default:
+            loadFinancialData();
+            break;
+    }
+    
+    if (!mapTextFile(path, &file)) {
+        reportImportError(path, 0, "cannot open file");
+        return false;
+    }
+    
+    const char *data = (const char *)file.payload;
+    const char *end = data + file.payloadSize;
+    
+    // Skip the byte order mark spreadsheet programs put at the start of UTF-8 files
+    if (end - data >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        data += 3;
+    }
+    
+    // Split the file into slices that end at record boundaries, never inside a quoted field
+    int chunkCount = (int)((size_t)(end - data) / IMPORT_MIN_CHUNK_SIZE) + 1;
+    if (chunkCount > IMPORT_MAX_CHUNKS) {
+        chunkCount = IMPORT_MAX_CHUNKS;
+    }
+    
+    ImportChunk chunks[IMPORT_MAX_CHUNKS];
+    ParallelTask tasks[IMPORT_MAX_CHUNKS];
+    const char *sliceStart = data;
+    
+    memset(chunks, 0, sizeof(chunks));
+    
+    for (int i = 0; i < chunkCount; i++) {
+        const char *sliceEnd = end;
+        
+        if (i < chunkCount - 1) {
+            const char *target = data + (size_t)(end - data) * (i + 1) / chunkCount;
+            if (target < sliceStart) {
+                target = sliceStart;
+            }
+            
+            // Whether a line break is inside quotes depends on everything before it,
+            // so walk the records from the start of the slice
+            const char *recordStart = sliceStart;
+            const char *recordEnd;
+            int embeddedBreaks;
+            
+            while ((recordEnd = findRecordEnd(recordStart, end, &embeddedBreaks)) != NULL && recordEnd < target) {
+                recordStart = recordEnd + 1;
+            }
+            sliceEnd = recordEnd ? recordEnd + 1 : end;
+        }
+        
+        chunks[i].kind = kind;
+        chunks[i].start = sliceStart;
+        chunks[i].end = sliceEnd;
+        chunks[i].firstSlice = i == 0;
+        
+        tasks[i].function = parseImportChunk;
+        tasks[i].argument = &chunks[i];
+        tasks[i].elapsedMilliseconds = 0.0;
+        
+        sliceStart = sliceEnd;
+    }
+    
+    runParallelTasks(tasks, chunkCount, getWorkerThreadCount());
+    
+    // Turn slice line numbers into file line numbers, stopping at the first bad line
+    int lineBase[IMPORT_MAX_CHUNKS];
+    int rowCount = 0;
+    int imported = -1;
+    bool parsed = true;
+    
+    for (int i = 0; i < chunkCount; i++) {
+        lineBase[i] = i > 0 ? lineBase[i - 1] + chunks[i - 1].lineCount : 0;
+        
+        if (chunks[i].error) {
+            reportImportError(path, chunks[i].errorLine > 0 ? lineBase[i] + chunks[i].errorLine : 0,
+                              chunks[i].error);
+            parsed = false;
+            break;
+        }
+        rowCount += chunks[i].rowCount;
+    }
+    
+    if (parsed) {
+        switch (kind) {
+            case IMPORT_PRODUCTS:
+                imported = commitProductRows(path, chunks, chunkCount, lineBase, rowCount);
+                break;
+            case IMPORT_CUSTOMERS:
+                imported = commitCustomerRows(path, chunks, chunkCount, lineBase, rowCount);
+                break;
+            case IMPORT_TRANSACTIONS:
+                imported = commitTransactionRows(path, chunks, chunkCount, lineBase, rowCount);
+                break;
+            default:
+                imported = commitFinancialRows(path, chunks, chunkCount, lineBase, rowCount);
+                break;
+        }
+    }
+    
+    for (int i = 0; i < chunkCount; i++) {
+        free(chunks[i].rows);
+        free(chunks[i].rowLines);
+    }
+    unmapDataFile(&file);
+    
+    if (imported < 0) {
+        return false;
+    }
+    
+    char message[100];
+    snprintf(message, sizeof(message), "Imported %d %s in %.1f ms.", imported, importRecordNames[kind],
+             getMonotonicMilliseconds() - start);
+    displaySuccess(message);
+    return true;
+}
\ No newline at end of file
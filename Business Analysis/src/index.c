@@ -0,0 +1,522 @@
+/**
+ * Index Implementation File
+ * Contains implementations of the secondary lookup indexes
+ */
+
+#include "index.h"
+#include "customer.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "globals.h"
+
+// Customer entry in the customer-to-transactions index
+typedef struct {
+    bool used;            // Whether this bucket holds a customer
+    int customerId;       // ID of the customer
+    int firstSlot;        // First transaction in the customer's posting list
+    int lastSlot;         // Last transaction in the customer's posting list
+    int count;            // Number of transactions in the posting list
+} CustomerPostings;
+
+// Hash table of customers, posting lists are chained through nextCustomerSlot
+static CustomerPostings customerBuckets[CUSTOMER_INDEX_BUCKETS];
+static int nextCustomerSlot[MAX_ARRAY_SIZE];
+
+// Product entry in the product-to-transactions index
+typedef struct {
+    bool used;               // Whether this bucket holds a product
+    int productId;           // ID of the product
+    int lastSlot;            // Transaction slot of the last posting (base for the next delta)
+    unsigned char *data;     // Postings as varint (slot delta, item offset) pairs
+    size_t length;           // Number of bytes used in data
+    size_t capacity;         // Number of bytes allocated for data
+} ProductPostings;
+
+// Hash table of products with their encoded posting lists
+static ProductPostings productBuckets[PRODUCT_INDEX_BUCKETS];
+
+// Function to find the bucket for a customer ID (linear probing)
+static CustomerPostings *findCustomerBucket(int customerId, bool create) {
+    unsigned int hash = (unsigned int)customerId * 2654435761u;
+    
+    for (int probe = 0; probe < CUSTOMER_INDEX_BUCKETS; probe++) {
+        CustomerPostings *bucket = &customerBuckets[(hash + probe) & (CUSTOMER_INDEX_BUCKETS - 1)];
+        
+        if (!bucket->used) {
+            if (!create) {
+                return NULL;
+            }
+            
+            bucket->used = true;
+            bucket->customerId = customerId;
+            bucket->firstSlot = -1;
+            bucket->lastSlot = -1;
+            bucket->count = 0;
+            return bucket;
+        }
+        
+        if (bucket->customerId == customerId) {
+            return bucket;
+        }
+    }
+    
+    return NULL; // Table is full
+}
+
+// Function to rebuild all transaction indexes
+void rebuildTransactionIndexes() {
+    rebuildCustomerTransactionIndex();
+    rebuildProductTransactionIndex();
+}
+
+// Function to add a transaction to all transaction indexes
+void indexTransaction(int slot) {
+    indexCustomerTransaction(slot);
+    indexProductTransaction(slot);
+}
+
+// Function to rebuild the customer-to-transactions index
+void rebuildCustomerTransactionIndex() {
+    memset(customerBuckets, 0, sizeof(customerBuckets));
+    
+    for (int i = 0; i < transactionCount; i++) {
+        indexCustomerTransaction(i);
+    }
+}
+
+// Function to add a transaction to the customer-to-transactions index
+bool indexCustomerTransaction(int slot) {
+    int customerId;
+    
+    if (slot < 0 || slot >= MAX_ARRAY_SIZE) {
+        return false;
+    }
+    
+    // Anonymous and free-text customer IDs are not indexed
+    if (!parseCustomerId(transactions[slot].customerId, &customerId)) {
+        return false;
+    }
+    
+    CustomerPostings *bucket = findCustomerBucket(customerId, true);
+    if (!bucket) {
+        return false;
+    }
+    
+    // Append to the end of the posting list
+    nextCustomerSlot[slot] = -1;
+    if (bucket->lastSlot == -1) {
+        bucket->firstSlot = slot;
+    } else {
+        nextCustomerSlot[bucket->lastSlot] = slot;
+    }
+    bucket->lastSlot = slot;
+    bucket->count++;
+    
+    return true;
+}
+
+// Function to get the transactions made by a customer
+int getCustomerTransactions(int customerId, int *slots, int maxSlots) {
+    CustomerPostings *bucket = findCustomerBucket(customerId, false);
+    int count = 0;
+    
+    if (!bucket) {
+        return 0;
+    }
+    
+    for (int slot = bucket->firstSlot; slot != -1 && count < maxSlots; slot = nextCustomerSlot[slot]) {
+        slots[count++] = slot;
+    }
+    
+    return count;
+}
+
+// Function to find the bucket for a product ID (linear probing)
+static ProductPostings *findProductBucket(int productId, bool create) {
+    unsigned int hash = (unsigned int)productId * 2654435761u;
+    
+    for (int probe = 0; probe < PRODUCT_INDEX_BUCKETS; probe++) {
+        ProductPostings *bucket = &productBuckets[(hash + probe) & (PRODUCT_INDEX_BUCKETS - 1)];
+        
+        if (!bucket->used) {
+            if (!create) {
+                return NULL;
+            }
+            
+            bucket->used = true;
+            bucket->productId = productId;
+            bucket->lastSlot = 0;
+            bucket->length = 0;
+            return bucket;
+        }
+        
+        if (bucket->productId == productId) {
+            return bucket;
+        }
+    }
+    
+    return NULL; // Table is full
+}
+
+// Function to rebuild the product-to-transactions index
+void rebuildProductTransactionIndex() {
+    for (int i = 0; i < PRODUCT_INDEX_BUCKETS; i++) {
+        free(productBuckets[i].data);
+    }
+    memset(productBuckets, 0, sizeof(productBuckets));
+    
+    for (int i = 0; i < transactionCount; i++) {
+        indexProductTransaction(i);
+    }
+}
+
+// Function to add the items of a transaction to the product-to-transactions index
+bool indexProductTransaction(int slot) {
+    if (slot < 0 || slot >= MAX_ARRAY_SIZE) {
+        return false;
+    }
+    
+    const Transaction *transaction = &transactions[slot];
+    
+    for (int i = 0; i < transaction->itemCount; i++) {
+        ProductPostings *bucket = findProductBucket(transaction->items[i].productId, true);
+        if (!bucket) {
+            return false;
+        }
+        
+        // Make room for two varints
+        if (bucket->length + 10 > bucket->capacity) {
+            size_t newCapacity = bucket->capacity > 0 ? bucket->capacity * 2 : 32;
+            unsigned char *newData = realloc(bucket->data, newCapacity);
+            if (!newData) {
+                return false;
+            }
+            bucket->data = newData;
+            bucket->capacity = newCapacity;
+        }
+        
+        // Slots are appended in increasing order, so store the gap from the previous posting
+        bucket->length += encodeVarint((unsigned int)(slot - bucket->lastSlot), bucket->data + bucket->length);
+        bucket->length += encodeVarint((unsigned int)i, bucket->data + bucket->length);
+        bucket->lastSlot = slot;
+    }
+    
+    return true;
+}
+
+// Function to open a cursor over the postings of a product
+bool openProductPostings(int productId, ProductPostingCursor *cursor) {
+    ProductPostings *bucket = findProductBucket(productId, false);
+    
+    if (!bucket || bucket->length == 0) {
+        cursor->position = NULL;
+        cursor->end = NULL;
+        cursor->slot = 0;
+        return false;
+    }
+    
+    cursor->position = bucket->data;
+    cursor->end = bucket->data + bucket->length;
+    cursor->slot = 0;
+    return true;
+}
+
+// Function to read the next posting from a product cursor
+bool nextProductPosting(ProductPostingCursor *cursor, int *slot, int *itemOffset) {
+    unsigned int delta, offset;
+    
+    if (!cursor->position || cursor->position >= cursor->end) {
+        return false;
+    }
+    
+    cursor->position = decodeVarint(cursor->position, cursor->end, &delta);
+    if (!cursor->position) {
+        return false;
+    }
+    
+    cursor->position = decodeVarint(cursor->position, cursor->end, &offset);
+    if (!cursor->position) {
+        return false;
+    }
+    
+    cursor->slot += (int)delta;
+    *slot = cursor->slot;
+    *itemOffset = (int)offset;
+    return true;
+}
+
+// Function to hash a string key (FNV-1a)
+static unsigned int hashStringKey(const char *key) {
+    unsigned int hash = 2166136261u;
+    
+    for (; *key; key++) {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+    }
+    
+    return hash;
+}
+
+// Function to find the bucket holding a key with a value, or -1 if not present
+static int findStringIndexBucket(const StringHashIndex *index, const char *key, int value) {
+    unsigned int hash = hashStringKey(key);
+    
+    for (int probe = 0; probe < STRING_INDEX_BUCKETS; probe++) {
+        int bucket = (int)((hash + probe) & (STRING_INDEX_BUCKETS - 1));
+        const StringIndexEntry *entry = &index->entries[bucket];
+        
+        if (entry->state == 0) {
+            return -1;
+        }
+        
+        if (entry->state == 1 && entry->value == value && strcmp(entry->key, key) == 0) {
+            return bucket;
+        }
+    }
+    
+    return -1;
+}
+
+// Function to remove all entries from an exact-match string index
+void clearStringIndex(StringHashIndex *index) {
+    memset(index, 0, sizeof(StringHashIndex));
+}
+
+// Function to add a value for a key to an exact-match string index
+bool addStringIndexEntry(StringHashIndex *index, const char *key, int value) {
+    if (!key || key[0] == '\0' || findStringIndexBucket(index, key, value) != -1) {
+        return false;
+    }
+    
+    unsigned int hash = hashStringKey(key);
+    
+    for (int probe = 0; probe < STRING_INDEX_BUCKETS; probe++) {
+        StringIndexEntry *entry = &index->entries[(hash + probe) & (STRING_INDEX_BUCKETS - 1)];
+        
+        // Reuse empty and deleted buckets
+        if (entry->state != 1) {
+            safeStringCopy(entry->key, sizeof(entry->key), key);
+            entry->value = value;
+            entry->state = 1;
+            return true;
+        }
+    }
+    
+    return false; // Index is full
+}
+
+// Function to remove one value of a key from an exact-match string index
+bool removeStringIndexEntry(StringHashIndex *index, const char *key, int value) {
+    int bucket = findStringIndexBucket(index, key, value);
+    
+    if (bucket == -1) {
+        return false;
+    }
+    
+    // Leave a tombstone so later keys in the probe sequence stay reachable
+    index->entries[bucket].state = 2;
+    return true;
+}
+
+// Function to look up every value stored for a key in an exact-match string index
+int findStringIndexEntries(const StringHashIndex *index, const char *key, int *values, int maxValues) {
+    if (!key || key[0] == '\0') {
+        return 0;
+    }
+    
+    unsigned int hash = hashStringKey(key);
+    int found = 0;
+    
+    // Every value of the key lies on its probe sequence, before the first empty bucket
+    for (int probe = 0; probe < STRING_INDEX_BUCKETS; probe++) {
+        const StringIndexEntry *entry = &index->entries[(hash + probe) & (STRING_INDEX_BUCKETS - 1)];
+        
+        if (entry->state == 0) {
+            break;
+        }
+        
+        if (entry->state == 1 && strcmp(entry->key, key) == 0) {
+            if (found < maxValues) {
+                values[found] = entry->value;
+            }
+            found++;
+        }
+    }
+    
+    return found;
+}
+
+// Function to hash a case-folded trigram into a bucket
+static int hashTrigram(const char *text) {
+    unsigned int value = ((unsigned int)tolower((unsigned char)text[0]) << 16) |
+                         ((unsigned int)tolower((unsigned char)text[1]) << 8) |
+                         (unsigned int)tolower((unsigned char)text[2]);
+    
+    return (int)(((value * 2654435761u) >> 16) & (TRIGRAM_BUCKETS - 1));
+}
+
+// Function to build a trigram index over a text field
+bool buildTrigramIndex(TrigramIndex *index, int recordCount, TrigramTextGetter getText) {
+    int lastSlot[TRIGRAM_BUCKETS];
+    int fill[TRIGRAM_BUCKETS];
+    
+    index->valid = false;
+    memset(index->bucketStart, 0, sizeof(index->bucketStart));
+    
+    // First pass: count distinct trigrams per record into each bucket
+    for (int b = 0; b < TRIGRAM_BUCKETS; b++) {
+        lastSlot[b] = -1;
+    }
+    
+    for (int slot = 0; slot < recordCount; slot++) {
+        const char *text = getText(slot);
+        
+        for (size_t i = 0; text[i] && text[i + 1] && text[i + 2]; i++) {
+            int bucket = hashTrigram(text + i);
+            if (lastSlot[bucket] != slot) {
+                lastSlot[bucket] = slot;
+                index->bucketStart[bucket + 1]++;
+            }
+        }
+    }
+    
+    for (int b = 0; b < TRIGRAM_BUCKETS; b++) {
+        index->bucketStart[b + 1] += index->bucketStart[b];
+    }
+    
+    int total = index->bucketStart[TRIGRAM_BUCKETS];
+    int *postings = realloc(index->postings, (total > 0 ? total : 1) * sizeof(int));
+    if (!postings) {
+        return false;
+    }
+    index->postings = postings;
+    
+    // Second pass: fill the postings in slot order
+    for (int b = 0; b < TRIGRAM_BUCKETS; b++) {
+        lastSlot[b] = -1;
+        fill[b] = index->bucketStart[b];
+    }
+    
+    for (int slot = 0; slot < recordCount; slot++) {
+        const char *text = getText(slot);
+        
+        for (size_t i = 0; text[i] && text[i + 1] && text[i + 2]; i++) {
+            int bucket = hashTrigram(text + i);
+            if (lastSlot[bucket] != slot) {
+                lastSlot[bucket] = slot;
+                index->postings[fill[bucket]++] = slot;
+            }
+        }
+    }
+    
+    index->recordCount = recordCount;
+    index->valid = true;
+    return true;
+}
+
+// Function to mark a trigram index as out of date
+void invalidateTrigramIndex(TrigramIndex *index) {
+    index->valid = false;
+}
+
+// Function to find the records whose text contains a substring (case-insensitive)
+int searchTrigramIndex(TrigramIndex *index, int recordCount, TrigramTextGetter getText,
+                       const char *query, bool *matches) {
+    char loweredQuery[MAX_DESCRIPTION_LENGTH];
+    int found = 0;
+    
+    // Lowercase the query once instead of once per record
+    size_t length = safeStringCopy(loweredQuery, sizeof(loweredQuery), query);
+    for (size_t i = 0; i < length; i++) {
+        loweredQuery[i] = (char)tolower((unsigned char)loweredQuery[i]);
+    }
+    
+    if (!index->valid || index->recordCount != recordCount) {
+        buildTrigramIndex(index, recordCount, getText);
+    }
+    
+    // Short queries (or a failed build) have no trigrams to narrow the search
+    if (length < 3 || !index->valid) {
+        for (int slot = 0; slot < recordCount; slot++) {
+            if (!matches[slot] && containsIgnoreCase(getText(slot), loweredQuery)) {
+                matches[slot] = true;
+                found++;
+            }
+        }
+        return found;
+    }
+    
+    // Collect the distinct buckets of the query's trigrams, remembering the smallest
+    int buckets[MAX_DESCRIPTION_LENGTH];
+    int bucketCount = 0;
+    int smallest = -1;
+    
+    for (size_t i = 0; i + 2 < length; i++) {
+        int bucket = hashTrigram(loweredQuery + i);
+        bool exists = false;
+        
+        for (int j = 0; j < bucketCount; j++) {
+            if (buckets[j] == bucket) {
+                exists = true;
+                break;
+            }
+        }
+        
+        if (!exists) {
+            int size = index->bucketStart[bucket + 1] - index->bucketStart[bucket];
+            if (smallest == -1 || size < index->bucketStart[smallest + 1] - index->bucketStart[smallest]) {
+                smallest = bucket;
+            }
+            buckets[bucketCount++] = bucket;
+        }
+    }
+    
+    // Start from the smallest posting list and intersect the others into it
+    int candidateCount = index->bucketStart[smallest + 1] - index->bucketStart[smallest];
+    if (candidateCount == 0) {
+        return 0;
+    }
+    
+    int *candidates = malloc(candidateCount * sizeof(int));
+    if (!candidates) {
+        return 0;
+    }
+    memcpy(candidates, index->postings + index->bucketStart[smallest], candidateCount * sizeof(int));
+    
+    for (int j = 0; j < bucketCount && candidateCount > 0; j++) {
+        if (buckets[j] == smallest) {
+            continue;
+        }
+        
+        const int *list = index->postings + index->bucketStart[buckets[j]];
+        int listLength = index->bucketStart[buckets[j] + 1] - index->bucketStart[buckets[j]];
+        int kept = 0;
+        int k = 0;
+        
+        for (int c = 0; c < candidateCount; c++) {
+            while (k < listLength && list[k] < candidates[c]) {
+                k++;
+            }
+            if (k < listLength && list[k] == candidates[c]) {
+                candidates[kept++] = candidates[c];
+            }
+        }
+        candidateCount = kept;
+    }
+    
+    // Verify candidates, since different trigrams can share a bucket
+    for (int c = 0; c < candidateCount; c++) {
+        int slot = candidates[c];
+        if (!matches[slot] && containsIgnoreCase(getText(slot), loweredQuery)) {
+            matches[slot] = true;
+            found++;
+        }
+    }
+    
+    free(candidates);
+    return found;
+}
\ No newline at end of file
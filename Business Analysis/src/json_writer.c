@@ -0,0 +1,206 @@
+/**
+ * JSON Writer Implementation File
+ * Contains implementations of the buffered JSON and NDJSON report writer
+ */
+
+#include "json_writer.h"
+#include "csv_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Function to write the buffered bytes to the file
+static void flushJsonWriter(JsonWriter *writer) {
+    if (writer->length > 0 && fwrite(writer->buffer, 1, writer->length, writer->file) != writer->length) {
+        writer->failed = true;
+    }
+    writer->length = 0;
+}
+
+// Function to append bytes to the buffer
+static void appendJsonBytes(JsonWriter *writer, const char *bytes, size_t count) {
+    // Anything bigger than the buffer goes straight to the file
+    if (count > JSON_WRITER_BUFFER_SIZE) {
+        flushJsonWriter(writer);
+        if (fwrite(bytes, 1, count, writer->file) != count) {
+            writer->failed = true;
+        }
+        return;
+    }
+    
+    if (writer->length + count > JSON_WRITER_BUFFER_SIZE) {
+        flushJsonWriter(writer);
+    }
+    memcpy(writer->buffer + writer->length, bytes, count);
+    writer->length += count;
+}
+
+// Function to append text to the buffer
+static void appendJsonText(JsonWriter *writer, const char *text) {
+    appendJsonBytes(writer, text, strlen(text));
+}
+
+// Function to append a quoted string, escaping quotes, backslashes and control characters
+static void appendJsonQuoted(JsonWriter *writer, const char *text) {
+    appendJsonBytes(writer, "\"", 1);
+    
+    while (*text) {
+        // Copy the run of characters that need no escaping in one go
+        size_t run = 0;
+        while (text[run] && text[run] != '"' && text[run] != '\\' && (unsigned char)text[run] >= 0x20) {
+            run++;
+        }
+        appendJsonBytes(writer, text, run);
+        text += run;
+    
+        if (!*text) {
+            break;
+        }
+    
+        char escape[8];
+        switch (*text) {
+            case '"': strcpy(escape, "\\\""); break;
+            case '\\': strcpy(escape, "\\\\"); break;
+            case '\n': strcpy(escape, "\\n"); break;
+            case '\r': strcpy(escape, "\\r"); break;
+            case '\t': strcpy(escape, "\\t"); break;
+            default: snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char)*text); break;
+        }
+        appendJsonText(writer, escape);
+        text++;
+    }
+    
+    appendJsonBytes(writer, "\"", 1);
+}
+
+// Function to write a field name, with a separator before every field but the first
+static void startJsonField(JsonWriter *writer, const char *key) {
+    if (writer->fieldWritten) {
+        appendJsonBytes(writer, ",", 1);
+    }
+    writer->fieldWritten = true;
+    
+    appendJsonQuoted(writer, key);
+    appendJsonBytes(writer, ":", 1);
+}
+
+// Function to start a report and write its header
+bool openJsonReport(JsonWriter *writer, const char *path, bool lineDelimited,
+                    const char *report, const char *startDate, const char *endDate) {
+    memset(writer, 0, sizeof(JsonWriter));
+    writer->lineDelimited = lineDelimited;
+    
+    writer->buffer = malloc(JSON_WRITER_BUFFER_SIZE);
+    if (!writer->buffer) {
+        return false;
+    }
+    
+    if (!path || strcmp(path, "-") == 0) {
+        writer->file = stdout;
+    } else {
+        writer->file = fopen(path, "w");
+        writer->ownsFile = true;
+    }
+    
+    if (!writer->file) {
+        free(writer->buffer);
+        writer->buffer = NULL;
+        return false;
+    }
+    
+    // The header is the first NDJSON line, or the opening of the document object
+    if (lineDelimited) {
+        beginJsonRecord(writer, "report");
+    } else {
+        appendJsonBytes(writer, "{", 1);
+    }
+    
+    writeJsonString(writer, "report", report);
+    writeJsonString(writer, "startDate", startDate && strlen(startDate) > 0 ? startDate : NULL);
+    writeJsonString(writer, "endDate", endDate && strlen(endDate) > 0 ? endDate : NULL);
+    
+    if (lineDelimited) {
+        endJsonRecord(writer);
+    } else {
+        appendJsonText(writer, ",\"records\":[");
+    }
+    
+    return true;
+}
+
+// Function to finish the report and close the file
+bool closeJsonReport(JsonWriter *writer) {
+    if (!writer->lineDelimited) {
+        appendJsonText(writer, writer->recordCount > 0 ? "\n]}\n" : "]}\n");
+    }
+    
+    flushJsonWriter(writer);
+    
+    if (writer->ownsFile) {
+        if (fclose(writer->file) != 0) {
+            writer->failed = true;
+        }
+    } else if (fflush(writer->file) != 0) {
+        writer->failed = true;
+    }
+    
+    free(writer->buffer);
+    writer->buffer = NULL;
+    writer->file = NULL;
+    return !writer->failed;
+}
+
+// Function to start a record
+void beginJsonRecord(JsonWriter *writer, const char *type) {
+    // Records of a document are array elements, one per line for readability
+    if (!writer->lineDelimited) {
+        appendJsonText(writer, writer->recordCount > 0 ? ",\n" : "\n");
+    }
+    writer->recordCount++;
+    
+    appendJsonBytes(writer, "{", 1);
+    writer->fieldWritten = false;
+    writeJsonString(writer, "type", type);
+}
+
+// Function to end the current record
+void endJsonRecord(JsonWriter *writer) {
+    appendJsonText(writer, writer->lineDelimited ? "}\n" : "}");
+    writer->fieldWritten = false;
+}
+
+// Function to write a text field
+void writeJsonString(JsonWriter *writer, const char *key, const char *value) {
+    startJsonField(writer, key);
+    
+    if (value) {
+        appendJsonQuoted(writer, value);
+    } else {
+        appendJsonBytes(writer, "null", 4);
+    }
+}
+
+// Function to write a whole number field
+void writeJsonInt(JsonWriter *writer, const char *key, long long value) {
+    char text[FIXED_NUMBER_LENGTH];
+    
+    startJsonField(writer, key);
+    appendJsonBytes(writer, text, formatFixed((double)value, 0, text));
+}
+
+// Function to write a number field with a fixed number of decimals
+void writeJsonNumber(JsonWriter *writer, const char *key, double value, int decimals) {
+    char text[FIXED_NUMBER_LENGTH];
+    
+    startJsonField(writer, key);
+    
+    // JSON has no NaN or infinity, such as a percentage of a zero total
+    if (!isfinite(value)) {
+        appendJsonBytes(writer, "null", 4);
+        return;
+    }
+    
+    appendJsonBytes(writer, text, formatFixed(value, decimals, text));
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+/**
+ * Lookup Table Implementation File
+ * Contains implementations of the persisted key-to-slot tables
+ */
+
+#include "lookup.h"
+#include "storage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Function to order two lookup entries by key, then slot
+static int compareLookupEntries(const void *a, const void *b) {
+    const LookupEntry *first = (const LookupEntry *)a;
+    const LookupEntry *second = (const LookupEntry *)b;
+    
+    if (first->key != second->key) {
+        return first->key < second->key ? -1 : 1;
+    }
+    
+    return (first->slot > second->slot) - (first->slot < second->slot);
+}
+
+// Function to make room for at least the given number of entries
+static bool reserveLookupEntries(LookupTable *table, int capacity) {
+    if (capacity <= table->capacity) {
+        return true;
+    }
+    
+    int newCapacity = table->capacity > 0 ? table->capacity : 16;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+    
+    LookupEntry *entries = realloc(table->entries, newCapacity * sizeof(LookupEntry));
+    if (!entries) {
+        return false;
+    }
+    
+    table->entries = entries;
+    table->capacity = newCapacity;
+    return true;
+}
+
+// Function to empty a lookup table
+void clearLookupTable(LookupTable *table) {
+    table->count = 0;
+    table->valid = true;
+}
+
+// Function to mark a lookup table as out of date
+void invalidateLookupTable(LookupTable *table) {
+    table->valid = false;
+}
+
+// Function to append an entry without sorting
+bool appendLookupEntry(LookupTable *table, int32_t key, int32_t slot) {
+    if (!reserveLookupEntries(table, table->count + 1)) {
+        return false;
+    }
+    
+    table->entries[table->count].key = key;
+    table->entries[table->count].slot = slot;
+    table->count++;
+    return true;
+}
+
+// Function to sort a lookup table
+void sortLookupTable(LookupTable *table) {
+    if (table->count > 1) {
+        qsort(table->entries, table->count, sizeof(LookupEntry), compareLookupEntries);
+    }
+}
+
+// Function to insert an entry at its sorted position
+bool insertLookupEntry(LookupTable *table, int32_t key, int32_t slot) {
+    if (!reserveLookupEntries(table, table->count + 1)) {
+        return false;
+    }
+    
+    // New records usually have the largest key and slot, so check the end first
+    int position = table->count;
+    LookupEntry entry = { key, slot };
+    
+    if (position > 0 && compareLookupEntries(&table->entries[position - 1], &entry) > 0) {
+        position = findLookupLowerBound(table, key);
+        while (position < table->count && table->entries[position].key == key &&
+               table->entries[position].slot < slot) {
+            position++;
+        }
+        
+        memmove(&table->entries[position + 1], &table->entries[position],
+                (table->count - position) * sizeof(LookupEntry));
+    }
+    
+    table->entries[position] = entry;
+    table->count++;
+    return true;
+}
+
+// Function to find the first entry whose key is not less than the given key
+int findLookupLowerBound(const LookupTable *table, int32_t key) {
+    int low = 0;
+    int high = table->count;
+    
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        
+        if (table->entries[mid].key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    
+    return low;
+}
+
+// Function to load a saved lookup table if it still matches its data file
+bool loadLookupTable(LookupTable *table, const char *path, uint64_t sourceGeneration) {
+    MappedDataFile file;
+    
+    invalidateLookupTable(table);
+    
+    if (sourceGeneration == 0 || !mapDataFile(path, sizeof(LookupEntry), &file)) {
+        return false;
+    }
+    
+    // A table built from another version of the data file is stale
+    int count = (int)file.header->recordCount;
+    if (file.header->sourceGeneration != sourceGeneration || !reserveLookupEntries(table, count)) {
+        unmapDataFile(&file);
+        return false;
+    }
+    
+    if (count > 0) {
+        memcpy(table->entries, file.payload, count * sizeof(LookupEntry));
+    }
+    table->count = count;
+    table->valid = true;
+    
+    unmapDataFile(&file);
+    return true;
+}
+
+// Function to save a lookup table next to its data file
+bool saveLookupTable(const LookupTable *table, const char *path, uint64_t sourceGeneration) {
+    return writeIndexFile(path, sourceGeneration, sizeof(LookupEntry), table->count,
+                          table->entries, table->count * sizeof(LookupEntry));
+}
\ No newline at end of file
@@ -11,9 +11,64 @@
 #include "billing.h"
 #include "financial.h"
 #include "trend_analysis.h"
+#include "menu.h"
+#include "cli.h"
+#include "migration.h"
 #include "utils.h"
+#include "parallel.h"
 #include "globals.h"
 
+// Number of data stores loaded at startup
+#define STARTUP_STORE_COUNT 4
+
+// Startup load tasks and their timings, shown on the welcome screen
+static ParallelTask startupTasks[STARTUP_STORE_COUNT];
+static const char *startupStoreNames[STARTUP_STORE_COUNT] = {
+    "Products", "Customers", "Transactions", "Financial records"
+};
+static double startupTotalMilliseconds = 0.0;
+
+// Function to load the product store at startup
+static void loadProductsTask(void *argument) {
+    (void)argument;
+    loadProductData();
+}
+
+// Function to load the customer store and its contact indexes at startup
+static void loadCustomersTask(void *argument) {
+    (void)argument;
+    loadCustomerData();
+}
+
+// Function to load the transaction store and its indexes at startup
+static void loadTransactionsTask(void *argument) {
+    (void)argument;
+    loadTransactionData();
+}
+
+// Function to load the financial store at startup
+static void loadFinancialTask(void *argument) {
+    (void)argument;
+    loadFinancialData();
+}
+
+// Function to load all stores concurrently so startup takes as long as the largest one
+static void loadStartupData() {
+    ParallelTaskFunction functions[STARTUP_STORE_COUNT] = {
+        loadProductsTask, loadCustomersTask, loadTransactionsTask, loadFinancialTask
+    };
+    
+    for (int i = 0; i < STARTUP_STORE_COUNT; i++) {
+        startupTasks[i].function = functions[i];
+        startupTasks[i].argument = NULL;
+        startupTasks[i].elapsedMilliseconds = 0.0;
+    }
+    
+    double start = getMonotonicMilliseconds();
+    runParallelTasks(startupTasks, STARTUP_STORE_COUNT, getWorkerThreadCount());
+    startupTotalMilliseconds = getMonotonicMilliseconds() - start;
+}
+
 void displayMainMenu() {
     printf("\n\033[1;36m========================================\033[0m\n");
     printf("\033[1;32m    BUSINESS ANALYSIS AND MANAGEMENT\033[0m\n");
@@ -46,20 +101,43 @@ void displayWelcomeScreen() {
     printf("- \033[1;33mBilling System\033[0m: Generate bills and track transactions\n");
     printf("- \033[1;33mFinancial Analysis\033[0m: Analyze income, expenses, and profitability\n\n");
     
+    printf("Data loaded in %.1f ms:\n", startupTotalMilliseconds);
+    for (int i = 0; i < STARTUP_STORE_COUNT; i++) {
+        printf("  %-18s %8.1f ms\n", startupStoreNames[i], startupTasks[i].elapsedMilliseconds);
+    }
+    printf("\n");
+    
     printf("Press Enter to continue...");
     getchar(); // Wait for user input
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     int choice;
     
     // Initialize system
     initializeSystem();
     
+    // Load the shared string dictionary before any data file that references it
+    loadDictionary();
+    
+    // Convert data files left by the first version before anything loads them
+    migrateLegacyDataFiles();
+    
+    // Commands for scripts and scheduled jobs run without the welcome screen, menus or prompts
+    if (argc >= 2) {
+        return runCommandLine(argc, argv);
+    }
+    
+    // Load the data stores and build their indexes in parallel
+    loadStartupData();
+    
     // Show welcome screen
     displayWelcomeScreen();
     
     do {
+        // Write inventory changes that have waited long enough
+        flushProductChangesIfDue();
+        
         clearScreen();
         displayMainMenu();
         scanf("%d", &choice);
@@ -0,0 +1,293 @@
+/**
+ * Migration Implementation File
+ * Contains the readers for the first version's data files and their conversion
+ */
+
+#include "migration.h"
+#include "customer.h"
+#include "product.h"
+#include "billing.h"
+#include "financial.h"
+#include "dictionary.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+
+// Item cap of a transaction in the first version
+#define LEGACY_ITEMS_PER_TRANSACTION 20
+
+// Product as the first version stored it
+typedef struct {
+    int id;
+    char name[50];
+    double price;
+    int quantity;
+    char category[30];
+    char description[200];
+} LegacyProduct;
+
+// Transaction item as the first version stored it
+typedef struct {
+    int productId;
+    char name[50];
+    double price;
+    int quantity;
+    double subtotal;
+} LegacyBillingItem;
+
+// Transaction as the first version stored it
+typedef struct {
+    char transactionId[20];
+    char date[20];
+    char customerId[20];
+    LegacyBillingItem items[LEGACY_ITEMS_PER_TRANSACTION];
+    int itemCount;
+    double total;
+    char paymentMethod[20];
+    char status[20];
+} LegacyTransaction;
+
+// Financial record as the first version stored it
+typedef struct {
+    char date[20];
+    char category[30];
+    double amount;
+    char type[10];
+    char description[200];
+} LegacyFinancialRecord;
+
+// Function to read a file in the first version's layout: an int record count, then the records
+// Returns false if the file is missing or does not have exactly that layout
+static bool readLegacyFile(const char *path, size_t recordSize, void **records, int *recordCount) {
+    struct stat st;
+    int count;
+    
+    *records = NULL;
+    *recordCount = 0;
+    
+    if (stat(path, &st) != 0 || st.st_size < (long long)sizeof(int)) {
+        return false;
+    }
+    
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    
+    // The size must match the count exactly; a current file starts with the header magic instead
+    if (fread(&count, sizeof(int), 1, file) != 1 || count < 0 || count > MAX_ARRAY_SIZE ||
+        (long long)st.st_size != (long long)(sizeof(int) + (size_t)count * recordSize)) {
+        fclose(file);
+        return false;
+    }
+    
+    void *buffer = malloc(count > 0 ? (size_t)count * recordSize : 1);
+    bool read = buffer && fread(buffer, recordSize, (size_t)count, file) == (size_t)count;
+    fclose(file);
+    
+    if (!read) {
+        free(buffer);
+        return false;
+    }
+    
+    *records = buffer;
+    *recordCount = count;
+    return true;
+}
+
+// Function to move a legacy file aside so the store starts empty, or put it back
+static bool moveLegacyFile(const char *path, bool restore) {
+    char backupPath[260];
+    snprintf(backupPath, sizeof(backupPath), "%s%s", path, LEGACY_BACKUP_SUFFIX);
+    
+    const char *from = restore ? backupPath : path;
+    const char *to = restore ? path : backupPath;
+    
+    // Windows will not rename over an existing file
+    remove(to);
+    return rename(from, to) == 0;
+}
+
+// Function to report the result of converting one file
+static bool finishLegacyFile(const char *path, const char *recordNames, int count, bool converted) {
+    char message[200];
+    
+    if (!converted) {
+        moveLegacyFile(path, true);
+        snprintf(message, sizeof(message), "Could not convert %s from the first version's layout; it was left unchanged.", path);
+        displayError(message);
+        return false;
+    }
+    
+    snprintf(message, sizeof(message), "Converted %d %s from the first version's layout (original kept as %s%s).",
+             count, recordNames, path, LEGACY_BACKUP_SUFFIX);
+    displaySuccess(message);
+    return true;
+}
+
+// Function to convert the first version's customer file
+static bool migrateLegacyCustomers() {
+    Customer *legacy;
+    int count;
+    
+    // The customer record has not changed since the first version
+    if (!readLegacyFile(CUSTOMER_FILE, sizeof(Customer), (void **)&legacy, &count)) {
+        return true;
+    }
+    
+    bool converted = moveLegacyFile(CUSTOMER_FILE, false);
+    if (converted) {
+        loadCustomerData();
+        converted = appendCustomers(legacy, count);
+    }
+    
+    free(legacy);
+    return finishLegacyFile(CUSTOMER_FILE, "customers", count, converted);
+}
+
+// Function to convert the first version's product file into hot records and details
+static bool migrateLegacyProducts() {
+    LegacyProduct *legacy;
+    int count;
+    
+    if (!readLegacyFile(PRODUCT_FILE, sizeof(LegacyProduct), (void **)&legacy, &count)) {
+        return true;
+    }
+    
+    Product newProducts[MAX_ARRAY_SIZE];
+    ProductDetails newDetails[MAX_ARRAY_SIZE];
+    bool converted = true;
+    
+    for (int i = 0; i < count && converted; i++) {
+        memset(&newProducts[i], 0, sizeof(Product));
+        memset(&newDetails[i], 0, sizeof(ProductDetails));
+        
+        newProducts[i].id = legacy[i].id;
+        newProducts[i].price = legacy[i].price;
+        newProducts[i].quantity = legacy[i].quantity;
+        newProducts[i].categoryId = internString(legacy[i].category);
+        
+        newDetails[i].id = legacy[i].id;
+        safeStringCopy(newDetails[i].name, sizeof(newDetails[i].name), legacy[i].name);
+        safeStringCopy(newDetails[i].description, sizeof(newDetails[i].description), legacy[i].description);
+        
+        converted = newProducts[i].categoryId != INVALID_STRING_ID;
+    }
+    
+    converted = converted && moveLegacyFile(PRODUCT_FILE, false);
+    if (converted) {
+        loadProductData();
+        converted = appendProducts(newProducts, newDetails, count);
+    }
+    
+    free(legacy);
+    return finishLegacyFile(PRODUCT_FILE, "products", count, converted);
+}
+
+// Function to convert the first version's transaction file into partitions
+static bool migrateLegacyTransactions() {
+    LegacyTransaction *legacy;
+    int count;
+    
+    if (!readLegacyFile(TRANSACTION_FILE, sizeof(LegacyTransaction), (void **)&legacy, &count)) {
+        return true;
+    }
+    
+    Transaction *newTransactions = calloc(count > 0 ? count : 1, sizeof(Transaction));
+    bool converted = newTransactions != NULL;
+    
+    for (int i = 0; i < count && converted; i++) {
+        const LegacyTransaction *old = &legacy[i];
+        Transaction *transaction = &newTransactions[i];
+        int itemCount = old->itemCount;
+        
+        if (itemCount < 0 || itemCount > LEGACY_ITEMS_PER_TRANSACTION) {
+            converted = false;
+            break;
+        }
+        
+        safeStringCopy(transaction->transactionId, sizeof(transaction->transactionId), old->transactionId);
+        safeStringCopy(transaction->date, sizeof(transaction->date), old->date);
+        safeStringCopy(transaction->customerId, sizeof(transaction->customerId), old->customerId);
+        transaction->total = old->total;
+        transaction->paymentMethodId = internString(old->paymentMethod);
+        transaction->statusId = internString(old->status);
+        
+        // Item names now come from the product store, so only the IDs and amounts are kept
+        transaction->items = malloc((itemCount > 0 ? itemCount : 1) * sizeof(BillingItem));
+        if (!transaction->items || transaction->paymentMethodId == INVALID_STRING_ID ||
+            transaction->statusId == INVALID_STRING_ID) {
+            converted = false;
+            break;
+        }
+        
+        transaction->itemCapacity = itemCount > 0 ? itemCount : 1;
+        transaction->itemCount = itemCount;
+        for (int j = 0; j < itemCount; j++) {
+            transaction->items[j].productId = old->items[j].productId;
+            transaction->items[j].price = old->items[j].price;
+            transaction->items[j].quantity = old->items[j].quantity;
+            transaction->items[j].subtotal = old->items[j].subtotal;
+        }
+    }
+    
+    converted = converted && moveLegacyFile(TRANSACTION_FILE, false);
+    if (converted) {
+        loadTransactionData();
+        converted = appendTransactions(newTransactions, count);
+    }
+    
+    // The store owns the item arrays it took; free whatever it did not
+    for (int i = 0; newTransactions && i < count; i++) {
+        free(newTransactions[i].items);
+    }
+    free(newTransactions);
+    free(legacy);
+    return finishLegacyFile(TRANSACTION_FILE, "transactions", count, converted);
+}
+
+// Function to convert the first version's financial file into blocks
+static bool migrateLegacyFinancialRecords() {
+    LegacyFinancialRecord *legacy;
+    int count;
+    
+    if (!readLegacyFile(FINANCIAL_FILE, sizeof(LegacyFinancialRecord), (void **)&legacy, &count)) {
+        return true;
+    }
+    
+    FinancialRecord newRecords[MAX_ARRAY_SIZE];
+    bool converted = true;
+    
+    for (int i = 0; i < count && converted; i++) {
+        memset(&newRecords[i], 0, sizeof(FinancialRecord));
+        
+        safeStringCopy(newRecords[i].date, sizeof(newRecords[i].date), legacy[i].date);
+        safeStringCopy(newRecords[i].description, sizeof(newRecords[i].description), legacy[i].description);
+        newRecords[i].amount = legacy[i].amount;
+        newRecords[i].categoryId = internString(legacy[i].category);
+        newRecords[i].typeId = internString(legacy[i].type);
+        
+        converted = newRecords[i].categoryId != INVALID_STRING_ID && newRecords[i].typeId != INVALID_STRING_ID;
+    }
+    
+    converted = converted && moveLegacyFile(FINANCIAL_FILE, false);
+    if (converted) {
+        loadFinancialData();
+        converted = appendFinancialRecords(newRecords, count);
+    }
+    
+    free(legacy);
+    return finishLegacyFile(FINANCIAL_FILE, "financial records", count, converted);
+}
+
+// Function to convert every data file still in the first version's layout
+bool migrateLegacyDataFiles() {
+    bool migrated = migrateLegacyCustomers();
+    migrated = migrateLegacyProducts() && migrated;
+    migrated = migrateLegacyTransactions() && migrated;
+    migrated = migrateLegacyFinancialRecords() && migrated;
+    return migrated;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+/**
+ * Parallel Tasks Implementation File
+ * Contains implementations of the portable worker pool
+ */
+
+#include "parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Shared state of one runParallelTasks call
+typedef struct {
+    ParallelTask *tasks;
+    int taskCount;
+    atomic_int nextTask;   // Index of the next task to hand out
+} TaskQueue;
+
+// Function to run tasks from the queue until none are left
+static void drainTaskQueue(TaskQueue *queue) {
+    int index;
+    
+    while ((index = atomic_fetch_add(&queue->nextTask, 1)) < queue->taskCount) {
+        ParallelTask *task = &queue->tasks[index];
+        double start = getMonotonicMilliseconds();
+        
+        task->function(task->argument);
+        task->elapsedMilliseconds = getMonotonicMilliseconds() - start;
+    }
+}
+
+#ifdef _WIN32
+// Function run by each Win32 worker thread
+static DWORD WINAPI workerThreadMain(LPVOID argument) {
+    drainTaskQueue((TaskQueue *)argument);
+    return 0;
+}
+#else
+// Function run by each POSIX worker thread
+static void *workerThreadMain(void *argument) {
+    drainTaskQueue((TaskQueue *)argument);
+    return NULL;
+}
+#endif
+
+// Function to get the number of worker threads worth starting
+int getWorkerThreadCount() {
+    long processors;
+    
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    processors = (long)info.dwNumberOfProcessors;
+#else
+    processors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    
+    if (processors < 1) {
+        return 1;
+    }
+    
+    return processors > MAX_WORKER_THREADS ? MAX_WORKER_THREADS : (int)processors;
+}
+
+// Function to run tasks concurrently and wait for all of them
+void runParallelTasks(ParallelTask *tasks, int taskCount, int threadCount) {
+    TaskQueue queue;
+    queue.tasks = tasks;
+    queue.taskCount = taskCount;
+    atomic_init(&queue.nextTask, 0);
+    
+    // No point starting more threads than there are tasks
+    if (threadCount > taskCount) {
+        threadCount = taskCount;
+    }
+    if (threadCount > MAX_WORKER_THREADS) {
+        threadCount = MAX_WORKER_THREADS;
+    }
+    
+    // The caller is one of the workers, so start one thread fewer
+#ifdef _WIN32
+    HANDLE threads[MAX_WORKER_THREADS];
+#else
+    pthread_t threads[MAX_WORKER_THREADS];
+#endif
+    int started = 0;
+    
+    for (int i = 1; i < threadCount; i++) {
+#ifdef _WIN32
+        threads[started] = CreateThread(NULL, 0, workerThreadMain, &queue, 0, NULL);
+        if (!threads[started]) {
+            break;
+        }
+#else
+        if (pthread_create(&threads[started], NULL, workerThreadMain, &queue) != 0) {
+            break;
+        }
+#endif
+        started++;
+    }
+    
+    drainTaskQueue(&queue);
+    
+    // Wait for the workers to finish their last tasks
+    for (int i = 0; i < started; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+}
+
+// Function to get a monotonic timestamp in milliseconds
+double getMonotonicMilliseconds() {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+#endif
+}
\ No newline at end of file
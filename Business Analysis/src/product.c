@@ -5,341 +5,280 @@
 
 #include "product.h"
 #include "utils.h"
+#include "index.h"
+#include "storage.h"
+#include "lookup.h"
+#include "parallel.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <limits.h>
+#include <math.h>
 #include "globals.h"
 
 // Global array to store products
 extern Product products[MAX_ARRAY_SIZE];
 extern int productCount;
 
-// Function to run the product management module
-void runProductManagement() {
-    int choice;
-    bool running = true;
-
-    // Load product data
-    loadProductData();
-
-    while (running) {
-        clearScreen();
-        printf("\n\033[1;36m========================================\033[0m\n");
-        printf("\033[1;32m        PRODUCT MANAGEMENT\033[0m\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("1. Add Product\n");
-        printf("2. View All Products\n");
-        printf("3. Search Product by ID\n");
-        printf("4. Search Products by Name\n");
-        printf("5. Filter Products by Category\n");
-        printf("6. Manage Inventory\n");
-        printf("7. Edit Product\n");
-        printf("8. Delete Product\n");
-        printf("9. Check Low Stock\n");
-        printf("10. Back to Main Menu\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        clearInputBuffer();
-
-        switch (choice) {
-            case 1:
-                addProduct();
-                pressEnterToContinue();
-                break;
-            case 2:
-                displayAllProducts();
-                pressEnterToContinue();
-                break;
-            case 3: {
-                int id;
-                printf("Enter product ID to search: ");
-                scanf("%d", &id);
-                clearInputBuffer();
-                searchProductById(id);
-                pressEnterToContinue();
-                break;
-            }
-            case 4: {
-                char name[MAX_STRING_LENGTH];
-                printf("Enter product name (or part of name) to search: ");
-                fgets(name, sizeof(name), stdin);
-                name[strcspn(name, "\n")] = 0; // Remove newline character
-                searchProductsByName(name);
-                pressEnterToContinue();
-                break;
-            }
-            case 5: {
-                // Get all unique categories
-                char categories[MAX_ARRAY_SIZE][30];
-                int numCategories = getProductCategories(categories, MAX_ARRAY_SIZE);
-                
-                if (numCategories > 0) {
-                    printf("\nAvailable Categories:\n");
-                    for (int i = 0; i < numCategories; i++) {
-                        printf("%d. %s\n", i + 1, categories[i]);
-                    }
-                    
-                    int categoryChoice;
-                    printf("\nSelect a category (1-%d): ", numCategories);
-                    scanf("%d", &categoryChoice);
-                    clearInputBuffer();
-                    
-                    if (categoryChoice >= 1 && categoryChoice <= numCategories) {
-                        displayProductsByCategory(categories[categoryChoice - 1]);
-                    } else {
-                        printf("Invalid category selection.\n");
-                    }
-                } else {
-                    printf("No categories found.\n");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 6: {
-                int id, quantity;
-                printf("Enter product ID to update inventory: ");
-                scanf("%d", &id);
-                clearInputBuffer();
-                
-                int index = findProductById(id);
-                if (index != -1) {
-                    printf("Current stock for %s: %d\n", products[index].name, products[index].quantity);
-                    printf("Enter quantity to add (positive) or remove (negative): ");
-                    scanf("%d", &quantity);
-                    clearInputBuffer();
-                    
-                    updateProductInventory(id, quantity);
-                } else {
-                    displayError("Product not found.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 7: {
-                int id;
-                printf("Enter product ID to edit: ");
-                scanf("%d", &id);
-                clearInputBuffer();
-                editProduct(id);
-                pressEnterToContinue();
-                break;
-            }
-            case 8: {
-                int id;
-                printf("Enter product ID to delete: ");
-                scanf("%d", &id);
-                clearInputBuffer();
-                deleteProduct(id);
-                pressEnterToContinue();
-                break;
-            }
-            case 9: {
-                int threshold;
-                printf("Enter low stock threshold: ");
-                scanf("%d", &threshold);
-                clearInputBuffer();
-                
-                int lowStockCount = checkLowStock(threshold);
-                if (lowStockCount > 0) {
-                    printf("\n\033[1;33mWarning: %d products are below the threshold of %d units.\033[0m\n", 
-                           lowStockCount, threshold);
-                } else {
-                    printf("\n\033[1;32mAll products are above the threshold of %d units.\033[0m\n", threshold);
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 10:
-                running = false;
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-                pressEnterToContinue();
-        }
-    }
+// Product names and descriptions, parallel to the products array once loaded
+static ProductDetails productDetails[MAX_ARRAY_SIZE];
+static bool productDetailsLoaded = false;
+
+// State of the product file at the last load or save
+static DataFileStamp productFileStamp;
+
+// Product ID to slot table, persisted next to the product file
+static LookupTable productIdLookup;
+
+// Write-behind state: products changed since the last save, and whether the
+// array still lines up record for record with the file so they can be written in place
+static uint64_t dirtyProducts[(MAX_ARRAY_SIZE + 63) / 64];
+static int dirtyProductCount = 0;
+static bool productLayoutChanged = false;
+static bool productDetailsChanged = false;
+static double oldestPendingChange = 0.0;
+static bool flushRegistered = false;
+
+// Times a flush reads the file back and tries again when it was saved elsewhere meanwhile
+#define PRODUCT_FLUSH_ATTEMPTS 3
+
+// The products as the file held them at the last load or save, to tell what each dirty record changed
+static Product storedProducts[MAX_ARRAY_SIZE];
+static int storedProductCount = 0;
+
+// Number of times the records were read back under pending changes, which can move products
+static unsigned int productReloadCount = 0;
+
+// What one dirty product changed, kept while the file is reloaded under it
+typedef struct {
+    int id;                   // Product the change belongs to
+    int quantityChange;       // Stock added (positive) or removed (negative)
+    bool priceChanged;        // Whether price replaces the file's price
+    double price;             // New price
+    bool categoryChanged;     // Whether categoryId replaces the file's category
+    uint32_t categoryId;      // New category
+} PendingProductChange;
+
+// The products and pending changes before a batch, to take the batch back if it cannot be saved
+typedef struct {
+    Product products[MAX_ARRAY_SIZE];
+    uint64_t dirtyProducts[(MAX_ARRAY_SIZE + 63) / 64];
+    int dirtyProductCount;
+    double oldestPendingChange;
+    unsigned int reloadCount;
+} ProductBatchUndo;
+
+// Trigram indexes for product search, rebuilt lazily after products change
+static TrigramIndex productNameIndex;
+static TrigramIndex productDescriptionIndex;
+
+// Function to get a product's name for the trigram index
+static const char *getProductNameText(int slot) {
+    return getProductName(slot);
 }
 
-// Function to add a new product
-bool addProduct() {
-    if (productCount >= MAX_ARRAY_SIZE) {
-        displayError("Product database is full. Cannot add more products.");
-        return false;
-    }
+// Function to get a product's description for the trigram index
+static const char *getProductDescriptionText(int slot) {
+    return getProductDescription(slot);
+}
 
-    Product newProduct;
-    
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           ADD NEW PRODUCT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("Enter ID: ");
-    scanf("%d", &newProduct.id);
-    clearInputBuffer();
-    
-    // Check if ID already exists
-    for (int i = 0; i < productCount; i++) {
-        if (products[i].id == newProduct.id) {
-            displayError("A product with this ID already exists.");
-            return false;
-        }
+// Function to flush pending product changes when the program exits
+static void flushProductChangesAtExit() {
+    flushProductChanges();
+}
+
+// Function to check whether any product change is waiting to be written
+static bool hasPendingProductChanges() {
+    return dirtyProductCount > 0 || productLayoutChanged || productDetailsChanged;
+}
+
+// Function to note the time of the first change since the last save
+static void notePendingChange() {
+    if (!hasPendingProductChanges()) {
+        oldestPendingChange = getMonotonicMilliseconds();
     }
     
-    printf("Enter Name: ");
-    fgets(newProduct.name, sizeof(newProduct.name), stdin);
-    newProduct.name[strcspn(newProduct.name, "\n")] = 0; // Remove newline character
-    
-    printf("Enter Price: ");
-    scanf("%lf", &newProduct.price);
-    clearInputBuffer();
-    
-    printf("Enter Quantity: ");
-    scanf("%d", &newProduct.quantity);
-    clearInputBuffer();
-    
-    printf("Enter Category: ");
-    fgets(newProduct.category, sizeof(newProduct.category), stdin);
-    newProduct.category[strcspn(newProduct.category, "\n")] = 0;
-    
-    printf("Enter Description: ");
-    fgets(newProduct.description, sizeof(newProduct.description), stdin);
-    newProduct.description[strcspn(newProduct.description, "\n")] = 0;
-    
-    // Add the new product to the array
-    products[productCount] = newProduct;
-    productCount++;
-    
-    // Sort products by ID
-    sortProductsById();
+    // Changes still pending at exit are written then
+    if (!flushRegistered) {
+        atexit(flushProductChangesAtExit);
+        flushRegistered = true;
+    }
+}
+
+// Function to mark one product as changed
+static void markProductDirty(int index) {
+    notePendingChange();
     
-    // Save product data
-    if (saveProductData()) {
-        displaySuccess("Product added successfully.");
-        return true;
-    } else {
-        displayError("Failed to save product data.");
-        return false;
+    uint64_t bit = (uint64_t)1 << (index % 64);
+    if (!(dirtyProducts[index / 64] & bit)) {
+        dirtyProducts[index / 64] |= bit;
+        dirtyProductCount++;
     }
 }
 
-// Function to search for a product by ID
-bool searchProductById(int id) {
-    int index = findProductById(id);
+// Function to mark the products array as no longer matching the file record for record
+static void markProductLayoutChanged() {
+    notePendingChange();
+    productLayoutChanged = true;
+}
+
+// Function to forget pending changes once everything has been written
+static void clearPendingProductChanges() {
+    memset(dirtyProducts, 0, sizeof(dirtyProducts));
+    dirtyProductCount = 0;
+    productLayoutChanged = false;
+    productDetailsChanged = false;
+}
+
+// Function to remember the products as they now are in the file
+static void rememberStoredProducts() {
+    memcpy(storedProducts, products, productCount * sizeof(Product));
+    storedProductCount = productCount;
+}
+
+// Function to record the products before a batch changes them
+static void beginProductBatch(ProductBatchUndo *undo) {
+    memcpy(undo->products, products, productCount * sizeof(Product));
+    memcpy(undo->dirtyProducts, dirtyProducts, sizeof(dirtyProducts));
+    undo->dirtyProductCount = dirtyProductCount;
+    undo->oldestPendingChange = oldestPendingChange;
+    undo->reloadCount = productReloadCount;
+}
+
+// Function to take back a batch whose save failed, returning whether it was taken back
+static bool undoProductBatch(const ProductBatchUndo *undo) {
+    // Records the flush did write (only the details failed) are in the file and stay
+    if (dirtyProductCount == 0) {
+        return false;
+    }
     
-    if (index != -1) {
-        printf("\n\033[1;36m========================================\033[0m\n");
-        printf("\033[1;32m            PRODUCT FOUND\033[0m\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        displayProductDetails(&products[index]);
-        return true;
-    } else {
-        displayError("Product not found.");
+    // After the flush read the file back, the products may no longer be in the order recorded
+    if (productReloadCount != undo->reloadCount) {
         return false;
     }
+    
+    memcpy(products, undo->products, productCount * sizeof(Product));
+    memcpy(dirtyProducts, undo->dirtyProducts, sizeof(dirtyProducts));
+    dirtyProductCount = undo->dirtyProductCount;
+    oldestPendingChange = undo->oldestPendingChange;
+    return true;
 }
 
-// Function to search for products by name
-void searchProductsByName(const char *name) {
-    bool found = false;
-    
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           SEARCH RESULTS\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
+// Function to list what each dirty product changed since the file was last read or written
+static int collectPendingProductChanges(PendingProductChange *changes) {
+    int count = 0;
     
     for (int i = 0; i < productCount; i++) {
-        // Case-insensitive search
-        char lowerName[MAX_STRING_LENGTH];
-        char lowerProductName[MAX_STRING_LENGTH];
+        if (!(dirtyProducts[i / 64] & ((uint64_t)1 << (i % 64)))) {
+            continue;
+        }
         
-        // Convert both strings to lowercase
-        strcpy(lowerName, name);
-        strcpy(lowerProductName, products[i].name);
+        // Without a layout change, slot i still holds the record the file has at slot i
+        bool stored = i < storedProductCount && storedProducts[i].id == products[i].id;
         
-        for (int j = 0; lowerName[j]; j++) {
-            lowerName[j] = tolower(lowerName[j]);
-        }
+        changes[count].id = products[i].id;
+        changes[count].quantityChange = stored ? products[i].quantity - storedProducts[i].quantity : 0;
+        changes[count].priceChanged = !stored || products[i].price != storedProducts[i].price;
+        changes[count].price = products[i].price;
+        changes[count].categoryChanged = !stored || products[i].categoryId != storedProducts[i].categoryId;
+        changes[count].categoryId = products[i].categoryId;
+        count++;
+    }
+    
+    return count;
+}
+
+// Function to apply changes collected before a reload to the products just read
+static void reapplyPendingProductChanges(const PendingProductChange *changes, int count, double pendingSince) {
+    for (int i = 0; i < count; i++) {
+        int slot = findProductById(changes[i].id);
         
-        for (int j = 0; lowerProductName[j]; j++) {
-            lowerProductName[j] = tolower(lowerProductName[j]);
+        // A product removed by another process takes its changes with it
+        if (slot == -1) {
+            continue;
         }
         
-        // Check if substring exists
-        if (strstr(lowerProductName, lowerName) != NULL) {
-            displayProductDetails(&products[i]);
-            printf("-------------------\n");
-            found = true;
+        products[slot].quantity += changes[i].quantityChange;
+        if (changes[i].priceChanged) {
+            products[slot].price = changes[i].price;
         }
+        if (changes[i].categoryChanged) {
+            products[slot].categoryId = changes[i].categoryId;
+        }
+        
+        markProductDirty(slot);
     }
     
-    if (!found) {
-        printf("No products found matching '%s'.\n", name);
+    // The changes are as old as they were before the reload
+    if (hasPendingProductChanges()) {
+        oldestPendingChange = pendingSince;
     }
 }
 
-// Function to search for products by category
-void searchProductsByCategory(const char *category) {
-    displayProductsByCategory(category);
-}
-
-// Function to display all products
-void displayAllProducts() {
-    if (productCount == 0) {
-        printf("No products in the database.\n");
-        return;
+// Function to swap two products along with their details
+static void swapProducts(int first, int second) {
+    if (first != second) {
+        markProductLayoutChanged();
+        
+        // The ID lookup may have been rebuilt mid-sort (reading details for a name sort)
+        invalidateLookupTable(&productIdLookup);
     }
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           ALL PRODUCTS\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
+    Product temp = products[first];
+    products[first] = products[second];
+    products[second] = temp;
     
-    for (int i = 0; i < productCount; i++) {
-        displayProductDetails(&products[i]);
-        printf("-------------------\n");
+    // Details that are not loaded yet are matched by ID when they are read
+    if (productDetailsLoaded) {
+        ProductDetails tempDetails = productDetails[first];
+        productDetails[first] = productDetails[second];
+        productDetails[second] = tempDetails;
     }
 }
 
-// Function to display products filtered by category
-void displayProductsByCategory(const char *category) {
-    bool found = false;
-    
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m         PRODUCTS IN CATEGORY: %s\033[0m\n", category);
-    printf("\033[1;36m========================================\033[0m\n");
+// Function to mark the product search indexes as out of date
+static void invalidateProductSearchIndexes() {
+    invalidateTrigramIndex(&productNameIndex);
+    invalidateTrigramIndex(&productDescriptionIndex);
+    invalidateLookupTable(&productIdLookup);
+}
+
+// Function to rebuild the product ID lookup from the products array
+static void rebuildProductIdLookup() {
+    clearLookupTable(&productIdLookup);
     
     for (int i = 0; i < productCount; i++) {
-        if (strcmp(products[i].category, category) == 0) {
-            displayProductDetails(&products[i]);
-            printf("-------------------\n");
-            found = true;
+        if (!appendLookupEntry(&productIdLookup, products[i].id, i)) {
+            invalidateLookupTable(&productIdLookup);
+            return;
         }
     }
     
-    if (!found) {
-        printf("No products found in category '%s'.\n", category);
-    }
+    sortLookupTable(&productIdLookup);
 }
 
-// Function to display details for a specific product
-void displayProductDetails(const Product *product) {
-    printf("ID: %d\n", product->id);
-    printf("Name: %s\n", product->name);
-    printf("Price: $%.2f\n", product->price);
-    printf("Quantity: %d\n", product->quantity);
-    printf("Category: %s\n", product->category);
-    printf("Description: %s\n", product->description);
-    
-    // Highlight low stock
-    if (product->quantity <= 5 && product->quantity > 0) {
-        printf("\033[1;33mLow Stock!\033[0m\n");
-    } else if (product->quantity == 0) {
-        printf("\033[1;31mOut of Stock!\033[0m\n");
+// Function to add a batch of new products and save them once
+bool appendProducts(const Product *newProducts, const ProductDetails *newDetails, int count) {
+    if (productCount + count > MAX_ARRAY_SIZE) {
+        displayError("Product database is full. Cannot add more products.");
+        return false;
     }
+    
+    // Bring in the existing details so the new entries stay aligned with them
+    loadProductDetails();
+    
+    memcpy(&products[productCount], newProducts, count * sizeof(Product));
+    memcpy(&productDetails[productCount], newDetails, count * sizeof(ProductDetails));
+    productCount += count;
+    
+    sortProductsById();
+    return saveProductData();
 }
 
-// Function to edit a product's information
-bool editProduct(int id) {
+// Function to replace a product's price, quantity, category and text
+bool updateProduct(int id, const Product *product, const ProductDetails *details) {
     int index = findProductById(id);
     
     if (index == -1) {
@@ -347,55 +286,28 @@ bool editProduct(int id) {
         return false;
     }
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           EDIT PRODUCT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("Editing product with ID: %d\n", id);
-    printf("Current details:\n");
-    displayProductDetails(&products[index]);
-    
-    printf("\nEnter new details (leave blank to keep current):\n");
-    
-    char buffer[MAX_STRING_LENGTH];
-    
-    printf("Name [%s]: ", products[index].name);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(products[index].name, buffer);
-    }
-    
-    printf("Price [%.2f]: ", products[index].price);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        products[index].price = atof(buffer);
+    // The text is only rewritten when it actually changes
+    if (details && loadProductDetails()) {
+        if (strcmp(productDetails[index].name, details->name) != 0) {
+            safeStringCopy(productDetails[index].name, sizeof(productDetails[index].name), details->name);
+            productDetailsChanged = true;
+        }
+        if (strcmp(productDetails[index].description, details->description) != 0) {
+            safeStringCopy(productDetails[index].description, sizeof(productDetails[index].description),
+                           details->description);
+            productDetailsChanged = true;
+        }
     }
     
-    printf("Quantity [%d]: ", products[index].quantity);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        products[index].quantity = atoi(buffer);
-    }
+    products[index].price = product->price;
+    products[index].quantity = product->quantity;
+    products[index].categoryId = product->categoryId;
     
-    printf("Category [%s]: ", products[index].category);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(products[index].category, buffer);
-    }
+    invalidateProductSearchIndexes();
+    markProductDirty(index);
     
-    printf("Description [%s]: ", products[index].description);
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = 0;
-    if (strlen(buffer) > 0) {
-        strcpy(products[index].description, buffer);
-    }
-    
-    // Save product data
-    if (saveProductData()) {
+    // Save product data with any other pending changes once they are due
+    if (flushProductChangesIfDue()) {
         displaySuccess("Product updated successfully.");
         return true;
     } else {
@@ -404,8 +316,8 @@ bool editProduct(int id) {
     }
 }
 
-// Function to delete a product
-bool deleteProduct(int id) {
+// Function to remove a product
+bool removeProduct(int id) {
     int index = findProductById(id);
     
     if (index == -1) {
@@ -413,36 +325,25 @@ bool deleteProduct(int id) {
         return false;
     }
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           DELETE PRODUCT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("Are you sure you want to delete the following product?\n");
-    displayProductDetails(&products[index]);
-    
-    printf("\nConfirm deletion (y/n): ");
-    char confirmation;
-    scanf("%c", &confirmation);
-    clearInputBuffer();
-    
-    if (confirmation == 'y' || confirmation == 'Y') {
-        // Remove product by shifting all elements down
-        for (int i = index; i < productCount - 1; i++) {
-            products[i] = products[i + 1];
-        }
+    // Remove product by shifting all elements down
+    for (int i = index; i < productCount - 1; i++) {
+        products[i] = products[i + 1];
         
-        productCount--;
-        
-        // Save product data
-        if (saveProductData()) {
-            displaySuccess("Product deleted successfully.");
-            return true;
-        } else {
-            displayError("Failed to save product data.");
-            return false;
+        if (productDetailsLoaded) {
+            productDetails[i] = productDetails[i + 1];
         }
+    }
+    
+    productCount--;
+    invalidateProductSearchIndexes();
+    markProductLayoutChanged();
+    
+    // Save product data with any other pending changes once they are due
+    if (flushProductChangesIfDue()) {
+        displaySuccess("Product deleted successfully.");
+        return true;
     } else {
-        printf("Deletion cancelled.\n");
+        displayError("Failed to save product data.");
         return false;
     }
 }
@@ -464,9 +365,10 @@ bool updateProductInventory(int id, int quantity) {
     
     // Update quantity
     products[index].quantity += quantity;
+    markProductDirty(index);
     
-    // Save product data
-    if (saveProductData()) {
+    // Only the changed record is written, together with other pending changes once they are due
+    if (flushProductChangesIfDue()) {
         char message[100];
         if (quantity > 0) {
             snprintf(message, sizeof(message), "Added %d units to inventory. New quantity: %d", 
@@ -483,52 +385,525 @@ bool updateProductInventory(int id, int quantity) {
     }
 }
 
-// Function to save product data to file
-bool saveProductData() {
-    FILE *file = fopen(PRODUCT_FILE, "wb");
+// Function to apply a batch of inventory adjustments
+bool applyInventoryAdjustments(const InventoryAdjustment *adjustments, int count) {
+    long long netChange[MAX_ARRAY_SIZE] = {0};
+    char message[100];
+    
+    // Validate the whole batch first, netting repeated products, so nothing changes on error
+    for (int i = 0; i < count; i++) {
+        int index = findProductById(adjustments[i].productId);
+        
+        if (index == -1) {
+            snprintf(message, sizeof(message), "Adjustment %d: product %d not found.", i + 1, adjustments[i].productId);
+            displayError(message);
+            return false;
+        }
+        
+        netChange[index] += adjustments[i].delta;
+    }
+    
+    // Only products the batch changes are checked, so it is not blocked by stock it leaves alone
+    for (int i = 0; i < productCount; i++) {
+        long long newQuantity = products[i].quantity + netChange[i];
+        
+        if (netChange[i] != 0 && (newQuantity < 0 || newQuantity > INT_MAX)) {
+            snprintf(message, sizeof(message), "Product %d: cannot remove more than available quantity.", products[i].id);
+            displayError(message);
+            return false;
+        }
+    }
     
-    if (!file) {
+    // Apply in one pass and persist once
+    ProductBatchUndo undo;
+    int changedCount = 0;
+    
+    beginProductBatch(&undo);
+    
+    for (int i = 0; i < productCount; i++) {
+        if (netChange[i] != 0) {
+            products[i].quantity += (int)netChange[i];
+            markProductDirty(i);
+            changedCount++;
+        }
+    }
+    
+    // A batch that cannot be saved is not kept half-applied in memory
+    if (!flushProductChanges()) {
+        displayError(undoProductBatch(&undo) ? "Failed to save product data. No adjustments were applied." :
+                                               "Failed to save product data.");
         return false;
     }
     
-    // Write the number of products
-    fwrite(&productCount, sizeof(int), 1, file);
+    snprintf(message, sizeof(message), "Applied %d adjustments to %d products.", count, changedCount);
+    displaySuccess(message);
+    return true;
+}
+
+// Function to read inventory adjustments from a stream
+int readInventoryAdjustments(FILE *input, InventoryAdjustment **adjustments) {
+    char line[MAX_STRING_LENGTH * 2];
+    int count = 0;
+    int capacity = 0;
+    int lineNumber = 0;
     
-    // Write the product data
-    fwrite(products, sizeof(Product), productCount, file);
+    *adjustments = NULL;
+    
+    while (fgets(line, sizeof(line), input)) {
+        lineNumber++;
+        
+        // Accept commas, semicolons and tabs as separators
+        for (char *c = line; *c; c++) {
+            if (*c == ',' || *c == ';' || *c == '\t' || *c == '\r' || *c == '\n') {
+                *c = ' ';
+            }
+        }
+        
+        char *start = line;
+        while (*start == ' ') {
+            start++;
+        }
+        
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+        
+        InventoryAdjustment adjustment;
+        char extra;
+        
+        if (sscanf(start, "%d %d %c", &adjustment.productId, &adjustment.delta, &extra) != 2) {
+            // A column header is allowed on the first line
+            if (lineNumber == 1 && isalpha((unsigned char)*start)) {
+                continue;
+            }
+            
+            char message[100];
+            snprintf(message, sizeof(message), "Line %d: expected a product ID and a quantity.", lineNumber);
+            displayError(message);
+            free(*adjustments);
+            *adjustments = NULL;
+            return -1;
+        }
+        
+        if (count == capacity) {
+            int newCapacity = capacity > 0 ? capacity * 2 : 64;
+            InventoryAdjustment *grown = realloc(*adjustments, newCapacity * sizeof(InventoryAdjustment));
+            
+            if (!grown) {
+                displayError("Out of memory reading inventory adjustments.");
+                free(*adjustments);
+                *adjustments = NULL;
+                return -1;
+            }
+            
+            *adjustments = grown;
+            capacity = newCapacity;
+        }
+        
+        (*adjustments)[count++] = adjustment;
+    }
+    
+    return count;
+}
+
+// Function to read a batch of inventory adjustments from a file and apply it
+bool receiveInventoryFromFile(const char *path) {
+    bool useStandardInput = strcmp(path, "-") == 0;
+    FILE *input = useStandardInput ? stdin : fopen(path, "r");
+    
+    if (!input) {
+        displayError("Failed to open inventory file.");
+        return false;
+    }
+    
+    InventoryAdjustment *adjustments;
+    int count = readInventoryAdjustments(input, &adjustments);
+    
+    if (useStandardInput) {
+        clearerr(stdin);
+    } else {
+        fclose(input);
+    }
+    
+    if (count <= 0) {
+        if (count == 0) {
+            displayError("No inventory adjustments found.");
+        }
+        return false;
+    }
+    
+    bool applied = applyInventoryAdjustments(adjustments, count);
     
-    fclose(file);
+    free(adjustments);
+    return applied;
+}
+
+// Function to compute the new prices for a price rule, returning the number of products matched or -1
+static int computeRepricing(const PriceRule *rule, int *slots, double *prices, RepricingSummary *summary) {
+    int count = 0;
+    
+    memset(summary, 0, sizeof(RepricingSummary));
+    
+    // A negative ending means round to the cent; a whole unit or more is not a price ending
+    if (!(rule->priceEnding < 1.0)) {
+        displayError("Price ending must be less than 1 (such as 0.99).");
+        return -1;
+    }
+    
+    // Gather the matching prices into a contiguous column
+    for (int i = 0; i < productCount; i++) {
+        if (rule->categoryId == INVALID_STRING_ID || products[i].categoryId == rule->categoryId) {
+            slots[count] = i;
+            prices[count] = products[i].price;
+            count++;
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        summary->totalBefore += prices[i];
+        summary->stockValueBefore += prices[i] * products[slots[i]].quantity;
+    }
+    
+    // Branch-free passes over the column that the compiler can vectorise
+    double factor = 1.0 + rule->percentChange / 100.0;
+    for (int i = 0; i < count; i++) {
+        prices[i] = prices[i] * factor + rule->amountChange;
+    }
+    
+    if (rule->priceEnding >= 0.0) {
+        for (int i = 0; i < count; i++) {
+            prices[i] = floor(prices[i] - rule->priceEnding + 0.5) + rule->priceEnding;
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            prices[i] = round(prices[i] * 100.0) / 100.0;
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        prices[i] = prices[i] > 0.0 ? prices[i] : 0.0;
+        summary->totalAfter += prices[i];
+        summary->stockValueAfter += prices[i] * products[slots[i]].quantity;
+    }
+    
+    summary->productCount = count;
+    return count;
+}
+
+// Function to work out the effect of a price rule without changing any product
+int previewRepricing(const PriceRule *rule, RepricingSummary *summary) {
+    int slots[MAX_ARRAY_SIZE];
+    double prices[MAX_ARRAY_SIZE];
+    
+    return computeRepricing(rule, slots, prices, summary);
+}
+
+// Function to apply a price rule to every matching product
+bool applyRepricing(const PriceRule *rule, RepricingSummary *summary) {
+    int slots[MAX_ARRAY_SIZE];
+    double prices[MAX_ARRAY_SIZE];
+    RepricingSummary result;
+    
+    int count = computeRepricing(rule, slots, prices, &result);
+    if (summary) {
+        *summary = result;
+    }
+    
+    if (count < 0) {
+        return false;
+    }
+    
+    if (count == 0) {
+        displayError("No products match this category.");
+        return false;
+    }
+    
+    // Write the column back and persist once
+    ProductBatchUndo undo;
+    beginProductBatch(&undo);
+    
+    for (int i = 0; i < count; i++) {
+        if (products[slots[i]].price != prices[i]) {
+            products[slots[i]].price = prices[i];
+            markProductDirty(slots[i]);
+        }
+    }
+    
+    // Prices that cannot be saved are not kept in memory either
+    if (!flushProductChanges()) {
+        displayError(undoProductBatch(&undo) ? "Failed to save product data. No prices were changed." :
+                                               "Failed to save product data.");
+        return false;
+    }
+    
+    char message[100];
+    snprintf(message, sizeof(message), "Repriced %d products.", count);
+    displaySuccess(message);
     return true;
 }
 
-// Function to load product data from file
-bool loadProductData() {
-    FILE *file = fopen(PRODUCT_FILE, "rb");
+// Function to get a product's name
+const char *getProductName(int index) {
+    if (index < 0 || index >= productCount || !loadProductDetails()) {
+        return "";
+    }
+    
+    return productDetails[index].name;
+}
+
+// Function to get a product's description
+const char *getProductDescription(int index) {
+    if (index < 0 || index >= productCount || !loadProductDetails()) {
+        return "";
+    }
+    
+    return productDetails[index].description;
+}
+
+// Function to load product details on first use
+bool loadProductDetails() {
+    if (productDetailsLoaded) {
+        return true;
+    }
+    
+    // Products without a stored entry get blank details
+    for (int i = 0; i < productCount; i++) {
+        memset(&productDetails[i], 0, sizeof(ProductDetails));
+        productDetails[i].id = products[i].id;
+    }
+    
+    MappedDataFile file;
+    
+    if (mapDataFile(PRODUCT_DETAILS_FILE, sizeof(ProductDetails), &file)) {
+        const ProductDetails *stored = (const ProductDetails *)file.payload;
+        int storedCount = (int)file.header->recordCount;
+        
+        // The hot array may have been reordered since the details were written,
+        // so entries are matched by product ID rather than by position. This runs
+        // while a name sort is moving products, so it scans instead of using the ID lookup.
+        for (int i = 0; i < storedCount; i++) {
+            int slot = -1;
+            
+            if (i < productCount && products[i].id == stored[i].id) {
+                slot = i;
+            } else {
+                for (int j = 0; j < productCount && slot == -1; j++) {
+                    if (products[j].id == stored[i].id) {
+                        slot = j;
+                    }
+                }
+            }
+            
+            if (slot != -1) {
+                productDetails[slot] = stored[i];
+            }
+        }
+        
+        unmapDataFile(&file);
+    }
     
-    if (!file) {
-        productCount = 0;
+    productDetailsLoaded = true;
+    return true;
+}
+
+// Function to save product data to file
+bool saveProductData() {
+    // Write the product data
+    if (!writeDataFile(PRODUCT_FILE, sizeof(Product), productCount,
+                       products, productCount * sizeof(Product))) {
+        invalidateDataFileStamp(&productFileStamp);
         return false;
     }
     
-    // Read the number of products
-    fread(&productCount, sizeof(int), 1, file);
+    // Our own save does not make the in-memory copy stale
+    stampDataFile(PRODUCT_FILE, &productFileStamp);
+    rememberStoredProducts();
+    
+    // Everything pending has now been written
+    bool detailsChanged = productDetailsChanged;
+    clearPendingProductChanges();
+    
+    // Save the ID lookup stamped with the generation just written
+    if (!productIdLookup.valid) {
+        rebuildProductIdLookup();
+    }
+    if (productIdLookup.valid) {
+        saveLookupTable(&productIdLookup, PRODUCT_INDEX_FILE, productFileStamp.generation);
+    }
+    
+    // Details never loaded are unchanged on disk, so stock updates skip them
+    if (!productDetailsLoaded) {
+        return true;
+    }
     
-    // Check if the number of products is valid
-    if (productCount < 0 || productCount > MAX_ARRAY_SIZE) {
-        productCount = 0;
-        fclose(file);
+    if (!writeDataFile(PRODUCT_DETAILS_FILE, sizeof(ProductDetails), productCount,
+                       productDetails, productCount * sizeof(ProductDetails))) {
+        productDetailsChanged = detailsChanged;
         return false;
     }
     
-    // Read the product data
-    fread(products, sizeof(Product), productCount, file);
+    return true;
+}
+
+// Function to read the product records from the file again, keeping the per-record changes not yet written
+static bool reloadProductRecords() {
+    // Per-record changes waiting to be written are re-applied to what the file now holds,
+    // so another process's save is not overwritten with our older copy
+    PendingProductChange pending[MAX_ARRAY_SIZE];
+    int pendingCount = collectPendingProductChanges(pending);
+    double pendingSince = oldestPendingChange;
+    
+    // Names and descriptions not yet written are kept aside and matched back by ID
+    ProductDetails keptDetails[MAX_ARRAY_SIZE];
+    int keptDetailsCount = productDetailsChanged ? productCount : 0;
+    memcpy(keptDetails, productDetails, keptDetailsCount * sizeof(ProductDetails));
+    
+    // Stamp before reading: a change made while we read then shows up as a newer file
+    DataFileStamp stamp;
+    stampDataFile(PRODUCT_FILE, &stamp);
     
-    fclose(file);
+    // Copy the product data out of the file, along with any update still in its journal
+    Product loaded[MAX_ARRAY_SIZE];
+    uint32_t loadedCount;
+    
+    if (!readDataFileRecords(PRODUCT_FILE, sizeof(Product), loaded, MAX_ARRAY_SIZE, &loadedCount)) {
+        invalidateDataFileStamp(&productFileStamp);
+        
+        // Keep unsaved changes rather than replacing them with an empty store
+        if (pendingCount == 0) {
+            productCount = 0;
+        }
+        return false;
+    }
+    
+    // Names and descriptions are read again only when something asks for them
+    productDetailsLoaded = false;
+    
+    productCount = (int)loadedCount;
+    memcpy(products, loaded, productCount * sizeof(Product));
+    productFileStamp = stamp;
+    productReloadCount++;
+    rememberStoredProducts();
+    clearPendingProductChanges();
+    invalidateProductSearchIndexes();
+    
+    // Reuse the saved ID lookup if it was built from this version of the file
+    if (!loadLookupTable(&productIdLookup, PRODUCT_INDEX_FILE, productFileStamp.generation) ||
+        productIdLookup.count != productCount) {
+        rebuildProductIdLookup();
+        if (productIdLookup.valid) {
+            saveLookupTable(&productIdLookup, PRODUCT_INDEX_FILE, productFileStamp.generation);
+        }
+    }
+    
+    reapplyPendingProductChanges(pending, pendingCount, pendingSince);
+    
+    if (keptDetailsCount > 0 && loadProductDetails()) {
+        for (int i = 0; i < keptDetailsCount; i++) {
+            int slot = findProductById(keptDetails[i].id);
+            if (slot != -1) {
+                productDetails[slot] = keptDetails[i];
+            }
+        }
+        
+        notePendingChange();
+        productDetailsChanged = true;
+        oldestPendingChange = pendingSince;
+    }
+    
+    return true;
+}
+
+// Function to write pending product changes to file
+bool flushProductChanges() {
+    if (!hasPendingProductChanges()) {
+        return true;
+    }
+    
+    // Products added, removed or reordered since the last save need the whole file rewritten
+    if (productLayoutChanged) {
+        return saveProductData();
+    }
+    
+    // Otherwise only the changed records are written, in place. If the file was saved
+    // elsewhere since it was read, that save is read back and the changes re-applied on top,
+    // which also lines the names up with the file's products before they are written
+    uint64_t oldGeneration = productFileStamp.generation;
+    
+    for (int attempt = 0; dirtyProductCount > 0 || !productFileStamp.valid ||
+         (productDetailsChanged && !isDataFileCurrent(PRODUCT_FILE, &productFileStamp)); attempt++) {
+        if (productFileStamp.valid && dirtyProductCount > 0 &&
+            updateDataFileRecords(PRODUCT_FILE, sizeof(Product), oldGeneration,
+                                  products, productCount, dirtyProducts)) {
+            break;
+        }
+        
+        if (attempt == PRODUCT_FLUSH_ATTEMPTS || !reloadProductRecords()) {
+            return false;
+        }
+        oldGeneration = productFileStamp.generation;
+    }
+    
+    stampDataFile(PRODUCT_FILE, &productFileStamp);
+    rememberStoredProducts();
+    
+    // The records are in the file now, whatever happens to the details
+    memset(dirtyProducts, 0, sizeof(dirtyProducts));
+    dirtyProductCount = 0;
+    
+    // IDs did not move, so the saved ID lookup still describes the file
+    if (!updateIndexFileSource(PRODUCT_INDEX_FILE, oldGeneration, productFileStamp.generation)) {
+        invalidateLookupTable(&productIdLookup);
+    }
+    
+    // Names and descriptions are rare edits, written as a whole file
+    if (productDetailsChanged && productDetailsLoaded &&
+        !writeDataFile(PRODUCT_DETAILS_FILE, sizeof(ProductDetails), productCount,
+                       productDetails, productCount * sizeof(ProductDetails))) {
+        return false;
+    }
+    
+    clearPendingProductChanges();
     return true;
 }
 
+// Function to write pending product changes once the threshold or interval is reached
+bool flushProductChangesIfDue() {
+    if (!hasPendingProductChanges()) {
+        return true;
+    }
+    
+    // Added, removed or reordered products and edited names are written at once; only
+    // per-record changes wait, because those can be re-applied if the file is reloaded
+    if (!productLayoutChanged && !productDetailsChanged &&
+        dirtyProductCount < PRODUCT_FLUSH_THRESHOLD &&
+        getMonotonicMilliseconds() - oldestPendingChange < PRODUCT_FLUSH_INTERVAL_MS) {
+        return true;
+    }
+    
+    return flushProductChanges();
+}
+
+// Function to load product data from file
+bool loadProductData() {
+    // Nothing to do if the file has not changed since it was last read or written
+    if (isDataFileCurrent(PRODUCT_FILE, &productFileStamp)) {
+        return true;
+    }
+    
+    // Layout and name changes are saved as they are made, so they are only still pending
+    // if that save failed; the local copy is then written over the file as it stands
+    if (productLayoutChanged || productDetailsChanged) {
+        return flushProductChanges();
+    }
+    
+    return reloadProductRecords();
+}
+
 // Function to sort products by ID
 void sortProductsById() {
+    invalidateProductSearchIndexes();
+    
     // Selection sort algorithm
     for (int i = 0; i < productCount - 1; i++) {
         int minIndex = i;
@@ -540,35 +915,35 @@ void sortProductsById() {
         }
         
         if (minIndex != i) {
-            Product temp = products[i];
-            products[i] = products[minIndex];
-            products[minIndex] = temp;
+            swapProducts(i, minIndex);
         }
     }
 }
 
 // Function to sort products by name
 void sortProductsByName() {
+    invalidateProductSearchIndexes();
+    
     // Selection sort algorithm
     for (int i = 0; i < productCount - 1; i++) {
         int minIndex = i;
         
         for (int j = i + 1; j < productCount; j++) {
-            if (strcmp(products[j].name, products[minIndex].name) < 0) {
+            if (strcmp(getProductName(j), getProductName(minIndex)) < 0) {
                 minIndex = j;
             }
         }
         
         if (minIndex != i) {
-            Product temp = products[i];
-            products[i] = products[minIndex];
-            products[minIndex] = temp;
+            swapProducts(i, minIndex);
         }
     }
 }
 
 // Function to sort products by price (low to high)
 void sortProductsByPrice() {
+    invalidateProductSearchIndexes();
+    
     // Selection sort algorithm
     for (int i = 0; i < productCount - 1; i++) {
         int minIndex = i;
@@ -580,15 +955,15 @@ void sortProductsByPrice() {
         }
         
         if (minIndex != i) {
-            Product temp = products[i];
-            products[i] = products[minIndex];
-            products[minIndex] = temp;
+            swapProducts(i, minIndex);
         }
     }
 }
 
 // Function to sort products by quantity (high to low)
 void sortProductsByQuantity() {
+    invalidateProductSearchIndexes();
+    
     // Selection sort algorithm
     for (int i = 0; i < productCount - 1; i++) {
         int maxIndex = i;
@@ -600,39 +975,28 @@ void sortProductsByQuantity() {
         }
         
         if (maxIndex != i) {
-            Product temp = products[i];
-            products[i] = products[maxIndex];
-            products[maxIndex] = temp;
+            swapProducts(i, maxIndex);
         }
     }
 }
 
 // Function to get product categories
-int getProductCategories(char categories[][30], int maxCategories) {
+int getProductCategories(uint32_t *categoryIds, int maxCategories) {
+    bool used[MAX_DICTIONARY_SIZE] = {false};
     int count = 0;
     
-    if (productCount == 0) {
-        return 0;
+    // Mark the categories in use, comparing dictionary IDs rather than strings
+    for (int i = 0; i < productCount; i++) {
+        if (products[i].categoryId < MAX_DICTIONARY_SIZE) {
+            used[products[i].categoryId] = true;
+        }
     }
     
-    // Add first category
-    strcpy(categories[count++], products[0].category);
-    
-    // Check all products
-    for (int i = 1; i < productCount && count < maxCategories; i++) {
-        bool exists = false;
-        
-        // Check if category already exists
-        for (int j = 0; j < count; j++) {
-            if (strcmp(products[i].category, categories[j]) == 0) {
-                exists = true;
-                break;
-            }
-        }
-        
-        // Add new category
-        if (!exists) {
-            strcpy(categories[count++], products[i].category);
+    // List them in dictionary order
+    int dictionarySize = getDictionarySize();
+    for (uint32_t id = 0; id < (uint32_t)dictionarySize && count < maxCategories; id++) {
+        if (used[id]) {
+            categoryIds[count++] = id;
         }
     }
     
@@ -641,6 +1005,21 @@ int getProductCategories(char categories[][30], int maxCategories) {
 
 // Function to find a product by ID
 int findProductById(int id) {
+    if (!productIdLookup.valid) {
+        rebuildProductIdLookup();
+    }
+    
+    // Binary search the ID lookup, falling back to a scan if it could not be built
+    if (productIdLookup.valid) {
+        int position = findLookupLowerBound(&productIdLookup, id);
+        
+        if (position < productIdLookup.count && productIdLookup.entries[position].key == id) {
+            return productIdLookup.entries[position].slot;
+        }
+        
+        return -1; // Not found
+    }
+    
     for (int i = 0; i < productCount; i++) {
         if (products[i].id == id) {
             return i;
@@ -653,7 +1032,7 @@ int findProductById(int id) {
 // Function to find a product by name
 int findProductByName(const char *name) {
     for (int i = 0; i < productCount; i++) {
-        if (strcmp(products[i].name, name) == 0) {
+        if (strcmp(getProductName(i), name) == 0) {
             return i;
         }
     }
@@ -661,19 +1040,38 @@ int findProductByName(const char *name) {
     return -1; // Not found
 }
 
-// Function to check if any products are low in stock
-int checkLowStock(int threshold) {
+// Function to find the products whose name or description contains a search term
+int searchProducts(const char *query, bool *matches) {
+    memset(matches, 0, productCount * sizeof(bool));
+    
+    // Case-insensitive substring search over names and descriptions
+    int found = searchTrigramIndex(&productNameIndex, productCount, getProductNameText, query, matches);
+    found += searchTrigramIndex(&productDescriptionIndex, productCount, getProductDescriptionText, query, matches);
+    
+    return found;
+}
+
+// Function to find the products in a category
+int findProductsByCategory(const char *category, int *slots) {
+    uint32_t categoryId = findStringId(category);
     int count = 0;
     
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m           LOW STOCK REPORT\033[0m\n");
-    printf("\033[1;36m========================================\033[0m\n");
+    for (int i = 0; i < productCount; i++) {
+        if (products[i].categoryId == categoryId) {
+            slots[count++] = i;
+        }
+    }
+    
+    return count;
+}
+
+// Function to find the products at or below a stock threshold
+int findLowStockProducts(int threshold, int *slots) {
+    int count = 0;
     
     for (int i = 0; i < productCount; i++) {
         if (products[i].quantity <= threshold) {
-            printf("ID: %d, Name: %s, Current Stock: %d\n", 
-                   products[i].id, products[i].name, products[i].quantity);
-            count++;
+            slots[count++] = i;
         }
     }
     
@@ -0,0 +1,519 @@
+/**
+ * Product Menu Implementation File
+ * Contains the product management screens and prompts built on the product module
+ */
+
+#include "menu.h"
+#include "product.h"
+#include "dictionary.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "globals.h"
+
+// Function to run the product management module
+void runProductManagement() {
+    int choice;
+    bool running = true;
+    
+    // Load product data
+    loadProductData();
+    
+    while (running) {
+        // Write inventory changes that have waited long enough
+        flushProductChangesIfDue();
+        
+        clearScreen();
+        printf("\n\033[1;36m========================================\033[0m\n");
+        printf("\033[1;32m        PRODUCT MANAGEMENT\033[0m\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("1. Add Product\n");
+        printf("2. View All Products\n");
+        printf("3. Search Product by ID\n");
+        printf("4. Search Products by Name\n");
+        printf("5. Filter Products by Category\n");
+        printf("6. Manage Inventory\n");
+        printf("7. Edit Product\n");
+        printf("8. Delete Product\n");
+        printf("9. Check Low Stock\n");
+        printf("10. Receive Inventory from File\n");
+        printf("11. Bulk Reprice by Category\n");
+        printf("12. Back to Main Menu\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        clearInputBuffer();
+        
+        switch (choice) {
+            case 1:
+                addProduct();
+                pressEnterToContinue();
+                break;
+            case 2:
+                displayAllProducts();
+                pressEnterToContinue();
+                break;
+            case 3: {
+                int id;
+                printf("Enter product ID to search: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                searchProductById(id);
+                pressEnterToContinue();
+                break;
+            }
+            case 4: {
+                char name[MAX_STRING_LENGTH];
+                printf("Enter product name or description (or part of it) to search: ");
+                fgets(name, sizeof(name), stdin);
+                name[strcspn(name, "\n")] = 0; // Remove newline character
+                searchProductsByName(name);
+                pressEnterToContinue();
+                break;
+            }
+            case 5: {
+                // Get all unique categories
+                uint32_t categoryIds[MAX_DICTIONARY_SIZE];
+                int numCategories = getProductCategories(categoryIds, MAX_DICTIONARY_SIZE);
+                
+                if (numCategories > 0) {
+                    printf("\nAvailable Categories:\n");
+                    for (int i = 0; i < numCategories; i++) {
+                        printf("%d. %s\n", i + 1, lookupString(categoryIds[i]));
+                    }
+                    
+                    int categoryChoice;
+                    printf("\nSelect a category (1-%d): ", numCategories);
+                    scanf("%d", &categoryChoice);
+                    clearInputBuffer();
+                    
+                    if (categoryChoice >= 1 && categoryChoice <= numCategories) {
+                        displayProductsByCategory(lookupString(categoryIds[categoryChoice - 1]));
+                    } else {
+                        printf("Invalid category selection.\n");
+                    }
+                } else {
+                    printf("No categories found.\n");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 6: {
+                int id, quantity;
+                printf("Enter product ID to update inventory: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                
+                int index = findProductById(id);
+                if (index != -1) {
+                    printf("Current stock for %s: %d\n", getProductName(index), products[index].quantity);
+                    printf("Enter quantity to add (positive) or remove (negative): ");
+                    scanf("%d", &quantity);
+                    clearInputBuffer();
+                    
+                    updateProductInventory(id, quantity);
+                } else {
+                    displayError("Product not found.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 7: {
+                int id;
+                printf("Enter product ID to edit: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                editProduct(id);
+                pressEnterToContinue();
+                break;
+            }
+            case 8: {
+                int id;
+                printf("Enter product ID to delete: ");
+                scanf("%d", &id);
+                clearInputBuffer();
+                deleteProduct(id);
+                pressEnterToContinue();
+                break;
+            }
+            case 9: {
+                int threshold;
+                printf("Enter low stock threshold: ");
+                scanf("%d", &threshold);
+                clearInputBuffer();
+                
+                int lowStockCount = checkLowStock(threshold);
+                if (lowStockCount > 0) {
+                    printf("\n\033[1;33mWarning: %d products are below the threshold of %d units.\033[0m\n", 
+                           lowStockCount, threshold);
+                } else {
+                    printf("\n\033[1;32mAll products are above the threshold of %d units.\033[0m\n", threshold);
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 10: {
+                char path[260];
+                printf("Enter file of product ID,quantity lines (or - to type them, then end input with Ctrl-D): ");
+                fgets(path, sizeof(path), stdin);
+                path[strcspn(path, "\n")] = 0;
+                
+                if (strlen(path) > 0) {
+                    receiveInventoryFromFile(path);
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 11: {
+                PriceRule rule;
+                char buffer[MAX_STRING_LENGTH];
+                
+                // Pick a category, or every product
+                uint32_t categoryIds[MAX_DICTIONARY_SIZE];
+                int numCategories = getProductCategories(categoryIds, MAX_DICTIONARY_SIZE);
+                
+                printf("\nAvailable Categories:\n");
+                printf("0. All products\n");
+                for (int i = 0; i < numCategories; i++) {
+                    printf("%d. %s\n", i + 1, lookupString(categoryIds[i]));
+                }
+                
+                int categoryChoice;
+                printf("\nSelect a category (0-%d): ", numCategories);
+                scanf("%d", &categoryChoice);
+                clearInputBuffer();
+                
+                if (categoryChoice < 0 || categoryChoice > numCategories) {
+                    printf("Invalid category selection.\n");
+                    pressEnterToContinue();
+                    break;
+                }
+                rule.categoryId = categoryChoice == 0 ? INVALID_STRING_ID : categoryIds[categoryChoice - 1];
+                
+                printf("Enter percentage change (e.g. 4 or -10): ");
+                fgets(buffer, sizeof(buffer), stdin);
+                rule.percentChange = atof(buffer);
+                
+                printf("Enter fixed amount to add (leave blank for none): ");
+                fgets(buffer, sizeof(buffer), stdin);
+                rule.amountChange = atof(buffer);
+                
+                printf("Round to prices ending in (e.g. .99, leave blank to round to the cent): ");
+                fgets(buffer, sizeof(buffer), stdin);
+                buffer[strcspn(buffer, "\n")] = 0;
+                rule.priceEnding = strlen(buffer) > 0 ? atof(buffer) : -1.0;
+                
+                if (strlen(buffer) > 0 && !(rule.priceEnding >= 0.0 && rule.priceEnding < 1.0)) {
+                    printf("Price ending must be from 0 up to 0.99.\n");
+                    pressEnterToContinue();
+                    break;
+                }
+                
+                // Show the effect before changing anything
+                RepricingSummary summary;
+                int matched = previewRepricing(&rule, &summary);
+                if (matched <= 0) {
+                    if (matched == 0) {
+                        printf("No products match this category.\n");
+                    }
+                    pressEnterToContinue();
+                    break;
+                }
+                
+                printf("\n%-20s %12s %12s\n", "", "Before", "After");
+                printf("%-20s $%11.2f $%11.2f\n", "Sum of prices", summary.totalBefore, summary.totalAfter);
+                printf("%-20s $%11.2f $%11.2f\n", "Stock value", summary.stockValueBefore, summary.stockValueAfter);
+                printf("Products affected: %d\n", summary.productCount);
+                
+                printf("\nApply these prices? (y/n): ");
+                char confirmation;
+                scanf("%c", &confirmation);
+                clearInputBuffer();
+                
+                if (confirmation == 'y' || confirmation == 'Y') {
+                    applyRepricing(&rule, NULL);
+                } else {
+                    printf("Repricing cancelled.\n");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 12:
+                running = false;
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+                pressEnterToContinue();
+        }
+    }
+}
+
+// Function to add a new product
+bool addProduct() {
+    if (productCount >= MAX_ARRAY_SIZE) {
+        displayError("Product database is full. Cannot add more products.");
+        return false;
+    }
+    
+    Product newProduct;
+    ProductDetails newDetails;
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           ADD NEW PRODUCT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Enter ID: ");
+    scanf("%d", &newProduct.id);
+    clearInputBuffer();
+    
+    // Check if ID already exists
+    if (findProductById(newProduct.id) != -1) {
+        displayError("A product with this ID already exists.");
+        return false;
+    }
+    
+    newDetails.id = newProduct.id;
+    
+    printf("Enter Name: ");
+    fgets(newDetails.name, sizeof(newDetails.name), stdin);
+    newDetails.name[strcspn(newDetails.name, "\n")] = 0; // Remove newline character
+    
+    printf("Enter Price: ");
+    scanf("%lf", &newProduct.price);
+    clearInputBuffer();
+    
+    printf("Enter Quantity: ");
+    scanf("%d", &newProduct.quantity);
+    clearInputBuffer();
+    
+    char category[DICTIONARY_STRING_LENGTH];
+    printf("Enter Category: ");
+    fgets(category, sizeof(category), stdin);
+    category[strcspn(category, "\n")] = 0;
+    newProduct.categoryId = internString(category);
+    
+    printf("Enter Description: ");
+    fgets(newDetails.description, sizeof(newDetails.description), stdin);
+    newDetails.description[strcspn(newDetails.description, "\n")] = 0;
+    
+    // Add the product in ID order and save product data
+    if (appendProducts(&newProduct, &newDetails, 1)) {
+        displaySuccess("Product added successfully.");
+        return true;
+    } else {
+        displayError("Failed to save product data.");
+        return false;
+    }
+}
+
+// Function to search for a product by ID
+bool searchProductById(int id) {
+    int index = findProductById(id);
+    
+    if (index != -1) {
+        printf("\n\033[1;36m========================================\033[0m\n");
+        printf("\033[1;32m            PRODUCT FOUND\033[0m\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        displayProductDetails(&products[index]);
+        return true;
+    } else {
+        displayError("Product not found.");
+        return false;
+    }
+}
+
+// Function to search for products by name
+void searchProductsByName(const char *name) {
+    bool matches[MAX_ARRAY_SIZE] = {false};
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           SEARCH RESULTS\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    int found = searchProducts(name, matches);
+    
+    for (int i = 0; i < productCount; i++) {
+        if (matches[i]) {
+            displayProductDetails(&products[i]);
+            printf("-------------------\n");
+        }
+    }
+    
+    if (found == 0) {
+        printf("No products found matching '%s'.\n", name);
+    }
+}
+
+// Function to search for products by category
+void searchProductsByCategory(const char *category) {
+    displayProductsByCategory(category);
+}
+
+// Function to display all products
+void displayAllProducts() {
+    if (productCount == 0) {
+        printf("No products in the database.\n");
+        return;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           ALL PRODUCTS\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    for (int i = 0; i < productCount; i++) {
+        displayProductDetails(&products[i]);
+        printf("-------------------\n");
+    }
+}
+
+// Function to display products filtered by category
+void displayProductsByCategory(const char *category) {
+    int slots[MAX_ARRAY_SIZE];
+    int found = findProductsByCategory(category, slots);
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m         PRODUCTS IN CATEGORY: %s\033[0m\n", category);
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    for (int i = 0; i < found; i++) {
+        displayProductDetails(&products[slots[i]]);
+        printf("-------------------\n");
+    }
+    
+    if (found == 0) {
+        printf("No products found in category '%s'.\n", category);
+    }
+}
+
+// Function to display details for a specific product
+void displayProductDetails(const Product *product) {
+    int index = (int)(product - products);
+    
+    printf("ID: %d\n", product->id);
+    printf("Name: %s\n", getProductName(index));
+    printf("Price: $%.2f\n", product->price);
+    printf("Quantity: %d\n", product->quantity);
+    printf("Category: %s\n", lookupString(product->categoryId));
+    printf("Description: %s\n", getProductDescription(index));
+    
+    // Highlight low stock
+    if (product->quantity <= 5 && product->quantity > 0) {
+        printf("\033[1;33mLow Stock!\033[0m\n");
+    } else if (product->quantity == 0) {
+        printf("\033[1;31mOut of Stock!\033[0m\n");
+    }
+}
+
+// Function to edit a product's information
+bool editProduct(int id) {
+    int index = findProductById(id);
+    
+    if (index == -1) {
+        displayError("Product not found.");
+        return false;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           EDIT PRODUCT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Editing product with ID: %d\n", id);
+    printf("Current details:\n");
+    displayProductDetails(&products[index]);
+    
+    printf("\nEnter new details (leave blank to keep current):\n");
+    
+    // Start from the current values and replace those the user types
+    Product product = products[index];
+    ProductDetails details;
+    details.id = id;
+    safeStringCopy(details.name, sizeof(details.name), getProductName(index));
+    safeStringCopy(details.description, sizeof(details.description), getProductDescription(index));
+    
+    char buffer[MAX_STRING_LENGTH];
+    
+    printf("Name [%s]: ", getProductName(index));
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        strcpy(details.name, buffer);
+    }
+    
+    printf("Price [%.2f]: ", products[index].price);
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        product.price = atof(buffer);
+    }
+    
+    printf("Quantity [%d]: ", products[index].quantity);
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        product.quantity = atoi(buffer);
+    }
+    
+    printf("Category [%s]: ", lookupString(products[index].categoryId));
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        product.categoryId = internString(buffer);
+    }
+    
+    printf("Description [%s]: ", getProductDescription(index));
+    fgets(buffer, sizeof(buffer), stdin);
+    buffer[strcspn(buffer, "\n")] = 0;
+    if (strlen(buffer) > 0) {
+        strcpy(details.description, buffer);
+    }
+    
+    return updateProduct(id, &product, &details);
+}
+
+// Function to delete a product
+bool deleteProduct(int id) {
+    int index = findProductById(id);
+    
+    if (index == -1) {
+        displayError("Product not found.");
+        return false;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           DELETE PRODUCT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Are you sure you want to delete the following product?\n");
+    displayProductDetails(&products[index]);
+    
+    printf("\nConfirm deletion (y/n): ");
+    char confirmation;
+    scanf("%c", &confirmation);
+    clearInputBuffer();
+    
+    if (confirmation == 'y' || confirmation == 'Y') {
+        return removeProduct(id);
+    } else {
+        printf("Deletion cancelled.\n");
+        return false;
+    }
+}
+
+// Function to check if any products are low in stock
+int checkLowStock(int threshold) {
+    int slots[MAX_ARRAY_SIZE];
+    int count = findLowStockProducts(threshold, slots);
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m           LOW STOCK REPORT\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    for (int i = 0; i < count; i++) {
+        printf("ID: %d, Name: %s, Current Stock: %d\n", 
+               products[slots[i]].id, getProductName(slots[i]), products[slots[i]].quantity);
+    }
+    
+    return count;
+}
\ No newline at end of file
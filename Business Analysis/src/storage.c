@@ -0,0 +1,707 @@
+/**
+ * Storage Implementation File
+ * Contains implementations of data file writing and memory-mapped reading
+ */
+
+#include "storage.h"
+#include "compression.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+_Static_assert(sizeof(DataFileHeader) == DATA_FILE_HEADER_SIZE, "data file header must be 64 bytes");
+
+// Function to check that a header is a data file header this program can read
+static bool isKnownDataFileHeader(const DataFileHeader *header) {
+    return header->magic == DATA_FILE_MAGIC &&
+           header->version >= DATA_FILE_OLDEST_VERSION && header->version <= DATA_FILE_VERSION;
+}
+
+// Function to check that a mapped header describes the expected records
+static bool validateDataFileHeader(const DataFileHeader *header, size_t fileSize, uint32_t recordSize) {
+    if (!isKnownDataFileHeader(header) ||
+        header->recordSize != recordSize) {
+        return false;
+    }
+    
+    // A compressed payload only has its stored bytes on disk
+    uint64_t storedSize = header->storedSize != 0 ? header->storedSize : header->payloadSize;
+    if (storedSize > fileSize - DATA_FILE_HEADER_SIZE) {
+        return false;
+    }
+    
+    // Fixed-size records must all fit in the payload
+    if (recordSize != DATA_FILE_ENCODED &&
+        (uint64_t)header->recordCount * recordSize > header->payloadSize) {
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to map a whole file read-only, failing if it is smaller than the given size
+static bool mapFileBytes(const char *path, size_t minimumSize, MappedDataFile *file) {
+    memset(file, 0, sizeof(MappedDataFile));
+    
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart < (LONGLONG)minimumSize) {
+        CloseHandle(fileHandle);
+        return false;
+    }
+    
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mappingHandle) {
+        CloseHandle(fileHandle);
+        return false;
+    }
+    
+    void *base = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!base) {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+    
+    file->base = base;
+    file->size = (size_t)fileSize.QuadPart;
+    file->fileHandle = fileHandle;
+    file->mappingHandle = mappingHandle;
+#else
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(descriptor, &st) != 0 || st.st_size < (off_t)minimumSize) {
+        close(descriptor);
+        return false;
+    }
+    
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    
+    // The mapping stays valid after the descriptor is closed
+    close(descriptor);
+    
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    
+    file->base = base;
+    file->size = (size_t)st.st_size;
+#endif
+    
+    return true;
+}
+
+// Function to map a data file read-only
+bool mapDataFile(const char *path, uint32_t recordSize, MappedDataFile *file) {
+    if (!mapFileBytes(path, DATA_FILE_HEADER_SIZE, file)) {
+        return false;
+    }
+    
+    file->header = (const DataFileHeader *)file->base;
+    
+    if (!validateDataFileHeader(file->header, file->size, recordSize)) {
+        unmapDataFile(file);
+        return false;
+    }
+    
+    file->payload = (const unsigned char *)file->base + DATA_FILE_HEADER_SIZE;
+    file->payloadSize = (size_t)file->header->payloadSize;
+    
+    // Decompress straight from the mapping into a private buffer
+    if (file->header->storedSize != 0) {
+        unsigned char *decoded = malloc(file->payloadSize > 0 ? file->payloadSize : 1);
+        
+        if (!decoded || !decompressBlock(file->payload, (size_t)file->header->storedSize,
+                                         decoded, file->payloadSize)) {
+            free(decoded);
+            unmapDataFile(file);
+            return false;
+        }
+        
+        file->decodedPayload = decoded;
+        file->payload = decoded;
+    }
+    
+    return true;
+}
+
+// Function to map a file that has no data file header, such as a CSV file
+bool mapTextFile(const char *path, MappedDataFile *file) {
+    // An empty file cannot be mapped, but is still a valid (empty) input
+    struct stat st;
+    if (stat(path, &st) == 0 && st.st_size == 0) {
+        memset(file, 0, sizeof(MappedDataFile));
+        file->payload = (const unsigned char *)"";
+        return true;
+    }
+    
+    if (!mapFileBytes(path, 1, file)) {
+        return false;
+    }
+    
+    file->payload = (const unsigned char *)file->base;
+    file->payloadSize = file->size;
+    return true;
+}
+
+// Function to check whether a mapped data file was stored compressed
+bool isDataFileCompressed(const MappedDataFile *file) {
+    return file->decodedPayload != NULL;
+}
+
+// Function to release a mapped data file
+void unmapDataFile(MappedDataFile *file) {
+    if (!file->base) {
+        return;
+    }
+    
+#ifdef _WIN32
+    UnmapViewOfFile(file->base);
+    CloseHandle((HANDLE)file->mappingHandle);
+    CloseHandle((HANDLE)file->fileHandle);
+#else
+    munmap(file->base, file->size);
+#endif
+    
+    free(file->decodedPayload);
+    memset(file, 0, sizeof(MappedDataFile));
+}
+
+// Function to read the generation number of a data file
+uint64_t readDataFileGeneration(const char *path) {
+    FILE *file = fopen(path, "rb");
+    DataFileHeader header;
+    
+    if (!file) {
+        return 0;
+    }
+    
+    bool valid = fread(&header, sizeof(DataFileHeader), 1, file) == 1 && isKnownDataFileHeader(&header);
+    
+    fclose(file);
+    return valid ? header.generation : 0;
+}
+
+// Function to get the path of a data file's journal
+static void getJournalPath(const char *path, char *journalPath, size_t size) {
+    snprintf(journalPath, size, "%s%s", path, DATA_FILE_JOURNAL_SUFFIX);
+}
+
+// Function to check that the file a save would replace is missing, empty or a data file
+// this program understands, and read its generation
+static bool readReplaceableGeneration(const char *path, uint64_t *generation) {
+    FILE *file = fopen(path, "rb");
+    DataFileHeader header;
+    
+    *generation = 0;
+    if (!file) {
+        return true;
+    }
+    
+    size_t headerBytes = fread(&header, 1, sizeof(DataFileHeader), file);
+    fclose(file);
+    
+    if (headerBytes == 0) {
+        return true;
+    }
+    
+    // A newer program's file (or anything else) would be lost if it were overwritten
+    if (headerBytes != sizeof(DataFileHeader) || !isKnownDataFileHeader(&header)) {
+        char message[400];
+        snprintf(message, sizeof(message),
+                 "%s is not in a format this version of the program understands; it was left unchanged.", path);
+        displayError(message);
+        return false;
+    }
+    
+    *generation = header.generation;
+    return true;
+}
+
+// Function to build a temporary name for a file that no other process will use
+bool makeTemporaryPath(const char *path, char *temporaryPath, size_t size) {
+#ifdef _WIN32
+    unsigned long processId = (unsigned long)GetCurrentProcessId();
+#else
+    unsigned long processId = (unsigned long)getpid();
+#endif
+    
+    int length = snprintf(temporaryPath, size, "%s.%lu.tmp", path, processId);
+    return length > 0 && (size_t)length < size;
+}
+
+// Function to move a finished temporary file over its final path
+bool moveFileIntoPlace(const char *temporaryPath, const char *path) {
+#ifdef _WIN32
+    if (!MoveFileExA(temporaryPath, path, MOVEFILE_REPLACE_EXISTING)) {
+        remove(temporaryPath);
+        return false;
+    }
+#else
+    if (rename(temporaryPath, path) != 0) {
+        remove(temporaryPath);
+        return false;
+    }
+#endif
+    
+    return true;
+}
+
+// Function to get the path of a data file's lock file
+static bool getLockPath(const char *path, char *lockPath, size_t size) {
+    int length = snprintf(lockPath, size, "%s%s", path, DATA_FILE_LOCK_SUFFIX);
+    return length > 0 && (size_t)length < size;
+}
+
+// Function to take a data file's lock, waiting while another process holds it
+bool lockDataFile(const char *path) {
+    char lockPath[280];
+    if (!getLockPath(path, lockPath, sizeof(lockPath))) {
+        return false;
+    }
+    
+    for (int waited = 0; waited <= DATA_FILE_LOCK_WAIT_MILLISECONDS; waited += 10) {
+        // Creating the file fails if it already exists, so only one process gets it
+#ifdef _WIN32
+        HANDLE lockHandle = CreateFileA(lockPath, GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (lockHandle != INVALID_HANDLE_VALUE) {
+            CloseHandle(lockHandle);
+            return true;
+        }
+        if (GetLastError() != ERROR_FILE_EXISTS) {
+            return false;
+        }
+#else
+        int lockFile = open(lockPath, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (lockFile != -1) {
+            close(lockFile);
+            return true;
+        }
+        if (errno != EEXIST) {
+            return false;
+        }
+#endif
+        
+        // A lock this old was left by a run that died while holding it
+        struct stat info;
+        if (stat(lockPath, &info) == 0 && time(NULL) - info.st_mtime > DATA_FILE_LOCK_STALE_SECONDS) {
+            remove(lockPath);
+            continue;
+        }
+        
+#ifdef _WIN32
+        Sleep(10);
+#else
+        struct timespec pause = { 0, 10 * 1000000L };
+        nanosleep(&pause, NULL);
+#endif
+    }
+    
+    return false;
+}
+
+// Function to release a data file's lock
+void unlockDataFile(const char *path) {
+    char lockPath[280];
+    if (getLockPath(path, lockPath, sizeof(lockPath))) {
+        remove(lockPath);
+    }
+}
+
+// Function to write a file with a header and move it into place
+// A non-zero storedSize means the payload holds that many compressed bytes
+static bool writeFileWithHeader(const char *path, uint64_t sourceGeneration, uint32_t recordSize,
+                                uint32_t recordCount, const void *payload, size_t payloadSize,
+                                size_t storedSize) {
+    char temporaryPath[280];
+    if (!makeTemporaryPath(path, temporaryPath, sizeof(temporaryPath))) {
+        return false;
+    }
+    
+    uint64_t generation;
+    if (!readReplaceableGeneration(path, &generation)) {
+        return false;
+    }
+    
+    DataFileHeader header;
+    memset(&header, 0, sizeof(DataFileHeader));
+    header.magic = DATA_FILE_MAGIC;
+    header.version = DATA_FILE_VERSION;
+    header.recordSize = recordSize;
+    header.recordCount = recordCount;
+    header.payloadSize = payloadSize;
+    header.generation = generation + 1;
+    header.sourceGeneration = sourceGeneration;
+    header.storedSize = storedSize;
+    
+    size_t writeSize = storedSize != 0 ? storedSize : payloadSize;
+    
+    FILE *file = fopen(temporaryPath, "wb");
+    if (!file) {
+        return false;
+    }
+    
+    bool written = fwrite(&header, sizeof(DataFileHeader), 1, file) == 1 &&
+                   (writeSize == 0 || fwrite(payload, 1, writeSize, file) == writeSize);
+    
+    if (fclose(file) != 0 || !written) {
+        remove(temporaryPath);
+        return false;
+    }
+    
+    if (!moveFileIntoPlace(temporaryPath, path)) {
+        return false;
+    }
+    
+    // A journal left by an in-place update describes the file just replaced
+    char journalPath[260];
+    getJournalPath(path, journalPath, sizeof(journalPath));
+    remove(journalPath);
+    
+    return true;
+}
+
+// Function to write a data file and move it into place
+bool writeDataFile(const char *path, uint32_t recordSize, uint32_t recordCount,
+                   const void *payload, size_t payloadSize) {
+    return writeFileWithHeader(path, 0, recordSize, recordCount, payload, payloadSize, 0);
+}
+
+// Function to write a data file with its payload compressed
+bool writeCompressedDataFile(const char *path, uint32_t recordSize, uint32_t recordCount,
+                             const void *payload, size_t payloadSize) {
+    size_t capacity = getCompressBound(payloadSize);
+    unsigned char *compressed = malloc(capacity);
+    
+    if (!compressed) {
+        return false;
+    }
+    
+    // Keep the payload as is if compressing it saves nothing
+    size_t storedSize = compressBlock(payload, payloadSize, compressed, capacity);
+    bool written = storedSize > 0 && storedSize < payloadSize ?
+        writeFileWithHeader(path, 0, recordSize, recordCount, compressed, payloadSize, storedSize) :
+        writeFileWithHeader(path, 0, recordSize, recordCount, payload, payloadSize, 0);
+    
+    free(compressed);
+    return written;
+}
+
+// Function to write an index file tied to a data file generation
+bool writeIndexFile(const char *path, uint64_t sourceGeneration, uint32_t recordSize,
+                    uint32_t recordCount, const void *payload, size_t payloadSize) {
+    return writeFileWithHeader(path, sourceGeneration, recordSize, recordCount, payload, payloadSize, 0);
+}
+
+// Function to map the journal of an in-place update to the given generation of a data file
+// Each journal record is a uint32_t record index followed by the record's new contents
+static bool mapDataFileJournal(const char *path, uint32_t recordSize, uint64_t generation,
+                               MappedDataFile *journal) {
+    char journalPath[260];
+    getJournalPath(path, journalPath, sizeof(journalPath));
+    
+    if (!mapDataFile(journalPath, sizeof(uint32_t) + recordSize, journal)) {
+        return false;
+    }
+    
+    // A journal for another generation belongs to an update that finished or was superseded
+    if (journal->header->sourceGeneration != generation || isDataFileCompressed(journal)) {
+        unmapDataFile(journal);
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to copy the records of a data file into memory
+bool readDataFileRecords(const char *path, uint32_t recordSize, void *records,
+                         uint32_t maxRecords, uint32_t *recordCount) {
+    size_t entrySize = sizeof(uint32_t) + recordSize;
+    
+    // An update that finishes while we copy changes the generation; copy again
+    for (int attempt = 0; attempt < 3; attempt++) {
+        MappedDataFile file;
+        
+        if (!mapDataFile(path, recordSize, &file)) {
+            return false;
+        }
+        
+        uint32_t count = file.header->recordCount;
+        uint64_t generation = file.header->generation;
+        
+        if (count > maxRecords) {
+            unmapDataFile(&file);
+            return false;
+        }
+        
+        memcpy(records, file.payload, (size_t)count * recordSize);
+        unmapDataFile(&file);
+        
+        // Records an update was writing as we copied are taken from its journal
+        MappedDataFile journal;
+        bool valid = true;
+        
+        if (mapDataFileJournal(path, recordSize, generation, &journal)) {
+            for (uint32_t i = 0; i < journal.header->recordCount && valid; i++) {
+                const unsigned char *entry = journal.payload + i * entrySize;
+                uint32_t index;
+                memcpy(&index, entry, sizeof(uint32_t));
+                
+                valid = index < count;
+                if (valid) {
+                    memcpy((unsigned char *)records + (size_t)index * recordSize, entry + sizeof(uint32_t), recordSize);
+                }
+            }
+            unmapDataFile(&journal);
+        }
+        
+        if (!valid) {
+            return false;
+        }
+        
+        if (readDataFileGeneration(path) == generation) {
+            *recordCount = count;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// Function to write a run of records at their place in an open data file
+static bool writeRecordsInPlace(FILE *file, uint32_t recordSize, uint32_t index,
+                                const void *records, uint32_t count) {
+    size_t size = (size_t)count * recordSize;
+    return fseek(file, DATA_FILE_HEADER_SIZE + (long)index * recordSize, SEEK_SET) == 0 &&
+           fwrite(records, 1, size, file) == size;
+}
+
+// Function to finish an in-place update whose journal matches the file's generation
+static bool finishJournaledUpdate(const char *path, FILE *file, DataFileHeader *header) {
+    char journalPath[260];
+    getJournalPath(path, journalPath, sizeof(journalPath));
+    
+    MappedDataFile journal;
+    if (!mapDataFileJournal(path, header->recordSize, header->generation, &journal)) {
+        // Nothing to finish; drop any journal left from an older generation
+        remove(journalPath);
+        return true;
+    }
+    
+    size_t entrySize = sizeof(uint32_t) + header->recordSize;
+    bool written = true;
+    
+    // Writing the journaled records again is harmless if some had already been written
+    for (uint32_t i = 0; i < journal.header->recordCount && written; i++) {
+        const unsigned char *entry = journal.payload + i * entrySize;
+        uint32_t index;
+        memcpy(&index, entry, sizeof(uint32_t));
+        
+        written = index < header->recordCount &&
+                  writeRecordsInPlace(file, header->recordSize, index, entry + sizeof(uint32_t), 1);
+    }
+    
+    unmapDataFile(&journal);
+    
+    header->generation++;
+    written = written && fseek(file, 0, SEEK_SET) == 0 &&
+              fwrite(header, sizeof(DataFileHeader), 1, file) == 1 && fflush(file) == 0;
+    
+    if (written) {
+        remove(journalPath);
+    }
+    return written;
+}
+
+// Function to overwrite changed records of a data file in place
+bool updateDataFileRecords(const char *path, uint32_t recordSize, uint64_t expectedGeneration,
+                           const void *records, uint32_t recordCount, const uint64_t *dirtyBitmap) {
+    FILE *file = fopen(path, "r+b");
+    DataFileHeader header;
+    
+    if (!file) {
+        return false;
+    }
+    
+    // Refuse files that changed shape since we saw them
+    if (fread(&header, sizeof(DataFileHeader), 1, file) != 1 ||
+        !isKnownDataFileHeader(&header) ||
+        header.recordSize != recordSize || header.recordCount != recordCount ||
+        header.storedSize != 0) {
+        fclose(file);
+        return false;
+    }
+    
+    // An update cut short is finished first; it makes the file newer than the caller's copy
+    if (!finishJournaledUpdate(path, file, &header) || header.generation != expectedGeneration) {
+        fclose(file);
+        return false;
+    }
+    
+    // Journal the new records before touching the file, so a crash cannot leave a torn record
+    size_t entrySize = sizeof(uint32_t) + recordSize;
+    uint32_t journalCount = 0;
+    
+    for (uint32_t i = 0; i < recordCount; i++) {
+        if (dirtyBitmap[i / 64] & ((uint64_t)1 << (i % 64))) {
+            journalCount++;
+        }
+    }
+    
+    unsigned char *entries = malloc(journalCount > 0 ? journalCount * entrySize : 1);
+    if (!entries) {
+        fclose(file);
+        return false;
+    }
+    
+    uint32_t entryCount = 0;
+    for (uint32_t i = 0; i < recordCount; i++) {
+        if (dirtyBitmap[i / 64] & ((uint64_t)1 << (i % 64))) {
+            unsigned char *entry = entries + entryCount++ * entrySize;
+            memcpy(entry, &i, sizeof(uint32_t));
+            memcpy(entry + sizeof(uint32_t), (const unsigned char *)records + (size_t)i * recordSize, recordSize);
+        }
+    }
+    
+    char journalPath[260];
+    getJournalPath(path, journalPath, sizeof(journalPath));
+    
+    bool journaled = writeFileWithHeader(journalPath, header.generation, (uint32_t)entrySize, journalCount,
+                                         entries, journalCount * entrySize, 0);
+    free(entries);
+    
+    if (!journaled) {
+        fclose(file);
+        return false;
+    }
+    
+    // Write each run of consecutive dirty records with one seek and one write
+    bool written = true;
+    uint32_t index = 0;
+    
+    while (written && index < recordCount) {
+        if (!(dirtyBitmap[index / 64] & ((uint64_t)1 << (index % 64)))) {
+            index++;
+            continue;
+        }
+        
+        uint32_t runEnd = index + 1;
+        while (runEnd < recordCount && (dirtyBitmap[runEnd / 64] & ((uint64_t)1 << (runEnd % 64)))) {
+            runEnd++;
+        }
+        
+        written = writeRecordsInPlace(file, recordSize, index,
+                                      (const unsigned char *)records + (size_t)index * recordSize, runEnd - index);
+        index = runEnd;
+    }
+    
+    // Bump the generation last so readers notice the change
+    header.generation++;
+    written = written && fseek(file, 0, SEEK_SET) == 0 &&
+              fwrite(&header, sizeof(DataFileHeader), 1, file) == 1;
+    written = fclose(file) == 0 && written;
+    
+    // The journal is only dropped once the update is complete; otherwise the next
+    // read or update finishes it
+    if (written) {
+        remove(journalPath);
+    }
+    return written;
+}
+
+// Function to point an index file at a new generation of its data file
+bool updateIndexFileSource(const char *path, uint64_t oldSourceGeneration, uint64_t newSourceGeneration) {
+    FILE *file = fopen(path, "r+b");
+    DataFileHeader header;
+    
+    if (!file) {
+        return false;
+    }
+    
+    bool updated = fread(&header, sizeof(DataFileHeader), 1, file) == 1 &&
+                   isKnownDataFileHeader(&header) &&
+                   header.sourceGeneration == oldSourceGeneration;
+    
+    if (updated) {
+        header.sourceGeneration = newSourceGeneration;
+        updated = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(DataFileHeader), 1, file) == 1;
+    }
+    
+    return fclose(file) == 0 && updated;
+}
+
+// Function to get a file's modification time as finely as the platform records it
+static long long getModifiedTime(const struct stat *st) {
+    // In-place updates keep the inode and size, so whole seconds are too coarse to tell them apart
+#if defined(__APPLE__)
+    return (long long)st->st_mtimespec.tv_sec * 1000000000LL + st->st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    return (long long)st->st_mtim.tv_sec * 1000000000LL + st->st_mtim.tv_nsec;
+#else
+    return (long long)st->st_mtime * 1000000000LL;
+#endif
+}
+
+// Function to record the current state of a data file
+void stampDataFile(const char *path, DataFileStamp *stamp) {
+    struct stat st;
+    
+    if (stat(path, &st) != 0) {
+        invalidateDataFileStamp(stamp);
+        return;
+    }
+    
+    stamp->valid = true;
+    stamp->modified = getModifiedTime(&st);
+    stamp->size = (long long)st.st_size;
+    stamp->inode = (unsigned long long)st.st_ino;
+    stamp->generation = readDataFileGeneration(path);
+}
+
+// Function to clear a data file stamp
+void invalidateDataFileStamp(DataFileStamp *stamp) {
+    memset(stamp, 0, sizeof(DataFileStamp));
+}
+
+// Function to check whether a data file is unchanged since it was stamped
+bool isDataFileCurrent(const char *path, const DataFileStamp *stamp) {
+    struct stat st;
+    
+    if (!stamp->valid || stat(path, &st) != 0) {
+        return false;
+    }
+    
+    // A different time, size or file means it was replaced or written since
+    if (getModifiedTime(&st) != stamp->modified || (long long)st.st_size != stamp->size ||
+        (unsigned long long)st.st_ino != stamp->inode) {
+        return false;
+    }
+    
+    // The same stat is not enough: on Windows the time has one-second resolution and there is no
+    // inode, so a same-size in-place update within that second looks unchanged; every save bumps
+    // the generation in the header
+    return stamp->generation != 0 && readDataFileGeneration(path) == stamp->generation;
+}
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include "product.h"
 #include "financial.h"
 #include "utils.h"
+#include "index.h"
+#include "csv_writer.h"
+#include "parallel.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,265 +19,6 @@
 #include <stdbool.h>
 #include "globals.h"
 
-// Function to run the trend analysis module
-void runTrendAnalysis() {
-    int choice;
-    bool running = true;
-
-    while (running) {
-        clearScreen();
-        printf("\n\033[1;36m========================================\033[0m\n");
-        printf("\033[1;32m          TREND ANALYSIS\033[0m\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("1. Sales Trends\n");
-        printf("2. Product Sales Analysis\n");
-        printf("3. Category Sales Analysis\n");
-        printf("4. Profit Trends\n");
-        printf("5. Expense Trends\n");
-        printf("6. Sales Forecast\n");
-        printf("7. Back to Main Menu\n");
-        printf("\033[1;36m========================================\033[0m\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        clearInputBuffer();
-
-        switch (choice) {
-            case 1: {
-                char startDate[20], endDate[20], interval[10];
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                printf("Enter interval (daily, weekly, monthly): ");
-                fgets(interval, sizeof(interval), stdin);
-                interval[strcspn(interval, "\n")] = 0;
-                
-                if (generateSalesTrend(startDate, endDate, interval)) {
-                    char title[100], xLabel[50], yLabel[50];
-                    snprintf(title, sizeof(title), "Sales Trend (%s to %s)", startDate, endDate);
-                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
-                    sprintf(yLabel, "Sales Amount ($)");
-                    
-                    printf("Would you like to visualize this trend? (y/n): ");
-                    char visualizeChoice;
-                    scanf("%c", &visualizeChoice);
-                    clearInputBuffer();
-                    
-                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
-                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
-                    }
-                } else {
-                    displayError("Failed to generate sales trend data.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 2: {
-                int productId;
-                char startDate[20], endDate[20], interval[10];
-                
-                printf("Enter product ID (0 for all products): ");
-                scanf("%d", &productId);
-                clearInputBuffer();
-                
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                printf("Enter interval (daily, weekly, monthly): ");
-                fgets(interval, sizeof(interval), stdin);
-                interval[strcspn(interval, "\n")] = 0;
-                
-                if (generateProductSalesTrend(productId, startDate, endDate, interval)) {
-                    char title[100], xLabel[50], yLabel[50];
-                    
-                    if (productId == 0) {
-                        snprintf(title, sizeof(title), "Product Sales Comparison (%s to %s)", startDate, endDate);
-                    } else {
-                        char productName[50] = "Selected Product";
-                        // Get product name if available
-                        loadProductData();
-                        int index = findProductById(productId);
-                        if (index != -1) {
-                            strcpy(productName, products[index].name);
-                        }
-                        snprintf(title, sizeof(title), "%s Sales Trend (%s to %s)", productName, startDate, endDate);
-                    }
-                    
-                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
-                    sprintf(yLabel, "Sales Amount ($)");
-                    
-                    printf("Would you like to visualize this trend? (y/n): ");
-                    char visualizeChoice;
-                    scanf("%c", &visualizeChoice);
-                    clearInputBuffer();
-                    
-                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
-                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
-                    }
-                } else {
-                    displayError("Failed to generate product sales trend data.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 3: {
-                char category[30], startDate[20], endDate[20], interval[10];
-                
-                printf("Enter category (leave blank for all categories): ");
-                fgets(category, sizeof(category), stdin);
-                category[strcspn(category, "\n")] = 0;
-                
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                printf("Enter interval (daily, weekly, monthly): ");
-                fgets(interval, sizeof(interval), stdin);
-                interval[strcspn(interval, "\n")] = 0;
-                
-                if (generateCategorySalesTrend(category, startDate, endDate, interval)) {
-                    char title[100], xLabel[50], yLabel[50];
-                    
-                    if (strlen(category) == 0) {
-                        snprintf(title, sizeof(title), "Category Sales Comparison (%s to %s)", startDate, endDate);
-                    } else {
-                        snprintf(title, sizeof(title), "%s Category Sales Trend (%s to %s)", category, startDate, endDate);
-                    }
-                    
-                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
-                    sprintf(yLabel, "Sales Amount ($)");
-                    
-                    printf("Would you like to visualize this trend? (y/n): ");
-                    char visualizeChoice;
-                    scanf("%c", &visualizeChoice);
-                    clearInputBuffer();
-                    
-                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
-                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
-                    }
-                } else {
-                    displayError("Failed to generate category sales trend data.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 4: {
-                char startDate[20], endDate[20], interval[10];
-                
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                printf("Enter interval (daily, weekly, monthly): ");
-                fgets(interval, sizeof(interval), stdin);
-                interval[strcspn(interval, "\n")] = 0;
-                
-                if (generateProfitTrend(startDate, endDate, interval)) {
-                    char title[100], xLabel[50], yLabel[50];
-                    snprintf(title, sizeof(title), "Profit Trend (%s to %s)", startDate, endDate);
-                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
-                    sprintf(yLabel, "Profit Amount ($)");
-                    
-                    printf("Would you like to visualize this trend? (y/n): ");
-                    char visualizeChoice;
-                    scanf("%c", &visualizeChoice);
-                    clearInputBuffer();
-                    
-                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
-                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
-                    }
-                } else {
-                    displayError("Failed to generate profit trend data.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 5: {
-                char category[30], startDate[20], endDate[20], interval[10];
-                
-                printf("Enter expense category (leave blank for all categories): ");
-                fgets(category, sizeof(category), stdin);
-                category[strcspn(category, "\n")] = 0;
-                
-                printf("Enter start date (YYYY-MM-DD): ");
-                fgets(startDate, sizeof(startDate), stdin);
-                startDate[strcspn(startDate, "\n")] = 0;
-                
-                printf("Enter end date (YYYY-MM-DD): ");
-                fgets(endDate, sizeof(endDate), stdin);
-                endDate[strcspn(endDate, "\n")] = 0;
-                
-                printf("Enter interval (daily, weekly, monthly): ");
-                fgets(interval, sizeof(interval), stdin);
-                interval[strcspn(interval, "\n")] = 0;
-                
-                if (generateExpenseTrend(category, startDate, endDate, interval)) {
-                    char title[100], xLabel[50], yLabel[50];
-                    
-                    if (strlen(category) == 0) {
-                        snprintf(title, sizeof(title), "Expense Trend (%s to %s)", startDate, endDate);
-                    } else {
-                        snprintf(title, sizeof(title), "%s Expense Trend (%s to %s)", category, startDate, endDate);
-                    }
-                    
-                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
-                    sprintf(yLabel, "Expense Amount ($)");
-                    
-                    printf("Would you like to visualize this trend? (y/n): ");
-                    char visualizeChoice;
-                    scanf("%c", &visualizeChoice);
-                    clearInputBuffer();
-                    
-                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
-                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
-                    }
-                } else {
-                    displayError("Failed to generate expense trend data.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 6: {
-                int months;
-                printf("Enter number of months to forecast: ");
-                scanf("%d", &months);
-                clearInputBuffer();
-                
-                if (months > 0) {
-                    generateSalesForecastReport(months);
-                } else {
-                    displayError("Invalid number of months.");
-                }
-                pressEnterToContinue();
-                break;
-            }
-            case 7:
-                running = false;
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-                pressEnterToContinue();
-        }
-    }
-}
-
 // Function to generate sales trend data for visualization
 bool generateSalesTrend(const char *startDate, const char *endDate, const char *interval) {
     if (!startDate || !endDate || !interval) {
@@ -294,19 +38,18 @@ bool generateSalesTrend(const char *startDate, const char *endDate, const char *
     }
     
     // Open file for writing
-    FILE *file = fopen(SALES_DATA_CSV, "w");
-    if (!file) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, SALES_DATA_CSV)) {
         displayError("Failed to open sales data file for writing.");
         return false;
     }
     
     // Write header
-    fprintf(file, "Date,Sales\n");
+    writeCsvRaw(&csv, "Date,Sales\n");
     
     // If no transactions, create an empty file and return
     if (transactionCount == 0) {
-        fclose(file);
-        return true;
+        return closeCsvWriter(&csv);
     }
     
     // Determine date range and step size
@@ -317,12 +60,16 @@ bool generateSalesTrend(const char *startDate, const char *endDate, const char *
         // Filter by date range
         if (strcmp(transactions[i].date, startDate) >= 0 && 
             strcmp(transactions[i].date, endDate) <= 0) {
-            fprintf(file, "%s,%.2f\n", transactions[i].date, transactions[i].total);
+            writeCsvText(&csv, transactions[i].date);
+            writeCsvDecimal(&csv, transactions[i].total, 2);
+            endCsvRow(&csv);
         }
     }
     
-    fclose(file);
-    printf("Sales trend data generated and saved to %s\n", SALES_DATA_CSV);
+    if (!closeCsvWriter(&csv)) {
+        displayError("Failed to write sales data file.");
+        return false;
+    }
     return true;
 }
 
@@ -345,8 +92,8 @@ bool generateProductSalesTrend(int productId, const char *startDate, const char
     }
     
     // Open file for writing
-    FILE *file = fopen(SALES_DATA_CSV, "w");
-    if (!file) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, SALES_DATA_CSV)) {
         displayError("Failed to open sales data file for writing.");
         return false;
     }
@@ -354,17 +101,42 @@ bool generateProductSalesTrend(int productId, const char *startDate, const char
     // Write header
     if (productId == 0) {
         // For all products, we'll include product ID in output
-        fprintf(file, "Date,ProductID,ProductName,Sales\n");
+        writeCsvRaw(&csv, "Date,ProductID,ProductName,Sales\n");
     } else {
-        fprintf(file, "Date,Sales\n");
+        writeCsvRaw(&csv, "Date,Sales\n");
     }
     
     // If no transactions, create an empty file and return
     if (transactionCount == 0) {
-        fclose(file);
+        return closeCsvWriter(&csv);
+    }
+    
+    if (productId != 0) {
+        // Single product: read only that product's postings from the index
+        ProductPostingCursor cursor;
+        int slot, itemOffset;
+        
+        openProductPostings(productId, &cursor);
+        while (nextProductPosting(&cursor, &slot, &itemOffset)) {
+            // Filter by date range
+            if (strcmp(transactions[slot].date, startDate) >= 0 && 
+                strcmp(transactions[slot].date, endDate) <= 0) {
+                writeCsvText(&csv, transactions[slot].date);
+                writeCsvDecimal(&csv, transactions[slot].items[itemOffset].subtotal, 2);
+                endCsvRow(&csv);
+            }
+        }
+        
+        if (!closeCsvWriter(&csv)) {
+            displayError("Failed to write sales data file.");
+            return false;
+        }
         return true;
     }
     
+    // Item names are resolved from the product catalogue
+    loadProductData();
+    
     // Process transactions
     for (int i = 0; i < transactionCount; i++) {
         // Filter by date range
@@ -373,26 +145,19 @@ bool generateProductSalesTrend(int productId, const char *startDate, const char
             
             // Go through items in transaction
             for (int j = 0; j < transactions[i].itemCount; j++) {
-                // Filter by product ID if specified
-                if (productId == 0 || transactions[i].items[j].productId == productId) {
-                    if (productId == 0) {
-                        fprintf(file, "%s,%d,%s,%.2f\n", 
-                               transactions[i].date,
-                               transactions[i].items[j].productId,
-                               transactions[i].items[j].name,
-                               transactions[i].items[j].subtotal);
-                    } else {
-                        fprintf(file, "%s,%.2f\n", 
-                               transactions[i].date,
-                               transactions[i].items[j].subtotal);
-                    }
-                }
+                writeCsvText(&csv, transactions[i].date);
+                writeCsvInt(&csv, transactions[i].items[j].productId);
+                writeCsvText(&csv, getBillingItemName(&transactions[i].items[j]));
+                writeCsvDecimal(&csv, transactions[i].items[j].subtotal, 2);
+                endCsvRow(&csv);
             }
         }
     }
     
-    fclose(file);
-    printf("Product sales trend data generated and saved to %s\n", SALES_DATA_CSV);
+    if (!closeCsvWriter(&csv)) {
+        displayError("Failed to write sales data file.");
+        return false;
+    }
     return true;
 }
 
@@ -415,8 +180,8 @@ bool generateCategorySalesTrend(const char *category, const char *startDate, con
     }
     
     // Open file for writing
-    FILE *file = fopen(SALES_DATA_CSV, "w");
-    if (!file) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, SALES_DATA_CSV)) {
         displayError("Failed to open sales data file for writing.");
         return false;
     }
@@ -424,17 +189,20 @@ bool generateCategorySalesTrend(const char *category, const char *startDate, con
     // Write header
     if (!category || strlen(category) == 0) {
         // For all categories, we'll include category in output
-        fprintf(file, "Date,Category,Sales\n");
+        writeCsvRaw(&csv, "Date,Category,Sales\n");
     } else {
-        fprintf(file, "Date,Sales\n");
+        writeCsvRaw(&csv, "Date,Sales\n");
     }
     
     // If no transactions or products, create an empty file and return
     if (transactionCount == 0 || productCount == 0) {
-        fclose(file);
-        return true;
+        return closeCsvWriter(&csv);
     }
     
+    // Resolve the category filter once and compare IDs
+    bool allCategories = !category || strlen(category) == 0;
+    uint32_t categoryId = allCategories ? INVALID_STRING_ID : findStringId(category);
+    
     // Process transactions
     for (int i = 0; i < transactionCount; i++) {
         // Filter by date range
@@ -448,30 +216,36 @@ bool generateCategorySalesTrend(const char *category, const char *startDate, con
                 
                 if (productIndex != -1) {
                     // Filter by category if specified
-                    if (!category || strlen(category) == 0 || 
-                        strcmp(products[productIndex].category, category) == 0) {
+                    if (allCategories || products[productIndex].categoryId == categoryId) {
                         
-                        if (!category || strlen(category) == 0) {
-                            fprintf(file, "%s,%s,%.2f\n", 
-                                   transactions[i].date,
-                                   products[productIndex].category,
-                                   transactions[i].items[j].subtotal);
-                        } else {
-                            fprintf(file, "%s,%.2f\n", 
-                                   transactions[i].date,
-                                   transactions[i].items[j].subtotal);
+                        writeCsvText(&csv, transactions[i].date);
+                        if (allCategories) {
+                            writeCsvText(&csv, lookupString(products[productIndex].categoryId));
                         }
+                        writeCsvDecimal(&csv, transactions[i].items[j].subtotal, 2);
+                        endCsvRow(&csv);
                     }
                 }
             }
         }
     }
     
-    fclose(file);
-    printf("Category sales trend data generated and saved to %s\n", SALES_DATA_CSV);
+    if (!closeCsvWriter(&csv)) {
+        displayError("Failed to write sales data file.");
+        return false;
+    }
     return true;
 }
 
+// Function to write one day of the profit trend
+static void writeProfitTrendRow(CsvWriter *csv, const char *date, double income, double expenses) {
+    writeCsvText(csv, date);
+    writeCsvDecimal(csv, income, 2);
+    writeCsvDecimal(csv, expenses, 2);
+    writeCsvDecimal(csv, income - expenses, 2);
+    endCsvRow(csv);
+}
+
 // Function to generate profit trend data for visualization
 bool generateProfitTrend(const char *startDate, const char *endDate, const char *interval) {
     if (!startDate || !endDate || !interval) {
@@ -491,19 +265,18 @@ bool generateProfitTrend(const char *startDate, const char *endDate, const char
     }
     
     // Open file for writing
-    FILE *file = fopen(SALES_DATA_CSV, "w");
-    if (!file) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, SALES_DATA_CSV)) {
         displayError("Failed to open sales data file for writing.");
         return false;
     }
     
     // Write header
-    fprintf(file, "Date,Income,Expenses,Profit\n");
+    writeCsvRaw(&csv, "Date,Income,Expenses,Profit\n");
     
     // If no financial records, create an empty file and return
     if (financialRecordCount == 0) {
-        fclose(file);
-        return true;
+        return closeCsvWriter(&csv);
     }
     
     // Process financial records by date
@@ -523,8 +296,7 @@ bool generateProfitTrend(const char *startDate, const char *endDate, const char
             if (strcmp(currentDate, financialRecords[i].date) != 0) {
                 // Output previous date's data if it's not the first entry
                 if (strlen(currentDate) > 0) {
-                    fprintf(file, "%s,%.2f,%.2f,%.2f\n", 
-                           currentDate, dayIncome, dayExpenses, dayIncome - dayExpenses);
+                    writeProfitTrendRow(&csv, currentDate, dayIncome, dayExpenses);
                 }
                 
                 // Reset for new date
@@ -534,9 +306,9 @@ bool generateProfitTrend(const char *startDate, const char *endDate, const char
             }
             
             // Add to the appropriate counter
-            if (strcmp(financialRecords[i].type, "Income") == 0) {
+            if (financialRecords[i].typeId == STRING_ID_INCOME) {
                 dayIncome += financialRecords[i].amount;
-            } else if (strcmp(financialRecords[i].type, "Expense") == 0) {
+            } else if (financialRecords[i].typeId == STRING_ID_EXPENSE) {
                 dayExpenses += financialRecords[i].amount;
             }
         }
@@ -544,12 +316,13 @@ bool generateProfitTrend(const char *startDate, const char *endDate, const char
     
     // Output the last date's data
     if (strlen(currentDate) > 0) {
-        fprintf(file, "%s,%.2f,%.2f,%.2f\n", 
-               currentDate, dayIncome, dayExpenses, dayIncome - dayExpenses);
+        writeProfitTrendRow(&csv, currentDate, dayIncome, dayExpenses);
     }
     
-    fclose(file);
-    printf("Profit trend data generated and saved to %s\n", SALES_DATA_CSV);
+    if (!closeCsvWriter(&csv)) {
+        displayError("Failed to write sales data file.");
+        return false;
+    }
     return true;
 }
 
@@ -572,52 +345,57 @@ bool generateExpenseTrend(const char *category, const char *startDate, const cha
     }
     
     // Open file for writing
-    FILE *file = fopen(SALES_DATA_CSV, "w");
-    if (!file) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, SALES_DATA_CSV)) {
         displayError("Failed to open sales data file for writing.");
         return false;
     }
     
     // Write header
     if (!category || strlen(category) == 0) {
-        fprintf(file, "Date,Category,Expenses\n");
+        writeCsvRaw(&csv, "Date,Category,Expenses\n");
     } else {
-        fprintf(file, "Date,Expenses\n");
+        writeCsvRaw(&csv, "Date,Expenses\n");
     }
     
     // If no financial records, create an empty file and return
     if (financialRecordCount == 0) {
-        fclose(file);
-        return true;
+        return closeCsvWriter(&csv);
     }
     
-    // Process financial records
-    for (int i = 0; i < financialRecordCount; i++) {
+    // Resolve the category filter once and compare IDs
+    bool allCategories = !category || strlen(category) == 0;
+    uint32_t categoryId = allCategories ? INVALID_STRING_ID : findStringId(category);
+    
+    // Process financial records, skipping blocks without the category or outside the period
+    int slots[MAX_ARRAY_SIZE];
+    int slotCount = findFinancialRecordCandidates(startDate, endDate, categoryId, slots, MAX_ARRAY_SIZE);
+    
+    for (int s = 0; s < slotCount; s++) {
+        int i = slots[s];
+        
         // Filter by date range and record type
         if (strcmp(financialRecords[i].date, startDate) >= 0 && 
             strcmp(financialRecords[i].date, endDate) <= 0 &&
-            strcmp(financialRecords[i].type, "Expense") == 0) {
+            financialRecords[i].typeId == STRING_ID_EXPENSE) {
             
             // Filter by category if specified
-            if (!category || strlen(category) == 0 || 
-                strcmp(financialRecords[i].category, category) == 0) {
+            if (allCategories || financialRecords[i].categoryId == categoryId) {
                 
-                if (!category || strlen(category) == 0) {
-                    fprintf(file, "%s,%s,%.2f\n", 
-                           financialRecords[i].date,
-                           financialRecords[i].category,
-                           financialRecords[i].amount);
-                } else {
-                    fprintf(file, "%s,%.2f\n", 
-                           financialRecords[i].date,
-                           financialRecords[i].amount);
+                writeCsvText(&csv, financialRecords[i].date);
+                if (allCategories) {
+                    writeCsvText(&csv, lookupString(financialRecords[i].categoryId));
                 }
+                writeCsvDecimal(&csv, financialRecords[i].amount, 2);
+                endCsvRow(&csv);
             }
         }
     }
     
-    fclose(file);
-    printf("Expense trend data generated and saved to %s\n", SALES_DATA_CSV);
+    if (!closeCsvWriter(&csv)) {
+        displayError("Failed to write sales data file.");
+        return false;
+    }
     return true;
 }
 
@@ -652,96 +430,9 @@ bool exportTrendData(const char *trendType, const char *filename) {
     fclose(source);
     fclose(destination);
     
-    printf("Trend data exported to %s\n", filename);
-    return true;
-}
-
-// Function to show sales graph using Python script
-bool showSalesGraph(const char *dataFile, const char *title, const char *xLabel, const char *yLabel) {
-    // Check if CSV file exists
-    if (!fileExists(dataFile)) {
-        displayError("Sales data file not found.");
-        return false;
-    }
-    
-    // Create a temporary Python script to visualize the data
-    const char *pythonScriptPath = "show_sales_graph.py";
-    
-    FILE *pythonScript = fopen(pythonScriptPath, "w");
-    if (!pythonScript) {
-        displayError("Failed to create Python script file.");
-        return false;
-    }
-    
-    // Write Python script content
-    fprintf(pythonScript, "import matplotlib.pyplot as plt\n");
-    fprintf(pythonScript, "import pandas as pd\n");
-    fprintf(pythonScript, "import sys\n\n");
-    
-    fprintf(pythonScript, "# Load data from CSV\n");
-    fprintf(pythonScript, "try:\n");
-    fprintf(pythonScript, "    data = pd.read_csv('%s')\n", dataFile);
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # Create the plot\n");
-    fprintf(pythonScript, "    plt.figure(figsize=(10, 6))\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # If data has more than 2 columns, it's likely a multi-series plot\n");
-    fprintf(pythonScript, "    if len(data.columns) > 2:\n");
-    fprintf(pythonScript, "        # Get the first column as x-axis (usually date)\n");
-    fprintf(pythonScript, "        x_column = data.columns[0]\n");
-    fprintf(pythonScript, "        \n");
-    fprintf(pythonScript, "        # Plot each numerical column except the first one\n");
-    fprintf(pythonScript, "        for column in data.columns[1:]:\n");
-    fprintf(pythonScript, "            if pd.api.types.is_numeric_dtype(data[column]):\n");
-    fprintf(pythonScript, "                plt.plot(data[x_column], data[column], marker='o', label=column)\n");
-    fprintf(pythonScript, "    else:\n");
-    fprintf(pythonScript, "        # Simple 2-column plot\n");
-    fprintf(pythonScript, "        plt.plot(data.iloc[:, 0], data.iloc[:, 1], marker='o')\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # Add labels and title\n");
-    fprintf(pythonScript, "    plt.xlabel('%s')\n", xLabel);
-    fprintf(pythonScript, "    plt.ylabel('%s')\n", yLabel);
-    fprintf(pythonScript, "    plt.title('%s')\n", title);
-    fprintf(pythonScript, "    plt.grid(True)\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # Add legend if there are multiple data series\n");
-    fprintf(pythonScript, "    if len(data.columns) > 2:\n");
-    fprintf(pythonScript, "        plt.legend()\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # Rotate x-axis labels for better readability\n");
-    fprintf(pythonScript, "    plt.xticks(rotation=45)\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # Adjust layout\n");
-    fprintf(pythonScript, "    plt.tight_layout()\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # Save the plot\n");
-    fprintf(pythonScript, "    plt.savefig('sales_graph.png')\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    # Show the plot\n");
-    fprintf(pythonScript, "    plt.show()\n");
-    fprintf(pythonScript, "    \n");
-    fprintf(pythonScript, "    print('Graph generated successfully!')\n");
-    fprintf(pythonScript, "    sys.exit(0)\n");
-    fprintf(pythonScript, "except Exception as e:\n");
-    fprintf(pythonScript, "    print(f'Error generating graph: {e}')\n");
-    fprintf(pythonScript, "    sys.exit(1)\n");
-    
-    fclose(pythonScript);
-    
-    // Execute the Python script
-    printf("\nGenerating graph... (This may open in a new window)\n");
-    
-    char command[256];
-    snprintf(command, sizeof(command), "python %s", pythonScriptPath);
-    
-    int result = system(command);
-    
-    if (result != 0) {
-        printf("\nFailed to generate graph. Please make sure Python and matplotlib are installed.\n");
-        printf("You can install the required packages with: pip install matplotlib pandas\n");
-        return false;
-    }
-    
+    char message[300];
+    snprintf(message, sizeof(message), "Trend data exported to %s", filename);
+    displaySuccess(message);
     return true;
 }
 
@@ -789,7 +480,7 @@ double calculateExpenseForecast(int months) {
     int expenseCount = 0;
     
     for (int i = 0; i < financialRecordCount; i++) {
-        if (strcmp(financialRecords[i].type, "Expense") == 0) {
+        if (financialRecords[i].typeId == STRING_ID_EXPENSE) {
             totalExpenses += financialRecords[i].amount;
             expenseCount++;
         }
@@ -818,51 +509,292 @@ double calculateProfitForecast(int months) {
     return revenueForecast - expenseForecast;
 }
 
-// Function to generate sales forecast report
-void generateSalesForecastReport(int months) {
-    double revenueForecast = calculateRevenueForecast(months);
-    double expenseForecast = calculateExpenseForecast(months);
-    double profitForecast = revenueForecast - expenseForecast;
-    double profitMargin = revenueForecast > 0 ? (profitForecast / revenueForecast) * 100.0 : 0.0;
-    
-    printf("\n\033[1;36m========================================\033[0m\n");
-    printf("\033[1;32m      %d-MONTH FORECAST REPORT\033[0m\n", months);
-    printf("\033[1;36m========================================\033[0m\n");
-    
-    printf("Forecasted Monthly Figures:\n\n");
-    printf("%-20s $%.2f\n", "Revenue:", revenueForecast);
-    printf("%-20s $%.2f\n", "Expenses:", expenseForecast);
-    printf("%-20s $%.2f\n", "Profit:", profitForecast);
-    printf("%-20s %.1f%%\n", "Profit Margin:", profitMargin);
-    
-    printf("\nNote: This forecast is based on historical data and assumes similar business conditions.\n");
-    printf("Actual results may vary based on market conditions, seasonality, and other factors.\n");
-    
-    // Export option
-    printf("\nWould you like to export this forecast to a CSV file? (y/n): ");
-    char exportChoice;
-    scanf("%c", &exportChoice);
-    clearInputBuffer();
-    
-    if (exportChoice == 'y' || exportChoice == 'Y') {
-        char filename[100];
-        snprintf(filename, sizeof(filename), "forecast_report_%d_months.csv", months);
+// Function to compute the forecast report
+void buildSalesForecast(int months, SalesForecast *forecast) {
+    forecast->months = months;
+    forecast->revenue = calculateRevenueForecast(months);
+    forecast->expenses = calculateExpenseForecast(months);
+    forecast->profit = forecast->revenue - forecast->expenses;
+    forecast->profitMargin = forecast->revenue > 0 ? (forecast->profit / forecast->revenue) * 100.0 : 0.0;
+}
+    
+// Function to export the forecast report to a CSV file
+bool exportSalesForecastCsv(const char *filename, const SalesForecast *forecast) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, filename)) {
+        return false;
+    }
+    
+    char period[30];
+    snprintf(period, sizeof(period), "%d months", forecast->months);
+    
+    writeCsvRaw(&csv, "FORECAST REPORT\n");
+    writeCsvText(&csv, "Forecast Period");
+    writeCsvText(&csv, period);
+    endCsvRow(&csv);
+    writeCsvRaw(&csv, "\n");
+    
+    writeCsvRaw(&csv, "FORECASTED MONTHLY FIGURES\n");
+    writeCsvMoneyRow(&csv, "Revenue", forecast->revenue);
+    writeCsvMoneyRow(&csv, "Expenses", forecast->expenses);
+    writeCsvMoneyRow(&csv, "Profit", forecast->profit);
+    writeCsvPercentRow(&csv, "Profit Margin", forecast->profitMargin);
+    
+    return closeCsvWriter(&csv);
+}
+
+// Value and customer position pair used to rank customers for RFM scoring
+typedef struct {
+    double value;
+    int index;
+} RankedValue;
+
+// Comparison function for sorting ranked values (low to high)
+static int compareRankedValues(const void *a, const void *b) {
+    const RankedValue *left = (const RankedValue *)a;
+    const RankedValue *right = (const RankedValue *)b;
+    
+    if (left->value < right->value) {
+        return -1;
+    } else if (left->value > right->value) {
+        return 1;
+    }
+    
+    return left->index - right->index;
+}
+
+// Function to assign quantile scores (1 to RFM_SCORE_BUCKETS), equal values share a score
+static void assignQuantileScores(RankedValue *ranked, int count, int *scores) {
+    int groupScore = 1;
+    
+    qsort(ranked, count, sizeof(RankedValue), compareRankedValues);
+    
+    for (int i = 0; i < count; i++) {
+        if (i == 0 || ranked[i].value != ranked[i - 1].value) {
+            groupScore = 1 + (i * RFM_SCORE_BUCKETS) / count;
+        }
+        scores[ranked[i].index] = groupScore;
+    }
+}
+
+// Function to derive a segment name from RFM scores
+static const char *getRFMSegment(const CustomerRFM *rfm) {
+    if (rfm->frequency == 0) {
+        return "No Purchases";
+    }
+    
+    if (rfm->recencyScore >= 4 && rfm->frequencyScore >= 4) {
+        return "Champions";
+    } else if (rfm->recencyScore >= 3 && rfm->frequencyScore >= 3) {
+        return "Loyal Customers";
+    } else if (rfm->recencyScore >= 4) {
+        return "New Customers";
+    } else if (rfm->recencyScore <= 2 && rfm->frequencyScore >= 3) {
+        return "At Risk";
+    } else if (rfm->recencyScore <= 2) {
+        return "Lost";
+    }
+    
+    return "Need Attention";
+}
+
+// Transactions scanned by one RFM worker, with its own totals per customer
+typedef struct {
+    int first;                               // First transaction of the slice
+    int last;                                // One past the last transaction of the slice
+    int customerCount;                       // Number of customers being scored
+    int referenceDay;                        // Day recency is measured from
+    CustomerRFM totals[MAX_ARRAY_SIZE];      // Frequency, monetary and recency found in the slice
+} RFMSlice;
+
+// Function to total one slice of the transactions, joined to customers by ID (customers are sorted by ID)
+static void scanRFMSlice(void *argument) {
+    RFMSlice *slice = (RFMSlice *)argument;
+    
+    for (int i = 0; i < slice->customerCount; i++) {
+        slice->totals[i].recencyDays = -1;
+    }
+    
+    for (int i = slice->first; i < slice->last; i++) {
+        if (transactions[i].statusId != STRING_ID_COMPLETED) {
+            continue;
+        }
         
-        FILE *file = fopen(filename, "w");
-        if (file) {
-            fprintf(file, "FORECAST REPORT\n");
-            fprintf(file, "Forecast Period,%d months\n\n", months);
-            
-            fprintf(file, "FORECASTED MONTHLY FIGURES\n");
-            fprintf(file, "Revenue,$%.2f\n", revenueForecast);
-            fprintf(file, "Expenses,$%.2f\n", expenseForecast);
-            fprintf(file, "Profit,$%.2f\n", profitForecast);
-            fprintf(file, "Profit Margin,%.1f%%\n", profitMargin);
+        // Skip anonymous and free-text customer IDs
+        int id;
+        if (!parseCustomerId(transactions[i].customerId, &id)) {
+            continue;
+        }
+        
+        int customerIndex = findCustomerById(id);
+        if (customerIndex == -1 || customerIndex >= slice->customerCount) {
+            continue;
+        }
+        
+        CustomerRFM *rfm = &slice->totals[customerIndex];
+        rfm->frequency++;
+        rfm->monetary += transactions[i].total;
+        
+        int day = dateToDayNumber(transactions[i].date);
+        if (day != -1) {
+            int recency = slice->referenceDay > day ? slice->referenceDay - day : 0;
+            if (rfm->recencyDays == -1 || recency < rfm->recencyDays) {
+                rfm->recencyDays = recency;
+            }
+        }
+    }
+}
+
+// Function to calculate RFM scores for every customer
+int calculateCustomerRFM(CustomerRFM *results, int maxResults, const char *referenceDate) {
+    int count = customerCount < maxResults ? customerCount : maxResults;
+    
+    if (!results || count <= 0) {
+        return 0;
+    }
+    
+    // Determine the day recency is measured from
+    int referenceDay = -1;
+    if (referenceDate && strlen(referenceDate) > 0) {
+        referenceDay = dateToDayNumber(referenceDate);
+    }
+    if (referenceDay == -1) {
+        char today[20];
+        getCurrentDateTime(today, sizeof(today));
+        referenceDay = dateToDayNumber(today);
+    }
+    
+    for (int i = 0; i < count; i++) {
+        results[i].customerId = customers[i].id;
+        results[i].recencyDays = -1;
+        results[i].frequency = 0;
+        results[i].monetary = 0.0;
+    }
+    
+    // Single pass over transactions split into slices, each with its own totals per customer
+    int sliceCount = getWorkerThreadCount();
+    if (sliceCount > transactionCount) {
+        sliceCount = transactionCount;
+    }
+    
+    // Without the slices every customer would look like one with no purchases
+    RFMSlice *slices = calloc(sliceCount > 0 ? sliceCount : 1, sizeof(RFMSlice));
+    ParallelTask tasks[MAX_WORKER_THREADS];
+    if (!slices) {
+        displayError("Not enough memory to score customers.");
+        return -1;
+    }
+    
+    for (int s = 0; s < sliceCount; s++) {
+        slices[s].first = (int)((long)transactionCount * s / sliceCount);
+        slices[s].last = (int)((long)transactionCount * (s + 1) / sliceCount);
+        slices[s].customerCount = count;
+        slices[s].referenceDay = referenceDay;
+        
+        tasks[s].function = scanRFMSlice;
+        tasks[s].argument = &slices[s];
+        tasks[s].elapsedMilliseconds = 0.0;
+    }
+    
+    runParallelTasks(tasks, sliceCount, sliceCount);
+    
+    // Merge the slice totals; the most recent purchase across slices wins
+    for (int s = 0; s < sliceCount; s++) {
+        for (int i = 0; i < count; i++) {
+            const CustomerRFM *partial = &slices[s].totals[i];
             
-            fclose(file);
-            printf("Forecast exported to %s\n", filename);
-        } else {
-            printf("Failed to export forecast.\n");
+            results[i].frequency += partial->frequency;
+            results[i].monetary += partial->monetary;
+            if (partial->recencyDays != -1 &&
+                (results[i].recencyDays == -1 || partial->recencyDays < results[i].recencyDays)) {
+                results[i].recencyDays = partial->recencyDays;
+            }
+        }
+    }
+    free(slices);
+    
+    // Quantile bucketing of each metric
+    RankedValue ranked[MAX_ARRAY_SIZE];
+    int scores[MAX_ARRAY_SIZE];
+    
+    for (int i = 0; i < count; i++) {
+        // More recent purchases rank higher; customers without purchases rank lowest
+        ranked[i].value = results[i].recencyDays == -1 ? -1e18 : -(double)results[i].recencyDays;
+        ranked[i].index = i;
+    }
+    assignQuantileScores(ranked, count, scores);
+    for (int i = 0; i < count; i++) {
+        results[i].recencyScore = scores[i];
+    }
+    
+    for (int i = 0; i < count; i++) {
+        ranked[i].value = results[i].frequency;
+        ranked[i].index = i;
+    }
+    assignQuantileScores(ranked, count, scores);
+    for (int i = 0; i < count; i++) {
+        results[i].frequencyScore = scores[i];
+    }
+    
+    for (int i = 0; i < count; i++) {
+        ranked[i].value = results[i].monetary;
+        ranked[i].index = i;
+    }
+    assignQuantileScores(ranked, count, scores);
+    for (int i = 0; i < count; i++) {
+        results[i].monetaryScore = scores[i];
+        results[i].segment = getRFMSegment(&results[i]);
+    }
+    
+    return count;
+}
+
+// Function to total the customers and spending of each segment
+int summarizeCustomerSegments(const CustomerRFM *results, int count, SegmentSummary *summaries) {
+    int segmentCount = 0;
+    
+    for (int i = 0; i < count; i++) {
+        int j = 0;
+        while (j < segmentCount && strcmp(summaries[j].segment, results[i].segment) != 0) {
+            j++;
         }
+        
+        // Segments are listed in order of first appearance
+        if (j == segmentCount) {
+            summaries[j].segment = results[i].segment;
+            summaries[j].customerCount = 0;
+            summaries[j].monetary = 0.0;
+            segmentCount++;
+        }
+        
+        summaries[j].customerCount++;
+        summaries[j].monetary += results[i].monetary;
     }
+    
+    return segmentCount;
+}
+
+// Function to export customer RFM scores and segments to a CSV file
+bool exportCustomerSegmentsCsv(const char *filename, const CustomerRFM *results, int count) {
+    CsvWriter csv;
+    if (!openCsvWriter(&csv, filename)) {
+        return false;
+    }
+    
+    writeCsvRaw(&csv, "CustomerID,Name,RecencyDays,Frequency,Monetary,RecencyScore,FrequencyScore,MonetaryScore,Segment\n");
+    
+    for (int i = 0; i < count; i++) {
+        writeCsvInt(&csv, results[i].customerId);
+        writeCsvText(&csv, customers[i].name);
+        writeCsvInt(&csv, results[i].recencyDays);
+        writeCsvInt(&csv, results[i].frequency);
+        writeCsvDecimal(&csv, results[i].monetary, 2);
+        writeCsvInt(&csv, results[i].recencyScore);
+        writeCsvInt(&csv, results[i].frequencyScore);
+        writeCsvInt(&csv, results[i].monetaryScore);
+        writeCsvText(&csv, results[i].segment);
+        endCsvRow(&csv);
+    }
+        
+    return closeCsvWriter(&csv);
 }
\ No newline at end of file
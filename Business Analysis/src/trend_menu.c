@@ -0,0 +1,489 @@
+/**
+ * Trend Menu Implementation File
+ * Contains the trend analysis screens and prompts built on the trend analysis module
+ */
+
+#include "menu.h"
+#include "trend_analysis.h"
+#include "product.h"
+#include "customer.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "globals.h"
+
+// Function to run the trend analysis module
+void runTrendAnalysis() {
+    int choice;
+    bool running = true;
+    
+    while (running) {
+        clearScreen();
+        printf("\n\033[1;36m========================================\033[0m\n");
+        printf("\033[1;32m          TREND ANALYSIS\033[0m\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("1. Sales Trends\n");
+        printf("2. Product Sales Analysis\n");
+        printf("3. Category Sales Analysis\n");
+        printf("4. Profit Trends\n");
+        printf("5. Expense Trends\n");
+        printf("6. Sales Forecast\n");
+        printf("7. Customer Segmentation (RFM)\n");
+        printf("8. Back to Main Menu\n");
+        printf("\033[1;36m========================================\033[0m\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        clearInputBuffer();
+        
+        switch (choice) {
+            case 1: {
+                char startDate[20], endDate[20], interval[10];
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                printf("Enter interval (daily, weekly, monthly): ");
+                fgets(interval, sizeof(interval), stdin);
+                interval[strcspn(interval, "\n")] = 0;
+                
+                if (generateSalesTrend(startDate, endDate, interval)) {
+                    printf("Sales trend data generated and saved to %s\n", SALES_DATA_CSV);
+                    
+                    char title[100], xLabel[50], yLabel[50];
+                    snprintf(title, sizeof(title), "Sales Trend (%s to %s)", startDate, endDate);
+                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
+                    sprintf(yLabel, "Sales Amount ($)");
+                    
+                    printf("Would you like to visualize this trend? (y/n): ");
+                    char visualizeChoice;
+                    scanf("%c", &visualizeChoice);
+                    clearInputBuffer();
+                    
+                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
+                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
+                    }
+                } else {
+                    displayError("Failed to generate sales trend data.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 2: {
+                int productId;
+                char startDate[20], endDate[20], interval[10];
+                
+                printf("Enter product ID (0 for all products): ");
+                scanf("%d", &productId);
+                clearInputBuffer();
+                
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                printf("Enter interval (daily, weekly, monthly): ");
+                fgets(interval, sizeof(interval), stdin);
+                interval[strcspn(interval, "\n")] = 0;
+                
+                if (generateProductSalesTrend(productId, startDate, endDate, interval)) {
+                    printf("Product sales trend data generated and saved to %s\n", SALES_DATA_CSV);
+                    
+                    char title[100], xLabel[50], yLabel[50];
+                    
+                    if (productId == 0) {
+                        snprintf(title, sizeof(title), "Product Sales Comparison (%s to %s)", startDate, endDate);
+                    } else {
+                        char productName[50] = "Selected Product";
+                        // Get product name if available
+                        loadProductData();
+                        int index = findProductById(productId);
+                        if (index != -1) {
+                            strcpy(productName, getProductName(index));
+                        }
+                        snprintf(title, sizeof(title), "%s Sales Trend (%s to %s)", productName, startDate, endDate);
+                    }
+                    
+                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
+                    sprintf(yLabel, "Sales Amount ($)");
+                    
+                    printf("Would you like to visualize this trend? (y/n): ");
+                    char visualizeChoice;
+                    scanf("%c", &visualizeChoice);
+                    clearInputBuffer();
+                    
+                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
+                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
+                    }
+                } else {
+                    displayError("Failed to generate product sales trend data.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 3: {
+                char category[30], startDate[20], endDate[20], interval[10];
+                
+                printf("Enter category (leave blank for all categories): ");
+                fgets(category, sizeof(category), stdin);
+                category[strcspn(category, "\n")] = 0;
+                
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                printf("Enter interval (daily, weekly, monthly): ");
+                fgets(interval, sizeof(interval), stdin);
+                interval[strcspn(interval, "\n")] = 0;
+                
+                if (generateCategorySalesTrend(category, startDate, endDate, interval)) {
+                    printf("Category sales trend data generated and saved to %s\n", SALES_DATA_CSV);
+                    
+                    char title[100], xLabel[50], yLabel[50];
+                    
+                    if (strlen(category) == 0) {
+                        snprintf(title, sizeof(title), "Category Sales Comparison (%s to %s)", startDate, endDate);
+                    } else {
+                        snprintf(title, sizeof(title), "%s Category Sales Trend (%s to %s)", category, startDate, endDate);
+                    }
+                    
+                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
+                    sprintf(yLabel, "Sales Amount ($)");
+                    
+                    printf("Would you like to visualize this trend? (y/n): ");
+                    char visualizeChoice;
+                    scanf("%c", &visualizeChoice);
+                    clearInputBuffer();
+                    
+                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
+                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
+                    }
+                } else {
+                    displayError("Failed to generate category sales trend data.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 4: {
+                char startDate[20], endDate[20], interval[10];
+                
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                printf("Enter interval (daily, weekly, monthly): ");
+                fgets(interval, sizeof(interval), stdin);
+                interval[strcspn(interval, "\n")] = 0;
+                
+                if (generateProfitTrend(startDate, endDate, interval)) {
+                    printf("Profit trend data generated and saved to %s\n", SALES_DATA_CSV);
+                    
+                    char title[100], xLabel[50], yLabel[50];
+                    snprintf(title, sizeof(title), "Profit Trend (%s to %s)", startDate, endDate);
+                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
+                    sprintf(yLabel, "Profit Amount ($)");
+                    
+                    printf("Would you like to visualize this trend? (y/n): ");
+                    char visualizeChoice;
+                    scanf("%c", &visualizeChoice);
+                    clearInputBuffer();
+                    
+                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
+                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
+                    }
+                } else {
+                    displayError("Failed to generate profit trend data.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 5: {
+                char category[30], startDate[20], endDate[20], interval[10];
+                
+                printf("Enter expense category (leave blank for all categories): ");
+                fgets(category, sizeof(category), stdin);
+                category[strcspn(category, "\n")] = 0;
+                
+                printf("Enter start date (YYYY-MM-DD): ");
+                fgets(startDate, sizeof(startDate), stdin);
+                startDate[strcspn(startDate, "\n")] = 0;
+                
+                printf("Enter end date (YYYY-MM-DD): ");
+                fgets(endDate, sizeof(endDate), stdin);
+                endDate[strcspn(endDate, "\n")] = 0;
+                
+                printf("Enter interval (daily, weekly, monthly): ");
+                fgets(interval, sizeof(interval), stdin);
+                interval[strcspn(interval, "\n")] = 0;
+                
+                if (generateExpenseTrend(category, startDate, endDate, interval)) {
+                    printf("Expense trend data generated and saved to %s\n", SALES_DATA_CSV);
+                    
+                    char title[100], xLabel[50], yLabel[50];
+                    
+                    if (strlen(category) == 0) {
+                        snprintf(title, sizeof(title), "Expense Trend (%s to %s)", startDate, endDate);
+                    } else {
+                        snprintf(title, sizeof(title), "%s Expense Trend (%s to %s)", category, startDate, endDate);
+                    }
+                    
+                    snprintf(xLabel, sizeof(xLabel), "Date (%s)", interval);
+                    sprintf(yLabel, "Expense Amount ($)");
+                    
+                    printf("Would you like to visualize this trend? (y/n): ");
+                    char visualizeChoice;
+                    scanf("%c", &visualizeChoice);
+                    clearInputBuffer();
+                    
+                    if (visualizeChoice == 'y' || visualizeChoice == 'Y') {
+                        showSalesGraph(SALES_DATA_CSV, title, xLabel, yLabel);
+                    }
+                } else {
+                    displayError("Failed to generate expense trend data.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 6: {
+                int months;
+                printf("Enter number of months to forecast: ");
+                scanf("%d", &months);
+                clearInputBuffer();
+                
+                if (months > 0) {
+                    generateSalesForecastReport(months);
+                } else {
+                    displayError("Invalid number of months.");
+                }
+                pressEnterToContinue();
+                break;
+            }
+            case 7:
+                generateCustomerSegmentationReport();
+                pressEnterToContinue();
+                break;
+            case 8:
+                running = false;
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+                pressEnterToContinue();
+        }
+    }
+}
+
+// Function to show sales graph using Python script
+bool showSalesGraph(const char *dataFile, const char *title, const char *xLabel, const char *yLabel) {
+    // Check if CSV file exists
+    if (!fileExists(dataFile)) {
+        displayError("Sales data file not found.");
+        return false;
+    }
+    
+    // Create a temporary Python script to visualize the data
+    const char *pythonScriptPath = "show_sales_graph.py";
+    
+    FILE *pythonScript = fopen(pythonScriptPath, "w");
+    if (!pythonScript) {
+        displayError("Failed to create Python script file.");
+        return false;
+    }
+    
+    // Write Python script content
+    fprintf(pythonScript, "import matplotlib.pyplot as plt\n");
+    fprintf(pythonScript, "import pandas as pd\n");
+    fprintf(pythonScript, "import sys\n\n");
+    
+    fprintf(pythonScript, "# Load data from CSV\n");
+    fprintf(pythonScript, "try:\n");
+    fprintf(pythonScript, "    data = pd.read_csv('%s')\n", dataFile);
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # Create the plot\n");
+    fprintf(pythonScript, "    plt.figure(figsize=(10, 6))\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # If data has more than 2 columns, it's likely a multi-series plot\n");
+    fprintf(pythonScript, "    if len(data.columns) > 2:\n");
+    fprintf(pythonScript, "        # Get the first column as x-axis (usually date)\n");
+    fprintf(pythonScript, "        x_column = data.columns[0]\n");
+    fprintf(pythonScript, "        \n");
+    fprintf(pythonScript, "        # Plot each numerical column except the first one\n");
+    fprintf(pythonScript, "        for column in data.columns[1:]:\n");
+    fprintf(pythonScript, "            if pd.api.types.is_numeric_dtype(data[column]):\n");
+    fprintf(pythonScript, "                plt.plot(data[x_column], data[column], marker='o', label=column)\n");
+    fprintf(pythonScript, "    else:\n");
+    fprintf(pythonScript, "        # Simple 2-column plot\n");
+    fprintf(pythonScript, "        plt.plot(data.iloc[:, 0], data.iloc[:, 1], marker='o')\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # Add labels and title\n");
+    fprintf(pythonScript, "    plt.xlabel('%s')\n", xLabel);
+    fprintf(pythonScript, "    plt.ylabel('%s')\n", yLabel);
+    fprintf(pythonScript, "    plt.title('%s')\n", title);
+    fprintf(pythonScript, "    plt.grid(True)\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # Add legend if there are multiple data series\n");
+    fprintf(pythonScript, "    if len(data.columns) > 2:\n");
+    fprintf(pythonScript, "        plt.legend()\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # Rotate x-axis labels for better readability\n");
+    fprintf(pythonScript, "    plt.xticks(rotation=45)\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # Adjust layout\n");
+    fprintf(pythonScript, "    plt.tight_layout()\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # Save the plot\n");
+    fprintf(pythonScript, "    plt.savefig('sales_graph.png')\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    # Show the plot\n");
+    fprintf(pythonScript, "    plt.show()\n");
+    fprintf(pythonScript, "    \n");
+    fprintf(pythonScript, "    print('Graph generated successfully!')\n");
+    fprintf(pythonScript, "    sys.exit(0)\n");
+    fprintf(pythonScript, "except Exception as e:\n");
+    fprintf(pythonScript, "    print(f'Error generating graph: {e}')\n");
+    fprintf(pythonScript, "    sys.exit(1)\n");
+    
+    fclose(pythonScript);
+    
+    // Execute the Python script
+    printf("\nGenerating graph... (This may open in a new window)\n");
+    
+    char command[256];
+    snprintf(command, sizeof(command), "python %s", pythonScriptPath);
+    
+    int result = system(command);
+    
+    if (result != 0) {
+        printf("\nFailed to generate graph. Please make sure Python and matplotlib are installed.\n");
+        printf("You can install the required packages with: pip install matplotlib pandas\n");
+        return false;
+    }
+    
+    return true;
+}
+
+// Function to generate sales forecast report
+void generateSalesForecastReport(int months) {
+    SalesForecast forecast;
+    buildSalesForecast(months, &forecast);
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m      %d-MONTH FORECAST REPORT\033[0m\n", months);
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("Forecasted Monthly Figures:\n\n");
+    printf("%-20s $%.2f\n", "Revenue:", forecast.revenue);
+    printf("%-20s $%.2f\n", "Expenses:", forecast.expenses);
+    printf("%-20s $%.2f\n", "Profit:", forecast.profit);
+    printf("%-20s %.1f%%\n", "Profit Margin:", forecast.profitMargin);
+    
+    printf("\nNote: This forecast is based on historical data and assumes similar business conditions.\n");
+    printf("Actual results may vary based on market conditions, seasonality, and other factors.\n");
+    
+    // Export option
+    printf("\nWould you like to export this forecast to a CSV file? (y/n): ");
+    char exportChoice;
+    scanf("%c", &exportChoice);
+    clearInputBuffer();
+    
+    if (exportChoice == 'y' || exportChoice == 'Y') {
+        char filename[100];
+        snprintf(filename, sizeof(filename), "forecast_report_%d_months.csv", months);
+        
+        if (exportSalesForecastCsv(filename, &forecast)) {
+            printf("Forecast exported to %s\n", filename);
+        } else {
+            printf("Failed to export forecast.\n");
+        }
+    }
+}
+
+// Function to generate customer segmentation (RFM) report
+void generateCustomerSegmentationReport() {
+    // Load customer and transaction data
+    loadCustomerData();
+    loadTransactionData();
+    
+    if (customerCount == 0) {
+        printf("No customer data available for segmentation.\n");
+        return;
+    }
+    
+    CustomerRFM results[MAX_ARRAY_SIZE];
+    int count = calculateCustomerRFM(results, MAX_ARRAY_SIZE, NULL);
+    if (count < 0) {
+        return;
+    }
+    
+    printf("\n\033[1;36m========================================\033[0m\n");
+    printf("\033[1;32m   CUSTOMER SEGMENTATION (RFM)\033[0m\n");
+    printf("\033[1;36m========================================\033[0m\n");
+    
+    printf("%-8s %-20s %-10s %-6s %-12s %-5s %s\n", 
+           "ID", "Name", "Recency", "Freq", "Monetary", "RFM", "Segment");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < count; i++) {
+        char recency[20];
+        if (results[i].recencyDays == -1) {
+            strcpy(recency, "-");
+        } else {
+            snprintf(recency, sizeof(recency), "%d days", results[i].recencyDays);
+        }
+        
+        printf("%-8d %-20.20s %-10s %-6d $%-11.2f %d%d%d   %s\n", 
+               results[i].customerId,
+               customers[i].name,
+               recency,
+               results[i].frequency,
+               results[i].monetary,
+               results[i].recencyScore,
+               results[i].frequencyScore,
+               results[i].monetaryScore,
+               results[i].segment);
+    }
+    
+    printf("--------------------------------------------------------------------------------\n");
+    
+    // Segment summary
+    printf("\nSegment Summary:\n");
+    printf("------------------------\n");
+    
+    SegmentSummary segments[MAX_ARRAY_SIZE];
+    int segmentCount = summarizeCustomerSegments(results, count, segments);
+    
+    for (int i = 0; i < segmentCount; i++) {
+        printf("%-16s %d customers, $%.2f\n", segments[i].segment, segments[i].customerCount, segments[i].monetary);
+    }
+    
+    // Export option
+    printf("\nWould you like to export this segmentation to a CSV file? (y/n): ");
+    char exportChoice;
+    scanf("%c", &exportChoice);
+    clearInputBuffer();
+    
+    if (exportChoice == 'y' || exportChoice == 'Y') {
+        const char *filename = "customer_segments.csv";
+        
+        if (exportCustomerSegmentsCsv(filename, results, count)) {
+            printf("Segmentation exported to %s\n", filename);
+        } else {
+            printf("Failed to export segmentation.\n");
+        }
+    }
+}
\ No newline at end of file
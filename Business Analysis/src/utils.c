@@ -20,13 +20,14 @@
     #define MKDIR(dir) mkdir(dir, 0700)  // Unix version takes two arguments
 #endif
 
+// Receiver of error and success messages, or NULL to print them
+static MessageHandler messageHandler = NULL;
+
 // Function to clear the console screen
 void clearScreen() {
-    #ifdef _WIN32
-        system("cls");
-    #else
-        system("clear");
-    #endif
+    // The same ANSI escapes as the colours, rather than starting a shell to run clear
+    printf("\033[2J\033[H");
+    fflush(stdout);
 }
 
 // Function to clear the input buffer
@@ -76,13 +77,26 @@ bool createDirectory(const char *directoryName) {
     return true;
 }
 
+// Function to send error and success messages to a handler instead of the terminal
+void setMessageHandler(MessageHandler handler) {
+    messageHandler = handler;
+}
+
 // Function to display an error message
 void displayError(const char *message) {
+    if (messageHandler) {
+        messageHandler(MESSAGE_ERROR, message);
+        return;
+    }
     printf("\033[1;31mERROR: %s\033[0m\n", message);
 }
 
 // Function to display a success message
 void displaySuccess(const char *message) {
+    if (messageHandler) {
+        messageHandler(MESSAGE_SUCCESS, message);
+        return;
+    }
     printf("\033[1;32mSUCCESS: %s\033[0m\n", message);
 }
 
@@ -109,6 +123,83 @@ void getCurrentDateTime(char *buffer, size_t bufferSize) {
     strftime(buffer, bufferSize, "%Y-%m-%d %H:%M:%S", tm_now);
 }
 
+// Function to convert a date string to a day number (days since 1970-01-01)
+int dateToDayNumber(const char *date) {
+    int year, month, day;
+    
+    if (!date || sscanf(date, "%4d-%2d-%2d", &year, &month, &day) != 3) {
+        return -1;
+    }
+    
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return -1;
+    }
+    
+    // Days-from-civil conversion (proleptic Gregorian calendar)
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Function to check whether a string contains a lowercase substring, ignoring case
+bool containsIgnoreCase(const char *text, const char *loweredQuery) {
+    if (*loweredQuery == '\0') {
+        return true;
+    }
+    
+    for (; *text; text++) {
+        const char *t = text;
+        const char *q = loweredQuery;
+        
+        while (*t && *q && tolower((unsigned char)*t) == *q) {
+            t++;
+            q++;
+        }
+        
+        if (*q == '\0') {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// Function to encode an unsigned integer as a variable-length integer
+size_t encodeVarint(unsigned int value, unsigned char *buffer) {
+    size_t length = 0;
+    
+    while (value >= 0x80) {
+        buffer[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[length++] = (unsigned char)value;
+    
+    return length;
+}
+
+// Function to decode a variable-length integer
+const unsigned char *decodeVarint(const unsigned char *position, const unsigned char *end, unsigned int *value) {
+    unsigned int result = 0;
+    int shift = 0;
+    
+    while (position < end && shift < 35) {
+        unsigned char byte = *position++;
+        result |= (unsigned int)(byte & 0x7F) << shift;
+        
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return position;
+        }
+        shift += 7;
+    }
+    
+    return NULL; // Truncated or malformed input
+}
+
 // Function to encrypt a string (basic encryption for demonstration)
 void encryptString(const char *input, char *output, size_t outputSize) {
     size_t inputLen = strlen(input);